@@ -124,6 +124,7 @@ private:
     std::string _number_part;
 
     void _push(Coord value);
+    Coord _parseNumber(char const *begin, char const *end);
     Coord _pop();
     bool _pop_flag();
     Coord _pop_coord(Geom::Dim2 axis);
@@ -32,6 +32,7 @@
  *
  */
 
+#include <charconv>
 #include <cstdio>
 #include <cmath>
 #include <vector>
@@ -44,7 +45,7 @@
 namespace Geom {
 
 
-#line 48 "svg-path-parser.cpp"
+#line 49 "svg-path-parser.cpp"
 static const char _svg_path_actions[] = {
 	0, 1, 0, 1, 1, 1, 2, 1, 
 	3, 1, 4, 1, 5, 1, 15, 2, 
@@ -1083,7 +1084,7 @@ static const int svg_path_first_final = 234;
 static const int svg_path_en_main = 234;
 
 
-#line 47 "svg-path-parser.rl"
+#line 48 "svg-path-parser.rl"
 
 
 SVGPathParser::SVGPathParser(PathSink &sink)
@@ -1109,12 +1110,12 @@ void SVGPathParser::reset() {
     _curve = NULL;
 
     
-#line 1113 "svg-path-parser.cpp"
+#line 1114 "svg-path-parser.cpp"
 	{
 	cs = svg_path_start;
 	}
 
-#line 73 "svg-path-parser.rl"
+#line 74 "svg-path-parser.rl"
 
 }
 
@@ -1155,6 +1156,23 @@ void SVGPathParser::_push(Coord value)
     _params.push_back(value);
 }
 
+/** Convert the characters of a number matched by the grammar, without copying them. */
+Coord SVGPathParser::_parseNumber(char const *begin, char const *end)
+{
+#if __cpp_lib_to_chars >= 201611L
+    // from_chars doesn't accept an explicit plus sign
+    if (begin != end && *begin == '+') {
+        ++begin;
+    }
+    Coord value = 0;
+    if (std::from_chars(begin, end, value).ec == std::errc()) {
+        return value;
+    }
+#endif
+    std::string buf(begin, end);
+    return g_ascii_strtod(buf.c_str(), NULL);
+}
+
 Coord SVGPathParser::_pop()
 {
     Coord value = _params.back();
@@ -1251,7 +1269,7 @@ void SVGPathParser::_parse(char const *str, char const *strend, bool finish)
     char const *start = NULL;
 
     
-#line 1255 "svg-path-parser.cpp"
+#line 1273 "svg-path-parser.cpp"
 	{
 	int _klen;
 	unsigned int _trans;
@@ -1326,17 +1344,16 @@ _match:
 		switch ( *_acts++ )
 		{
 	case 0:
-#line 209 "svg-path-parser.rl"
+#line 227 "svg-path-parser.rl"
 	{
             start = p;
         }
 	break;
 	case 1:
-#line 213 "svg-path-parser.rl"
+#line 231 "svg-path-parser.rl"
 	{
             if (start) {
-                std::string buf(start, p);
-                _push(g_ascii_strtod(buf.c_str(), NULL));
+                _push(_parseNumber(start, p));
                 start = NULL;
             } else {
                 std::string buf(str, p);
@@ -1346,56 +1363,56 @@ _match:
         }
 	break;
 	case 2:
-#line 225 "svg-path-parser.rl"
+#line 242 "svg-path-parser.rl"
 	{
             _push(1.0);
         }
 	break;
 	case 3:
-#line 229 "svg-path-parser.rl"
+#line 246 "svg-path-parser.rl"
 	{
             _push(0.0);
         }
 	break;
 	case 4:
-#line 233 "svg-path-parser.rl"
+#line 250 "svg-path-parser.rl"
 	{
             _absolute = true;
         }
 	break;
 	case 5:
-#line 237 "svg-path-parser.rl"
+#line 254 "svg-path-parser.rl"
 	{
             _absolute = false;
         }
 	break;
 	case 6:
-#line 241 "svg-path-parser.rl"
+#line 258 "svg-path-parser.rl"
 	{
             _moveto_was_absolute = _absolute;
             _moveTo(_pop_point());
         }
 	break;
 	case 7:
-#line 246 "svg-path-parser.rl"
+#line 263 "svg-path-parser.rl"
 	{
             _lineTo(_pop_point());
         }
 	break;
 	case 8:
-#line 250 "svg-path-parser.rl"
+#line 267 "svg-path-parser.rl"
 	{
             _lineTo(Point(_pop_coord(X), _current[Y]));
         }
 	break;
 	case 9:
-#line 254 "svg-path-parser.rl"
+#line 271 "svg-path-parser.rl"
 	{
             _lineTo(Point(_current[X], _pop_coord(Y)));
         }
 	break;
 	case 10:
-#line 258 "svg-path-parser.rl"
+#line 275 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             Point c1 = _pop_point();
@@ -1404,7 +1421,7 @@ _match:
         }
 	break;
 	case 11:
-#line 265 "svg-path-parser.rl"
+#line 282 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             Point c1 = _pop_point();
@@ -1412,7 +1429,7 @@ _match:
         }
 	break;
 	case 12:
-#line 271 "svg-path-parser.rl"
+#line 288 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             Point c = _pop_point();
@@ -1420,14 +1437,14 @@ _match:
         }
 	break;
 	case 13:
-#line 277 "svg-path-parser.rl"
+#line 294 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             _quadTo(_quad_tangent, p);
         }
 	break;
 	case 14:
-#line 282 "svg-path-parser.rl"
+#line 299 "svg-path-parser.rl"
 	{
             Point point = _pop_point();
             bool sweep = _pop_flag();
@@ -1440,12 +1457,12 @@ _match:
         }
 	break;
 	case 15:
-#line 293 "svg-path-parser.rl"
+#line 310 "svg-path-parser.rl"
 	{
             _closePath();
         }
 	break;
-#line 1449 "svg-path-parser.cpp"
+#line 1466 "svg-path-parser.cpp"
 		}
 	}
 
@@ -1462,11 +1479,10 @@ _again:
 	while ( __nacts-- > 0 ) {
 		switch ( *__acts++ ) {
 	case 1:
-#line 213 "svg-path-parser.rl"
+#line 231 "svg-path-parser.rl"
 	{
             if (start) {
-                std::string buf(start, p);
-                _push(g_ascii_strtod(buf.c_str(), NULL));
+                _push(_parseNumber(start, p));
                 start = NULL;
             } else {
                 std::string buf(str, p);
@@ -1476,32 +1492,32 @@ _again:
         }
 	break;
 	case 6:
-#line 241 "svg-path-parser.rl"
+#line 258 "svg-path-parser.rl"
 	{
             _moveto_was_absolute = _absolute;
             _moveTo(_pop_point());
         }
 	break;
 	case 7:
-#line 246 "svg-path-parser.rl"
+#line 263 "svg-path-parser.rl"
 	{
             _lineTo(_pop_point());
         }
 	break;
 	case 8:
-#line 250 "svg-path-parser.rl"
+#line 267 "svg-path-parser.rl"
 	{
             _lineTo(Point(_pop_coord(X), _current[Y]));
         }
 	break;
 	case 9:
-#line 254 "svg-path-parser.rl"
+#line 271 "svg-path-parser.rl"
 	{
             _lineTo(Point(_current[X], _pop_coord(Y)));
         }
 	break;
 	case 10:
-#line 258 "svg-path-parser.rl"
+#line 275 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             Point c1 = _pop_point();
@@ -1510,7 +1526,7 @@ _again:
         }
 	break;
 	case 11:
-#line 265 "svg-path-parser.rl"
+#line 282 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             Point c1 = _pop_point();
@@ -1518,7 +1534,7 @@ _again:
         }
 	break;
 	case 12:
-#line 271 "svg-path-parser.rl"
+#line 288 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             Point c = _pop_point();
@@ -1526,14 +1542,14 @@ _again:
         }
 	break;
 	case 13:
-#line 277 "svg-path-parser.rl"
+#line 294 "svg-path-parser.rl"
 	{
             Point p = _pop_point();
             _quadTo(_quad_tangent, p);
         }
 	break;
 	case 14:
-#line 282 "svg-path-parser.rl"
+#line 299 "svg-path-parser.rl"
 	{
             Point point = _pop_point();
             bool sweep = _pop_flag();
@@ -1546,12 +1562,12 @@ _again:
         }
 	break;
 	case 15:
-#line 293 "svg-path-parser.rl"
+#line 310 "svg-path-parser.rl"
 	{
             _closePath();
         }
 	break;
-#line 1555 "svg-path-parser.cpp"
+#line 1571 "svg-path-parser.cpp"
 		}
 	}
 	}
@@ -1559,7 +1575,7 @@ _again:
 	_out: {}
 	}
 
-#line 435 "svg-path-parser.rl"
+#line 452 "svg-path-parser.rl"
 
 
     if (finish) {
@@ -30,6 +30,7 @@
  *
  */
 
+#include <charconv>
 #include <cstdio>
 #include <cmath>
 #include <vector>
@@ -110,6 +111,23 @@ void SVGPathParser::_push(Coord value)
     _params.push_back(value);
 }
 
+/** Convert the characters of a number matched by the grammar, without copying them. */
+Coord SVGPathParser::_parseNumber(char const *begin, char const *end)
+{
+#if __cpp_lib_to_chars >= 201611L
+    // from_chars doesn't accept an explicit plus sign
+    if (begin != end && *begin == '+') {
+        ++begin;
+    }
+    Coord value = 0;
+    if (std::from_chars(begin, end, value).ec == std::errc()) {
+        return value;
+    }
+#endif
+    std::string buf(begin, end);
+    return g_ascii_strtod(buf.c_str(), NULL);
+}
+
 Coord SVGPathParser::_pop()
 {
     Coord value = _params.back();
@@ -212,8 +230,7 @@ void SVGPathParser::_parse(char const *str, char const *strend, bool finish)
 
         action push_number {
             if (start) {
-                std::string buf(start, p);
-                _push(g_ascii_strtod(buf.c_str(), NULL));
+                _push(_parseNumber(start, p));
                 start = NULL;
             } else {
                 std::string buf(str, p);
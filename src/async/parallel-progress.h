@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** \file Parallel-progress
+ * Split a Progress into sub-tasks that run concurrently.
+ */
+#ifndef INKSCAPE_ASYNC_PARALLEL_PROGRESS_H
+#define INKSCAPE_ASYNC_PARALLEL_PROGRESS_H
+
+#include <mutex>
+#include <vector>
+#include "progress.h"
+
+namespace Inkscape {
+namespace Async {
+
+/**
+ * Split a Progress into a fixed number of equally-weighted sub-tasks that may report from different threads.
+ *
+ * The overall progress is the mean of the progress of the parts. Calls through to the parent are serialised,
+ * so the parent need not be thread-safe itself. The object must outlive all threads using its parts.
+ */
+template <typename T>
+class ParallelProgress
+{
+public:
+    class Part final
+        : public Progress<T>
+    {
+    public:
+        Part(ParallelProgress *owner, int index) : owner(owner), index(index) {}
+
+    private:
+        ParallelProgress *owner;
+        int index;
+
+        bool _keepgoing() const override { return owner->keepgoing(); }
+        bool _report(T const &progress) override { return owner->report(index, progress); }
+    };
+
+    /// Construct a parallel progress splitting \a parent into \a count parts.
+    ParallelProgress(Progress<T> &parent, int count)
+        : parent(&parent)
+        , values(count, T{})
+    {
+        parts.reserve(count);
+        for (int i = 0; i < count; i++) {
+            parts.emplace_back(this, i);
+        }
+    }
+
+    ParallelProgress(ParallelProgress const &) = delete;
+    ParallelProgress &operator=(ParallelProgress const &) = delete;
+
+    /// Return the Progress object for the \a i-th part.
+    Part &operator[](int i) { return parts[i]; }
+
+    int size() const { return parts.size(); }
+
+private:
+    Progress<T> *parent;
+    std::vector<T> values;
+    std::vector<Part> parts;
+    T total{};
+    mutable std::mutex mutables;
+
+    bool keepgoing() const
+    {
+        auto lock = std::lock_guard(mutables);
+        return parent->keepgoing();
+    }
+
+    bool report(int index, T const &progress)
+    {
+        auto lock = std::lock_guard(mutables);
+        total += progress - values[index];
+        values[index] = progress;
+        return parent->report(total / static_cast<T>(values.size()));
+    }
+};
+
+} // namespace Async
+} // namespace Inkscape
+
+#endif // INKSCAPE_ASYNC_PARALLEL_PROGRESS_H
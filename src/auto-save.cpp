@@ -13,6 +13,7 @@
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 
 #include <glibmm/i18n.h> // Internationalization
@@ -22,7 +23,8 @@
 #include "inkscape-application.h"
 #include "preferences.h"
 
-#include "extension/output.h"
+#include "async/async.h"
+#include "async/channel.h"
 #include "io/sys.h"
 #include "xml/repr.h"
 
@@ -71,6 +73,12 @@ AutoSave::save()
         return true;
     }
 
+    if (_pending > 0) {
+        // Previous auto-save still being written, try again next time.
+        return true;
+    }
+    _channels.clear();
+
     Inkscape::Preferences *prefs = Inkscape::Preferences::get();
 
     // Find/create autosave directory
@@ -99,6 +107,7 @@ AutoSave::save()
 
     int docnum = 0;
     int autosave_max = prefs->getInt("/options/autosave/max", 10);
+    bool compress = prefs->getBool("/options/autosave/compress", false);
     for (auto document : documents) {
 
         ++docnum; // Give each document a unique number.
@@ -136,43 +145,67 @@ AutoSave::save()
 
             // Construct save file path
             // datetime MUST happen first, otherwise the above sorting will fail
-            std::string filename = base_name + "-" + datetime.str() + "-" + std::to_string(pid) + "-" + std::to_string(docnum) + ".svg";
+            std::string filename = base_name + "-" + datetime.str() + "-" + std::to_string(pid) + "-" + std::to_string(docnum) + (compress ? ".svgz" : ".svg");
             std::string path = Glib::build_filename(autosave_dir, filename.c_str());
 
-            // Try to save the file
-            // Following code needs to be reviewed
-            FILE *file = Inkscape::IO::fopen_utf8name(path.c_str(), "w");
-            gchar *errortext = nullptr;
-            if (file) {
-                try {
-                    Inkscape::XML::Node *repr = document->getReprRoot();
-                    sp_repr_save_stream(repr->document(), file, SP_SVG_NS_URI);
-                } catch (Inkscape::Extension::Output::no_extension_found &e) {
-                    errortext = g_strdup(_("Autosave failed! Could not find inkscape extension to save document."));
-                } catch (Inkscape::Extension::Output::save_failed &e) {
-                    gchar *safeUri = Inkscape::IO::sanitizeString(path.c_str());
-                    errortext = g_strdup_printf(_("Autosave failed! File %s could not be saved."), safeUri);
-                    g_free(safeUri);
+            // Take a snapshot of the document here and write it out in the background,
+            // so that large documents don't freeze the interface while being saved.
+            document->finishLoading();
+            auto snapshot = std::make_unique<Inkscape::XML::SaveSnapshot>(document->getReprDoc(), SP_SVG_NS_URI);
+            // The document is only marked as auto-saved once the file has been written.
+            auto const serial = document->serial();
+            auto const modifications = document->getModificationCount();
+
+            auto [src, dst] = Async::Channel::create();
+            _channels.emplace_back(std::move(dst));
+            ++_pending;
+
+            Async::fire_and_forget([path, serial, modifications, compress, snapshot = std::move(snapshot), channel = std::move(src)] () mutable {
+                bool success = false;
+                if (FILE *file = Inkscape::IO::fopen_utf8name(path.c_str(), "w")) {
+                    try {
+                        snapshot->save(file, compress);
+                        success = true;
+                    } catch (std::exception const &e) {
+                        g_warning("AutoSave::save: %s", e.what());
+                    }
+                    success = fclose(file) == 0 && success;
                 }
-                fclose(file);
-            } else {
-                gchar *safeUri = Inkscape::IO::sanitizeString(path.c_str());
-                errortext = g_strdup_printf(_("Autosave failed! File %s could not be saved."), safeUri);
-                g_free(safeUri);
-            }
 
-            if (errortext) {
-                g_warning("%s", errortext);
-                g_free(errortext);
-            } else {
-                document->setModifiedSinceAutoSaveFalse();
-            }
+                // The snapshot holds GC-managed nodes; release it on the main thread.
+                channel.run([path, serial, modifications, success, snapshot = std::move(snapshot)] () mutable {
+                    snapshot.reset();
+                    AutoSave::getInstance().saveFinished(path, serial, modifications, success);
+                });
+            });
         }
     } // Loop over documents
 
     return true;
 }
 
+/**
+ * Called on the main thread once a background auto-save has been written.
+ */
+void
+AutoSave::saveFinished(std::string const &path, unsigned long serial, unsigned modifications, bool success)
+{
+    if (success) {
+        // Unless the document was closed or changed again while being written.
+        for (auto document : _app->get_documents()) {
+            if (document->serial() == serial && document->getModificationCount() == modifications) {
+                document->setModifiedSinceAutoSaveFalse();
+            }
+        }
+    } else {
+        gchar *safeUri = Inkscape::IO::sanitizeString(path.c_str());
+        g_warning(_("Autosave failed! File %s could not be saved."), safeUri);
+        g_free(safeUri);
+    }
+
+    --_pending;
+}
+
 void
 AutoSave::restart()
 {
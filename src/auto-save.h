@@ -13,6 +13,11 @@
 #ifndef INKSCAPE_AUTOSAVE_H
 #define INKSCAPE_AUTOSAVE_H
 
+#include <string>
+#include <vector>
+
+#include "async/channel.h"
+
 class InkscapeApplication;
 
 namespace Inkscape {
@@ -39,7 +44,12 @@ public:
     bool save();
 
 private:
+    void saveFinished(std::string const &path, unsigned long serial, unsigned modifications, bool success);
+
     InkscapeApplication* _app = nullptr;
+    // Auto-saves being written in the background
+    int _pending = 0;
+    std::vector<Async::Channel::Dest> _channels;
 };
 
 } // namespace Inkscape
@@ -14,6 +14,7 @@
  * Macros and fn declarations related to linear gradients.
  */
 
+#include <memory>
 #include <vector>
 #include <glibmm/ustring.h>
 #include "cms-color-types.h"
@@ -24,17 +25,42 @@ namespace Inkscape {
 
 class ColorProfile;
 
+/**
+ * An owned lcms2 transform. lcms2 transforms do not change once created, so a transform can be
+ * applied from several threads at once.
+ */
+class CMSTransform {
+public:
+    explicit CMSTransform(cmsHTRANSFORM handle) : _handle(handle) {}
+    ~CMSTransform();
+    CMSTransform(CMSTransform const &) = delete;
+    CMSTransform &operator=(CMSTransform const &) = delete;
+
+    cmsHTRANSFORM handle() const { return _handle; }
+
+    void apply(void *inBuf, void *outBuf, unsigned int size) const;
+
+private:
+    cmsHTRANSFORM _handle;
+};
+
 class CMSSystem {
 public:
     static cmsHPROFILE getHandle( SPDocument* document, unsigned int* intent, char const* name );
 
-    static cmsHTRANSFORM getDisplayTransform();
+    /**
+     * The transform from sRGB to the display profile set in the preferences, or null if there is none.
+     * Only call from the main thread. The result stays valid while it is held, even when the
+     * preferences change in the meantime, so it can be handed to render threads.
+     */
+    static std::shared_ptr<CMSTransform const> getDisplayTransform();
 
     static std::string getDisplayId(int monitor);
 
     static Glib::ustring setDisplayPer( void* buf, unsigned int bufLen, int monitor );
 
-    static cmsHTRANSFORM getDisplayPer(std::string const &id);
+    /// Like getDisplayTransform(), for the profile of a monitor set by setDisplayPer().
+    static std::shared_ptr<CMSTransform const> getDisplayPer(std::string const &id);
 
     static std::vector<Glib::ustring> getDisplayNames();
 
@@ -13,13 +13,16 @@
 
 
 #include <cstring>
+#include <memory>
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "2geom/convex-hull.h"
 #include "2geom/line.h"
 
 #include "conn-avoid-ref.h"
+#include "conn-avoid-rerouter.h"
 #include "desktop.h"
 #include "document-undo.h"
 #include "document.h"
@@ -42,7 +45,28 @@ using Inkscape::DocumentUndo;
 
 using Avoid::Router;
 
-static Avoid::Polygon avoid_item_poly(SPItem const *item);
+namespace {
+
+/// A path making up an obstacle, with the transform that takes it to document coordinates.
+struct ObstacleOutline
+{
+    Geom::PathVector path;
+    Geom::Affine transform;
+
+    bool operator==(ObstacleOutline const &other) const { return transform == other.transform && path == other.path; }
+};
+
+} // namespace
+
+struct SPAvoidRef::PolygonCache
+{
+    std::vector<ObstacleOutline> outlines;
+    double spacing;
+    Avoid::Polygon poly;
+};
+
+static void collect_outlines(SPItem const *item, Geom::Affine const &item_transform, std::vector<ObstacleOutline> &outlines);
+static Avoid::Polygon avoid_item_poly(std::vector<ObstacleOutline> const &outlines, double spacing);
 
 
 SPAvoidRef::SPAvoidRef(SPItem *spitem)
@@ -64,6 +88,9 @@ SPAvoidRef::~SPAvoidRef()
     Router *router = item->document->getRouter();
 
     if (shapeRef && router) {
+        if (auto rerouter = item->document->getConnectorRerouter()) {
+            rerouter->removeObstacle(shapeRef);
+        }
         router->deleteShape(shapeRef);
     }
     shapeRef = nullptr;
@@ -107,7 +134,7 @@ void SPAvoidRef::handleSettingChange()
 
     _transformed_connection.disconnect();
     if (new_setting) {
-        Avoid::Polygon poly = avoid_item_poly(item);
+        Avoid::Polygon const &poly = getObstaclePolygon();
         if (poly.size() > 0) {
             _transformed_connection = item->connectTransformed(
                     sigc::ptr_fun(&avoid_item_move));
@@ -119,12 +146,19 @@ void SPAvoidRef::handleSettingChange()
             GQuark itemID = g_quark_from_string(id);
 
             shapeRef = new Avoid::ShapeRef(router, poly, itemID);
+            if (auto rerouter = item->document->getConnectorRerouter()) {
+                rerouter->setObstacle(shapeRef, poly);
+            }
         }
     }
     else if (shapeRef)
     {
+        if (auto rerouter = item->document->getConnectorRerouter()) {
+            rerouter->removeObstacle(shapeRef);
+        }
         router->deleteShape(shapeRef);
         shapeRef = nullptr;
+        _poly_cache.reset();
     }
 }
 
@@ -185,12 +219,31 @@ Geom::Point SPAvoidRef::getConnectionPointPos()
     return (bbox) ? bbox->midpoint() : Geom::Point(0, 0);
 }
 
-static std::vector<Geom::Point> approxCurveWithPoints(SPCurve const *curve)
+Avoid::Polygon const &SPAvoidRef::getObstaclePolygon()
+{
+    SPDesktop *desktop = SP_ACTIVE_DESKTOP;
+    g_assert(desktop != nullptr);
+    double spacing = desktop->namedview->connector_spacing;
+
+    // Gathering the outlines only copies references to their paths, unlike sampling them.
+    std::vector<ObstacleOutline> outlines;
+    collect_outlines(item, item->i2doc_affine(), outlines);
+
+    if (!_poly_cache || _poly_cache->spacing != spacing || _poly_cache->outlines != outlines) {
+        auto poly = avoid_item_poly(outlines, spacing);
+        _poly_cache = std::make_unique<PolygonCache>(PolygonCache{std::move(outlines), spacing, std::move(poly)});
+    }
+    return _poly_cache->poly;
+}
+
+/**
+ * Sample a path with points, mapped by \a transform. Sampling before transforming gives the same
+ * points, without having to copy the path.
+ */
+static std::vector<Geom::Point> approxCurveWithPoints(Geom::PathVector const &curve_pv, Geom::Affine const &transform = Geom::identity())
 {
     // The number of segments to use for not straight curves approximation
     const unsigned NUM_SEGS = 4;
-    
-    const Geom::PathVector& curve_pv = curve->get_pathvector();
    
     // The structure to hold the output
     std::vector<Geom::Point> poly_points;
@@ -208,14 +261,14 @@ static std::vector<Geom::Point> approxCurveWithPoints(SPCurve const *curve)
         {
             if (cit == pit->begin())
             {
-                poly_points.push_back(cit->initialPoint());
+                poly_points.push_back(cit->initialPoint() * transform);
             }
 
             if (dynamic_cast<Geom::CubicBezier const*>(&*cit))
             {
                 at += seg_size;
                 if (at <= 1.0 )
-                    poly_points.push_back(cit->pointAt(at));
+                    poly_points.push_back(cit->pointAt(at) * transform);
                 else
                 {
                     at = 0.0;
@@ -224,7 +277,7 @@ static std::vector<Geom::Point> approxCurveWithPoints(SPCurve const *curve)
             }
             else
             {
-                poly_points.push_back(cit->finalPoint());
+                poly_points.push_back(cit->finalPoint() * transform);
                 ++cit;
             }
         }
@@ -233,49 +286,37 @@ static std::vector<Geom::Point> approxCurveWithPoints(SPCurve const *curve)
     return poly_points;
 }
 
-static std::vector<Geom::Point> approxItemWithPoints(SPItem const *item, const Geom::Affine& item_transform)
+static void collect_outlines(SPItem const *item, Geom::Affine const &item_transform, std::vector<ObstacleOutline> &outlines)
 {
     auto item_mutable = const_cast<SPItem *>(item);
 
     if (auto group = cast<SPGroup>(item_mutable)) {
-        std::vector<Geom::Point> poly_points;
         // consider all first-order children
         std::vector<SPItem*> itemlist = group->item_list();
         for (auto child_item : itemlist) {
-            std::vector<Geom::Point> child_points = approxItemWithPoints(child_item, item_transform * child_item->transform);
-            poly_points.insert(poly_points.end(), child_points.begin(), child_points.end());
+            collect_outlines(child_item, item_transform * child_item->transform, outlines);
         }
-        return poly_points;
     } else if (auto shape = cast<SPShape>(item_mutable)) {
         shape->set_shape();
         // make sure it has an associated curve
         if (shape->curve()) {
-            auto item_curve = *shape->curve();
             // apply transformations (up to common ancestor)
-            item_curve.transform(item_transform);
-            return approxCurveWithPoints(&item_curve);
-        } else {
-            return {};
+            outlines.push_back({ shape->curve()->get_pathvector(), item_transform });
         }
     } else {
         if (auto bbox = item->documentPreferredBounds()) {
-            auto item_curve = SPCurve(*bbox);
-            return approxCurveWithPoints(&item_curve);
-        } else {
-            return {};
+            outlines.push_back({ Geom::PathVector(Geom::Path(*bbox)), Geom::identity() });
         }
     }
 }
 
-static Avoid::Polygon avoid_item_poly(SPItem const *item)
+static Avoid::Polygon avoid_item_poly(std::vector<ObstacleOutline> const &outlines, double spacing)
 {
-    SPDesktop *desktop = SP_ACTIVE_DESKTOP;
-    g_assert(desktop != nullptr);
-    double spacing = desktop->namedview->connector_spacing;
-
-    Geom::Affine itd_mat = item->i2doc_affine();
     std::vector<Geom::Point> hull_points;
-    hull_points = approxItemWithPoints(item, itd_mat);
+    for (auto const &outline : outlines) {
+        auto const points = approxCurveWithPoints(outline.path, outline.transform);
+        hull_points.insert(hull_points.end(), points.begin(), points.end());
+    }
 
     // create convex hull from all sampled points
     Geom::ConvexHull hull(hull_points);
@@ -363,9 +404,12 @@ void avoid_item_move(Geom::Affine const */*mp*/, SPItem *moved_item)
     g_assert(shapeRef);
 
     Router *router = moved_item->document->getRouter();
-    Avoid::Polygon poly = avoid_item_poly(moved_item);
+    Avoid::Polygon const &poly = moved_item->getAvoidRef().getObstaclePolygon();
     if (!poly.empty()) {
         router->moveShape(shapeRef, poly);
+        if (auto rerouter = moved_item->document->getConnectorRerouter()) {
+            rerouter->setObstacle(shapeRef, poly);
+        }
     }
 }
 
@@ -16,12 +16,13 @@
 
 #include <2geom/point.h>
 #include <cstddef>
+#include <memory>
 #include <sigc++/connection.h>
 
 class  SPDesktop;
 class SPObject;
 class  SPItem;
-namespace Avoid { class ShapeRef; }
+namespace Avoid { class ShapeRef; class Polygon; }
 
 class SPAvoidRef {
 public:
@@ -36,6 +37,10 @@ public:
 
     Geom::Point getConnectionPointPos();
 
+    // The outline of the item as an obstacle for connectors, enlarged by the connector spacing.
+    // Recomputed only when the geometry, transform or spacing has changed since the last call.
+    Avoid::Polygon const &getObstaclePolygon();
+
     // Returns a list of SPItems of all connectors/shapes attached to
     // this object.  Pass one of the following for 'type':
     //     Avoid::runningTo
@@ -53,6 +58,9 @@ private:
 
     // A sigc connection for transformed signal.
     sigc::connection _transformed_connection;
+
+    struct PolygonCache;
+    std::unique_ptr<PolygonCache> _poly_cache;
 };
 
 extern std::vector<SPItem *> get_avoided_items(SPObject *from,
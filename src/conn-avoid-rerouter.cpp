@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Route the connectors of a document in the background.
+ */
+#include "conn-avoid-rerouter.h"
+
+#include <memory>
+
+#include "async/async.h"
+
+#include "3rdparty/adaptagrams/libavoid/connector.h"
+#include "3rdparty/adaptagrams/libavoid/router.h"
+#include "3rdparty/adaptagrams/libavoid/shape.h"
+
+#include "object/sp-conn-end.h"
+#include "object/sp-path.h"
+
+namespace Inkscape {
+
+namespace {
+
+/**
+ * A copy of the routing problem that can be solved on any thread.
+ */
+struct Problem
+{
+    struct Connector
+    {
+        SPPath *path; ///< not to be dereferenced off the main thread
+        Avoid::Point src, dst;
+        bool orthogonal;
+    };
+
+    std::vector<Avoid::Polygon> obstacles;
+    std::vector<Connector> connectors;
+};
+
+/**
+ * A router that gives up once the channel it reports to is closed.
+ */
+class CancellableRouter : public Avoid::Router
+{
+public:
+    CancellableRouter(Async::Channel::Source const &channel)
+        : Avoid::Router(Avoid::PolyLineRouting | Avoid::OrthogonalRouting)
+        , _channel(channel)
+    {
+        // Keep in step with the document's router.
+        setRoutingPenalty(Avoid::segmentPenalty);
+    }
+
+    bool shouldContinueTransactionWithProgress(unsigned int, unsigned int, unsigned int, double) override
+    {
+        return static_cast<bool>(_channel);
+    }
+
+private:
+    Async::Channel::Source const &_channel;
+};
+
+} // namespace
+
+void ConnectorRerouter::setObstacle(Avoid::ShapeRef const *shape, Avoid::Polygon const &poly)
+{
+    _obstacles[shape] = poly;
+    invalidate();
+}
+
+void ConnectorRerouter::removeObstacle(Avoid::ShapeRef const *shape)
+{
+    _obstacles.erase(shape);
+    invalidate();
+}
+
+void ConnectorRerouter::addConnector(SPPath *path)
+{
+    _connectors.insert(path);
+    invalidate();
+}
+
+void ConnectorRerouter::removeConnector(SPPath *path)
+{
+    // Also makes sure that routes in progress never reach a deleted path.
+    _connectors.erase(path);
+    invalidate();
+}
+
+void ConnectorRerouter::invalidate()
+{
+    _dirty = true;
+    _channel.close();
+}
+
+void ConnectorRerouter::routed()
+{
+    _dirty = false;
+    _channel.close();
+}
+
+bool ConnectorRerouter::start()
+{
+    if (!_dirty) {
+        return false;
+    }
+    routed();
+
+    if (_connectors.empty()) {
+        return true;
+    }
+
+    auto problem = Problem();
+    problem.obstacles.reserve(_obstacles.size());
+    for (auto const &[shape, poly] : _obstacles) {
+        problem.obstacles.push_back(poly);
+    }
+    for (auto path : _connectors) {
+        auto &pair = path->connEndPair;
+        if (!pair.isAutoRoutingConn()) {
+            continue;
+        }
+        Geom::Point ends[2];
+        pair.getEndpoints(ends);
+        problem.connectors.push_back({ path,
+                                       Avoid::Point(ends[0][Geom::X], ends[0][Geom::Y]),
+                                       Avoid::Point(ends[1][Geom::X], ends[1][Geom::Y]),
+                                       pair.isOrthogonal() });
+    }
+
+    auto [src, dst] = Async::Channel::create();
+    _channel = std::move(dst);
+
+    Async::fire_and_forget([this, problem = std::move(problem), channel = std::move(src)] () mutable {
+        auto router = std::make_unique<CancellableRouter>(channel);
+
+        for (auto &poly : problem.obstacles) {
+            // The router takes ownership.
+            new Avoid::ShapeRef(router.get(), poly);
+        }
+
+        std::vector<Avoid::ConnRef *> conns;
+        conns.reserve(problem.connectors.size());
+        for (auto const &connector : problem.connectors) {
+            auto conn = new Avoid::ConnRef(router.get());
+            conn->setRoutingType(connector.orthogonal ? Avoid::ConnType_Orthogonal : Avoid::ConnType_PolyLine);
+            conn->setEndpoints(connector.src, connector.dst);
+            conns.push_back(conn);
+        }
+
+        router->processTransaction();
+        if (!channel) {
+            return;
+        }
+
+        std::vector<Route> routes;
+        routes.reserve(conns.size());
+        for (std::size_t i = 0; i < conns.size(); i++) {
+            routes.push_back({ problem.connectors[i].path, conns[i]->displayRoute() });
+        }
+
+        channel.run([this, routes = std::move(routes)] {
+            _apply(routes);
+        });
+    });
+
+    return true;
+}
+
+void ConnectorRerouter::_apply(std::vector<Route> const &routes)
+{
+    for (auto const &route : routes) {
+        if (_connectors.count(route.path) && !route.polyline.empty()) {
+            sp_conn_redraw_path(route.path, &route.polyline);
+        }
+    }
+}
+
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Route the connectors of a document in the background.
+ *
+ * The document's Avoid::Router stays in charge: it is still told about every change, and still
+ * routes everything itself whenever the document is brought fully up to date. In between, a copy
+ * of the routing problem is solved on another thread and the routes are drawn as they arrive, so
+ * that dragging obstacles around does not block the user interface. Any change to the problem
+ * cancels the routing in progress.
+ */
+#ifndef INKSCAPE_CONN_AVOID_REROUTER_H
+#define INKSCAPE_CONN_AVOID_REROUTER_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "async/channel.h"
+#include "3rdparty/adaptagrams/libavoid/geomtypes.h"
+
+class SPPath;
+
+namespace Avoid {
+class ShapeRef;
+} // namespace Avoid
+
+namespace Inkscape {
+
+class ConnectorRerouter
+{
+public:
+    ConnectorRerouter() = default;
+    ConnectorRerouter(ConnectorRerouter const &) = delete;
+    ConnectorRerouter &operator=(ConnectorRerouter const &) = delete;
+
+    /// Record the outline last given to the router for \a shape.
+    void setObstacle(Avoid::ShapeRef const *shape, Avoid::Polygon const &poly);
+    void removeObstacle(Avoid::ShapeRef const *shape);
+
+    /// Start or stop routing \a path, which must have its endpoints set.
+    void addConnector(SPPath *path);
+    void removeConnector(SPPath *path);
+
+    /// Note that the routes are out of date. Cancels the routing in progress.
+    void invalidate();
+
+    /// Note that the document's router has just routed everything itself.
+    void routed();
+
+    /**
+     * Start routing in the background if the routes are out of date.
+     * Returns false if there is nothing to do.
+     */
+    bool start();
+
+private:
+    struct Route
+    {
+        SPPath *path;
+        Avoid::PolyLine polyline;
+    };
+
+    std::unordered_map<Avoid::ShapeRef const *, Avoid::Polygon> _obstacles;
+    std::unordered_set<SPPath *> _connectors;
+    bool _dirty = false;
+    Async::Channel::Dest _channel; ///< closing it drops the routes in progress
+
+    void _apply(std::vector<Route> const &routes);
+};
+
+} // namespace Inkscape
+
+#endif // INKSCAPE_CONN_AVOID_REROUTER_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
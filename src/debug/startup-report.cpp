@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Inkscape::Debug::startup_phase - time the phases of starting up
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+#include <glib.h>
+#include "debug/startup-report.h"
+
+namespace Inkscape {
+
+namespace Debug {
+
+namespace {
+
+// Taken while the program is being loaded, so as close to its start as we can get.
+gint64 const process_start = g_get_monotonic_time();
+
+bool enabled()
+{
+    static bool const enabled = g_getenv("INKSCAPE_STARTUP_REPORT") != nullptr;
+    return enabled;
+}
+
+struct Phases
+{
+    std::vector<std::pair<char const *, gint64>> ends;
+    bool reported = false;
+};
+
+Phases &phases()
+{
+    static Phases phases;
+    return phases;
+}
+
+}
+
+void startup_phase(char const *name)
+{
+    if (enabled() && !phases().reported) {
+        phases().ends.emplace_back(name, g_get_monotonic_time());
+    }
+}
+
+void startup_report()
+{
+    if (!enabled() || phases().reported) {
+        return;
+    }
+    phases().reported = true;
+
+    std::fprintf(stderr, "Startup phases (ms):\n");
+    gint64 previous = process_start;
+    for (auto const &[name, end] : phases().ends) {
+        std::fprintf(stderr, "  %-24s %9.1f\n", name, (end - previous) / 1000.0);
+        previous = end;
+    }
+    std::fprintf(stderr, "  %-24s %9.1f\n", "total", (previous - process_start) / 1000.0);
+}
+
+}
+
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Inkscape::Debug::startup_phase - time the phases of starting up
+ *
+ * Set INKSCAPE_STARTUP_REPORT in the environment to have the time taken by each phase printed
+ * once Inkscape is ready.
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#ifndef SEEN_INKSCAPE_DEBUG_STARTUP_REPORT_H
+#define SEEN_INKSCAPE_DEBUG_STARTUP_REPORT_H
+
+namespace Inkscape {
+
+namespace Debug {
+
+/// Note that the phase \a name, which began where the previous one ended, is over.
+void startup_phase(char const *name);
+
+/// Print the phases noted so far, if asked for. Later calls do nothing.
+void startup_report();
+
+}
+
+}
+
+#endif
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
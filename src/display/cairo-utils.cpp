@@ -19,7 +19,9 @@
 #include <2geom/point.h>
 #include <2geom/sbasis-to-bezier.h>
 #include <2geom/transforms.h>
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <boost/algorithm/string.hpp>
 #include <boost/operators.hpp>
 #include <boost/optional/optional.hpp>
@@ -172,13 +174,15 @@ Pixbuf *Pixbuf::cropTo(const Geom::IntRect &area) const
     return new Pixbuf(cropped);
 }
 
-Pixbuf *Pixbuf::create_from_data_uri(gchar const *uri_data, double svgdpi)
+/**
+ * Skip the media type and parameters of a data URI (without the "data:" prefix),
+ * returning a pointer to its data.
+ */
+static gchar const *parse_data_uri(gchar const *uri_data, bool &data_is_image, bool &data_is_svg, bool &data_is_base64)
 {
-    Pixbuf *pixbuf = nullptr;
-
-    bool data_is_image = false;
-    bool data_is_svg = false;
-    bool data_is_base64 = false;
+    data_is_image = false;
+    data_is_svg = false;
+    data_is_base64 = false;
 
     gchar const *data = uri_data;
 
@@ -233,6 +237,16 @@ Pixbuf *Pixbuf::create_from_data_uri(gchar const *uri_data, double svgdpi)
         }
     }
 
+    return data;
+}
+
+Pixbuf *Pixbuf::create_from_data_uri(gchar const *uri_data, double svgdpi)
+{
+    Pixbuf *pixbuf = nullptr;
+
+    bool data_is_image, data_is_svg, data_is_base64;
+    gchar const *data = parse_data_uri(uri_data, data_is_image, data_is_svg, data_is_base64);
+
     if ((*data) && data_is_image && !data_is_svg && data_is_base64) {
         GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
 
@@ -353,6 +367,161 @@ Pixbuf *Pixbuf::create_from_file(std::string const &fn, double svgdpi)
     return pb;
 }
 
+namespace {
+
+// Headers can be preceded by metadata, so give up only after a generous amount of data.
+constexpr gsize PROBE_LIMIT = 1024 * 1024;
+
+/// The size of a PNG image, read from the IHDR chunk that follows the signature.
+std::optional<Geom::IntPoint> png_size(guchar const *data, gsize len)
+{
+    static guchar const header[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R' };
+    if (len < sizeof(header) + 8 || std::memcmp(data, header, sizeof(header)) != 0) {
+        return {};
+    }
+    auto const read_u32 = [] (guchar const *p) {
+        return guint32(p[0]) << 24 | guint32(p[1]) << 16 | guint32(p[2]) << 8 | guint32(p[3]);
+    };
+    auto const width = read_u32(data + sizeof(header));
+    auto const height = read_u32(data + sizeof(header) + 4);
+    if (width == 0 || height == 0 || width > G_MAXINT || height > G_MAXINT) {
+        return {};
+    }
+    return Geom::IntPoint(width, height);
+}
+
+/**
+ * Reads the size of an image from its header, through a pixbuf loader for formats other than PNG.
+ * The size is reported as the image is shown, i.e. after Pixbuf::apply_embedded_orientation().
+ */
+class SizeProbe
+{
+public:
+    SizeProbe()
+        : _loader(gdk_pixbuf_loader_new())
+    {
+        g_signal_connect(_loader, "size-prepared", G_CALLBACK(+[] (GdkPixbufLoader *loader, int width, int height, gpointer data) {
+            static_cast<SizeProbe *>(data)->_size = Geom::IntPoint(width, height);
+            // Only the header is of interest; loaders that can decode at a reduced size allocate less.
+            gdk_pixbuf_loader_set_size(loader, std::max(width / 8, 1), std::max(height / 8, 1));
+        }), this);
+        // The orientation is known once the loader has set up its pixbuf.
+        g_signal_connect(_loader, "area-prepared", G_CALLBACK(+[] (GdkPixbufLoader *loader, gpointer data) {
+            auto self = static_cast<SizeProbe *>(data);
+            self->_prepared = true;
+            if (auto pb = gdk_pixbuf_loader_get_pixbuf(loader)) {
+                if (auto str = gdk_pixbuf_get_option(pb, "orientation")) {
+                    self->_orientation = g_ascii_strtoll(str, nullptr, 10);
+                }
+            }
+        }), this);
+    }
+
+    ~SizeProbe()
+    {
+        // Closing fails for truncated data, which is expected here.
+        gdk_pixbuf_loader_close(_loader, nullptr);
+        g_object_unref(_loader);
+    }
+
+    SizeProbe(SizeProbe const &) = delete;
+    SizeProbe &operator=(SizeProbe const &) = delete;
+
+    bool done() const { return _prepared; }
+
+    bool write(guchar const *data, gsize len)
+    {
+        // The PNG loader cannot decode at a reduced size and would allocate the whole image,
+        // but PNG has no embedded orientation and keeps its size at a fixed place.
+        if (!_started) {
+            _started = true;
+            if ((_size = png_size(data, len))) {
+                _prepared = true;
+                return true;
+            }
+        }
+        return gdk_pixbuf_loader_write(_loader, data, len, nullptr);
+    }
+
+    std::optional<Geom::IntPoint> size() const
+    {
+        if (!_prepared || !_size || _size->x() <= 0 || _size->y() <= 0) {
+            return {};
+        }
+        // Orientations 5 to 8 turn the image by a quarter (see get_embedded_orientation).
+        if (_orientation >= 5 && _orientation <= 8) {
+            return Geom::IntPoint(_size->y(), _size->x());
+        }
+        return _size;
+    }
+
+private:
+    GdkPixbufLoader *_loader;
+    std::optional<Geom::IntPoint> _size;
+    bool _started = false;
+    bool _prepared = false;
+    int _orientation = 0;
+};
+
+} // namespace
+
+std::optional<Geom::IntPoint> Pixbuf::probe_data_uri(gchar const *uri_data)
+{
+    bool data_is_image, data_is_svg, data_is_base64;
+    gchar const *data = parse_data_uri(uri_data, data_is_image, data_is_svg, data_is_base64);
+
+    if (!(*data) || !data_is_image || data_is_svg || !data_is_base64) {
+        return {};
+    }
+
+    // Decode and feed small chunks until the loader has seen the header.
+    SizeProbe probe;
+    constexpr gsize chunk = 4096; // base64 characters
+    guchar decoded[chunk / 4 * 3 + 3];
+    gint state = 0;
+    guint save = 0;
+    for (gsize pos = 0; !probe.done() && pos < PROBE_LIMIT; ) {
+        gsize len = strnlen(data + pos, chunk);
+        if (len == 0) {
+            break;
+        }
+        gsize decoded_len = g_base64_decode_step(data + pos, len, decoded, &state, &save);
+        pos += len;
+        if (!probe.write(decoded, decoded_len)) {
+            break;
+        }
+    }
+
+    return probe.size();
+}
+
+std::optional<Geom::IntPoint> Pixbuf::probe_file(std::string const &fn)
+{
+    // SVG files are rendered by create_from_buffer() rather than by gdk-pixbuf.
+    auto idx = fn.rfind('.');
+    if (idx != std::string::npos && boost::iequals(fn.substr(idx + 1), "svg")) {
+        return {};
+    }
+
+    FILE *file = g_fopen(fn.c_str(), "rb");
+    if (!file) {
+        return {};
+    }
+
+    SizeProbe probe;
+    guchar buffer[65536];
+    for (gsize pos = 0; !probe.done() && pos < PROBE_LIMIT; ) {
+        gsize len = fread(buffer, 1, sizeof(buffer), file);
+        if (len == 0 || !probe.write(buffer, len)) {
+            break;
+        }
+        pos += len;
+    }
+    fclose(file);
+
+    return probe.size();
+}
+
 GdkPixbuf *Pixbuf::apply_embedded_orientation(GdkPixbuf *buf)
 {
     GdkPixbuf *old = buf;
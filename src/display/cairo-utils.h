@@ -13,7 +13,9 @@
 #ifndef SEEN_INKSCAPE_DISPLAY_CAIRO_UTILS_H
 #define SEEN_INKSCAPE_DISPLAY_CAIRO_UTILS_H
 
+#include <optional>
 #include <2geom/forward.h>
+#include <2geom/int-point.h>
 #include <cairomm/cairomm.h>
 #include "style.h"
 
@@ -69,6 +71,11 @@ public:
     static Pixbuf *create_from_file(std::string const &fn, double svgddpi = 0);
     static Pixbuf *create_from_buffer(std::string const &, double svgddpi = 0, std::string const &fn = "");
 
+    /** Read the size of a raster image from the header of a data URI or a file, without decoding
+     * the image. Returns nothing for SVG images and for anything else that cannot be read this way. */
+    static std::optional<Geom::IntPoint> probe_data_uri(gchar const *uri);
+    static std::optional<Geom::IntPoint> probe_file(std::string const &fn);
+
   private:
     static Pixbuf *create_from_buffer(gchar *&&, gsize, double svgddpi = 0, std::string const &fn = "");
     static Geom::Affine get_embedded_orientation(GdkPixbuf *buf);
@@ -14,7 +14,11 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <2geom/transforms.h>
+#include <boost/functional/hash.hpp>
 
 #include "canvas-item-ctrl.h"
 #include "helper/geom.h"
@@ -26,6 +30,54 @@
 
 namespace Inkscape {
 
+namespace {
+
+/**
+ * Bitmaps of ctrls by appearance. Editing a large path shows a great many nodes and handles
+ * that look alike, and each of them used to build a bitmap of its own.
+ */
+class SharedCtrlBitmaps
+{
+public:
+    using Key = std::tuple<int, int, int, int, uint32_t, uint32_t, double, int>;
+
+    std::shared_ptr<uint32_t[]> get(Key const &key)
+    {
+        auto lock = std::lock_guard(_mutex);
+        auto it = _map.find(key);
+        return it != _map.end() ? it->second : nullptr;
+    }
+
+    void put(Key const &key, std::shared_ptr<uint32_t[]> bitmap)
+    {
+        auto lock = std::lock_guard(_mutex);
+        // Rotating the canvas gives arrows new angles; start over rather than grow without limit.
+        if (_map.size() >= MAX_ENTRIES) {
+            _map.clear();
+        }
+        _map.emplace(key, std::move(bitmap));
+    }
+
+private:
+    static constexpr std::size_t MAX_ENTRIES = 256;
+
+    struct KeyHash
+    {
+        std::size_t operator()(Key const &key) const { return boost::hash_value(key); }
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<Key, std::shared_ptr<uint32_t[]>, KeyHash> _map;
+};
+
+SharedCtrlBitmaps &shared_ctrl_bitmaps()
+{
+    static SharedCtrlBitmaps instance;
+    return instance;
+}
+
+} // namespace
+
 /**
  * Create a null control node.
  */
@@ -267,7 +319,16 @@ static inline uint32_t compose_xor(uint32_t bg, uint32_t fg, uint32_t a)
 void CanvasItemCtrl::_render(CanvasItemBuffer &buf) const
 {
     _built.init([&, this] {
-        build_cache(buf.device_scale);
+        if (_pixbuf || _shape == CANVAS_ITEM_CTRL_SHAPE_BITMAP || _shape == CANVAS_ITEM_CTRL_SHAPE_IMAGE) {
+            build_cache(buf.device_scale);
+            return;
+        }
+        auto const key = SharedCtrlBitmaps::Key(_shape, _mode, _width, _height, _fill, _stroke, _angle, buf.device_scale);
+        _cache = shared_ctrl_bitmaps().get(key);
+        if (!_cache) {
+            build_cache(buf.device_scale);
+            shared_ctrl_bitmaps().put(key, _cache);
+        }
     });
 
     Geom::Point c = _bounds->min() - buf.rect.min();
@@ -75,7 +75,7 @@ protected:
 
     // Display
     InitLock _built;
-    mutable std::unique_ptr<uint32_t[]> _cache;
+    mutable std::shared_ptr<uint32_t[]> _cache; // Shared between ctrls that look the same.
 
     // Properties
     CanvasItemCtrlType  _type  = CANVAS_ITEM_CTRL_TYPE_DEFAULT;
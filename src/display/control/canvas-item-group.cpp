@@ -13,13 +13,23 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
 #include <boost/range/adaptor/reversed.hpp>
 #include "canvas-item-group.h"
+#include "grid-index.h"
 
 constexpr bool DEBUG_LOGGING = false;
 
 namespace Inkscape {
 
+// Groups with fewer children than this are not worth indexing.
+constexpr std::size_t INDEX_THRESHOLD = 512;
+
+struct CanvasItemGroup::Index : GridIndex<CanvasItem> {};
+
 CanvasItemGroup::CanvasItemGroup(CanvasItemGroup *group)
     : CanvasItem(group)
 {
@@ -40,6 +50,20 @@ CanvasItemGroup::~CanvasItemGroup()
 }
 
 void CanvasItemGroup::_update(bool propagate)
+{
+    // Children may ask for another update while being updated.
+    auto dirty = std::move(_dirty);
+    _dirty.clear();
+    bool const all_dirty = std::exchange(_all_dirty, false);
+
+    if (propagate || all_dirty || !_index) {
+        _update_all(propagate);
+    } else {
+        _update_dirty(dirty);
+    }
+}
+
+void CanvasItemGroup::_update_all(bool propagate)
 {
     _bounds = {};
 
@@ -48,6 +72,96 @@ void CanvasItemGroup::_update(bool propagate)
         item.update(propagate);
         _bounds |= item.get_bounds();
     }
+
+    if (items.size() < INDEX_THRESHOLD) {
+        _index.reset();
+    } else if (!_index) {
+        _rebuild_index();
+    } else {
+        for (auto &item : items) {
+            _index->move(&item, item.get_bounds());
+        }
+    }
+}
+
+/**
+ * Update only the children that asked for it, moving them in the index. The bounds of the group
+ * are only recomputed from all children if one of them may have been on its edge.
+ */
+void CanvasItemGroup::_update_dirty(std::vector<CanvasItem *> const &dirty)
+{
+    bool recompute_bounds = false;
+
+    for (auto item : dirty) {
+        item->update(false);
+        auto const &new_bounds = item->get_bounds();
+        auto const old_bounds = _index->move(item, new_bounds);
+        if (old_bounds == new_bounds) {
+            continue;
+        }
+
+        if (old_bounds && !(_bounds && _bounds->interiorContains(*old_bounds))) {
+            recompute_bounds = true;
+        }
+        _bounds |= new_bounds;
+    }
+
+    if (recompute_bounds) {
+        _bounds = {};
+        for (auto &item : items) {
+            _bounds |= item.get_bounds();
+        }
+    }
+}
+
+/// Index all children afresh, with the bounds they have now.
+void CanvasItemGroup::_rebuild_index()
+{
+    _index = std::make_unique<Index>();
+    int z = 0;
+    for (auto &item : items) {
+        _index->place(&item, z++, item.get_bounds());
+    }
+}
+
+/**
+ * Called once \a item has been inserted among the children. It is updated with the next update
+ * of the group.
+ */
+void CanvasItemGroup::_child_added(CanvasItem *item)
+{
+    if (!_index) {
+        return;
+    }
+
+    auto const it = items.iterator_to(*item);
+    auto const prev = it == items.begin() ? nullptr : &*std::prev(it);
+    auto const next = std::next(it) == items.end() ? nullptr : &*std::next(it);
+    if (!_index->add(item, item->get_bounds(), prev, next)) {
+        _rebuild_index();
+    }
+
+    if (!_all_dirty) {
+        _dirty.push_back(item);
+    }
+    request_update();
+}
+
+/// Called before \a item is taken out of the children.
+void CanvasItemGroup::_child_removed(CanvasItem *item)
+{
+    _dirty.erase(std::remove(_dirty.begin(), _dirty.end(), item), _dirty.end());
+    if (_index) {
+        _index->erase(item);
+    }
+}
+
+void CanvasItemGroup::_child_needs_update(CanvasItem *item)
+{
+    if (!_all_dirty) {
+        _dirty.push_back(item);
+    }
+    request_update();
 }
 
 void CanvasItemGroup::_mark_net_invisible()
@@ -61,6 +175,8 @@ void CanvasItemGroup::_mark_net_invisible()
         item._mark_net_invisible();
     }
     _bounds = {};
+    _index.reset();
+    _all_dirty = true; // Children are not marked when they reappear with the group.
 }
 
 void CanvasItemGroup::visit_page_rects(std::function<void(Geom::Rect const &)> const &f) const
@@ -73,6 +189,13 @@ void CanvasItemGroup::visit_page_rects(std::function<void(Geom::Rect const &)> c
 
 void CanvasItemGroup::_render(Inkscape::CanvasItemBuffer &buf) const
 {
+    if (_index) {
+        for (auto const &entry : _index->query(buf.rect)) {
+            entry.item->render(buf);
+        }
+        return;
+    }
+
     for (auto &item : items) {
         item.render(buf);
     }
@@ -87,18 +210,32 @@ CanvasItem *CanvasItemGroup::pick_item(Geom::Point const &p)
         std::cout << "  PICKING: In group: " << _name << "  bounds: " << _bounds << std::endl;
     }
 
-    for (auto &item : boost::adaptors::reverse(items)) {
+    auto check = [&] (CanvasItem &item) -> CanvasItem * {
         if constexpr (DEBUG_LOGGING) std::cout << "    PICKING: Checking: " << item.get_name() << "  bounds: " << item.get_bounds() << std::endl;
 
         if (item.is_visible() && item.is_pickable() && item.contains(p)) {
             if (auto group = dynamic_cast<CanvasItemGroup*>(&item)) {
-                if (auto ret = group->pick_item(p)) {
-                    return ret;
-                }
-            } else {
-                return &item;
+                return group->pick_item(p);
+            }
+            return &item;
+        }
+        return nullptr;
+    };
+
+    if (_index) {
+        auto const candidates = _index->query(Geom::Rect(p, p));
+        for (auto const &entry : boost::adaptors::reverse(candidates)) {
+            if (auto ret = check(*entry.item)) {
+                return ret;
             }
         }
+        return nullptr;
+    }
+
+    for (auto &item : boost::adaptors::reverse(items)) {
+        if (auto ret = check(item)) {
+            return ret;
+        }
     }
 
     return nullptr;
@@ -16,6 +16,9 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <memory>
+#include <vector>
+
 #include "canvas-item.h"
 
 namespace Inkscape {
@@ -52,6 +55,24 @@ protected:
                                       &Inkscape::CanvasItem::member_hook>>;
 
     CanvasItemList items;
+
+    /**
+     * Grid of the children by their bounds, for groups with many children such as the nodes of a
+     * large path. Updates, additions and removals of children are entered as they happen; without
+     * it, rendering and picking visit every child.
+     */
+    struct Index;
+    std::unique_ptr<Index> _index;
+    void _rebuild_index();
+    void _child_added(CanvasItem *item);
+    void _child_removed(CanvasItem *item);
+
+    // Children that requested an update since the last one. Only looked at while the index exists.
+    std::vector<CanvasItem *> _dirty;
+    bool _all_dirty = true;
+    void _child_needs_update(CanvasItem *item);
+    void _update_all(bool propagate);
+    void _update_dirty(std::vector<CanvasItem *> const &dirty);
 };
 
 } // namespace Inkscape
@@ -40,6 +40,7 @@ CanvasItem::CanvasItem(CanvasItemGroup *parent)
     if constexpr (DEBUG_LOGGING) std::cout << "CanvasItem: add " << get_name() << " to " << parent->get_name() << " " << parent->items.size() << std::endl;
     defer([=] {
         parent->items.push_back(*this);
+        parent->_child_added(this);
         request_update();
     });
 }
@@ -55,6 +56,7 @@ void CanvasItem::unlink()
             if constexpr (DEBUG_LOGGING) std::cout << "CanvasItem: remove " << get_name() << " from " << _parent->get_name() << " " << _parent->items.size() << std::endl;
             auto it = _parent->items.iterator_to(*this);
             assert(it != _parent->items.end());
+            _parent->_child_removed(this);
             _parent->items.erase(it);
             _parent->request_update();
         } else {
@@ -91,6 +93,7 @@ void CanvasItem::set_z_position(int zpos)
     }
 
     defer([=] {
+        _parent->_child_removed(this);
         _parent->items.erase(_parent->items.iterator_to(*this));
 
         if (zpos <= 0) {
@@ -102,6 +105,8 @@ void CanvasItem::set_z_position(int zpos)
             std::advance(it, zpos);
             _parent->items.insert(it, *this);
         }
+        _parent->_child_added(this);
+        _parent->request_update();
     });
 }
 
@@ -113,8 +118,11 @@ void CanvasItem::raise_to_top()
     }
 
     defer([=] {
+        _parent->_child_removed(this);
         _parent->items.erase(_parent->items.iterator_to(*this));
         _parent->items.push_back(*this);
+        _parent->_child_added(this);
+        _parent->request_update();
     });
 }
 
@@ -126,8 +134,11 @@ void CanvasItem::lower_to_bottom()
     }
 
     defer([=] {
+        _parent->_child_removed(this);
         _parent->items.erase(_parent->items.iterator_to(*this));
         _parent->items.push_front(*this);
+        _parent->_child_added(this);
+        _parent->request_update();
     });
 }
 
@@ -141,7 +152,7 @@ void CanvasItem::request_update()
     _need_update = true;
 
     if (_parent) {
-        _parent->request_update();
+        _parent->_child_needs_update(this);
     } else {
         get_canvas()->request_update();
     }
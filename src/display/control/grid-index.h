@@ -0,0 +1,218 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#ifndef SEEN_DISPLAY_CONTROL_GRID_INDEX_H
+#define SEEN_DISPLAY_CONTROL_GRID_INDEX_H
+
+/**
+ * A grid of items by their bounds, keeping their order, for finding the items near a point or
+ * in an area among many.
+ */
+/*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <2geom/int-rect.h>
+#include <2geom/rect.h>
+
+namespace Inkscape {
+
+template <typename T>
+class GridIndex
+{
+public:
+    static constexpr double CELL_SIZE = 64; // In canvas units.
+    static constexpr std::int64_t MAX_CELLS = 16; // Items covering more cells than this are kept in a list of their own.
+
+    struct Entry
+    {
+        double z; // Orders the items; gaps leave room for items added later.
+        T *item;
+    };
+
+    /// Enter \a item with order \a z and \a bounds, which may be empty.
+    void place(T *item, double z, Geom::OptRect const &bounds)
+    {
+        _placed[item] = { z, bounds };
+        if (bounds) {
+            _insert({ z, item }, *bounds);
+        }
+    }
+
+    /**
+     * Enter \a item ordered between \a prev and \a next, either of which may be null. False if
+     * there is no room left between them, in which case nothing is changed.
+     */
+    bool add(T *item, Geom::OptRect const &bounds, T const *prev, T const *next)
+    {
+        double z = 0;
+        if (prev && next) {
+            auto const lo = _placed.at(prev).z;
+            auto const hi = _placed.at(next).z;
+            z = lo + (hi - lo) / 2;
+            if (!(lo < z && z < hi)) {
+                return false;
+            }
+        } else if (prev) {
+            z = _placed.at(prev).z + 1;
+        } else if (next) {
+            z = _placed.at(next).z - 1;
+        }
+        place(item, z, bounds);
+        return true;
+    }
+
+    void erase(T const *item)
+    {
+        auto it = _placed.find(item);
+        if (it == _placed.end()) {
+            return;
+        }
+        if (it->second.bounds) {
+            _remove(item, *it->second.bounds);
+        }
+        _placed.erase(it);
+    }
+
+    /// Move \a item to its new bounds. Returns its bounds before.
+    Geom::OptRect move(T *item, Geom::OptRect const &to)
+    {
+        auto &placement = _placed.at(item);
+        auto from = placement.bounds;
+        if (from == to) {
+            return from;
+        }
+        if (from) {
+            _remove(item, *from);
+        }
+        if (to) {
+            _insert({ placement.z, item }, *to);
+        }
+        placement.bounds = to;
+        return from;
+    }
+
+    bool contains(T const *item) const { return _placed.count(item); }
+
+    /// The items that may intersect \a rect, in order.
+    std::vector<Entry> query(Geom::Rect const &rect) const
+    {
+        auto result = _large;
+        auto const range = _cell_range(rect);
+        if (!range || _cell_count(*range) > static_cast<std::int64_t>(_cells.size())) {
+            // Cheaper to look at every cell there is.
+            for (auto const &[key, entries] : _cells) {
+                if (!range || range->contains(Geom::IntPoint(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key)))) {
+                    result.insert(result.end(), entries.begin(), entries.end());
+                }
+            }
+        } else {
+            for (int y = range->top(); y <= range->bottom(); y++) {
+                for (int x = range->left(); x <= range->right(); x++) {
+                    if (auto it = _cells.find(_key(x, y)); it != _cells.end()) {
+                        result.insert(result.end(), it->second.begin(), it->second.end());
+                    }
+                }
+            }
+        }
+        std::sort(result.begin(), result.end(), [] (Entry const &a, Entry const &b) { return a.z < b.z; });
+        result.erase(std::unique(result.begin(), result.end(), [] (Entry const &a, Entry const &b) { return a.item == b.item; }),
+                     result.end());
+        return result;
+    }
+
+private:
+    struct Placement
+    {
+        double z;
+        Geom::OptRect bounds; // As entered into the grid.
+    };
+
+    std::unordered_map<std::uint64_t, std::vector<Entry>> _cells;
+    std::vector<Entry> _large; // Items with bounds too large, or infinite, for the grid.
+    std::unordered_map<T const *, Placement> _placed; // Every item.
+
+    static std::uint64_t _key(int x, int y)
+    {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+    }
+
+    /// The cells touched by \a rect, or nothing if they cannot be numbered, as for infinite bounds.
+    static std::optional<Geom::IntRect> _cell_range(Geom::Rect const &rect)
+    {
+        // Leave a margin so that the far corner of a range still fits.
+        constexpr double limit = 1 << 30;
+        double const x0 = std::floor(rect.left()   / CELL_SIZE);
+        double const y0 = std::floor(rect.top()    / CELL_SIZE);
+        double const x1 = std::floor(rect.right()  / CELL_SIZE);
+        double const y1 = std::floor(rect.bottom() / CELL_SIZE);
+        // Also false for NaN.
+        if (!(x0 >= -limit && y0 >= -limit && x1 <= limit && y1 <= limit)) {
+            return {};
+        }
+        return Geom::IntRect(static_cast<int>(x0), static_cast<int>(y0), static_cast<int>(x1), static_cast<int>(y1));
+    }
+
+    static std::int64_t _cell_count(Geom::IntRect const &range)
+    {
+        return (static_cast<std::int64_t>(range.width()) + 1) * (static_cast<std::int64_t>(range.height()) + 1);
+    }
+
+    void _insert(Entry entry, Geom::Rect const &bounds)
+    {
+        auto const range = _cell_range(bounds);
+        if (!range || _cell_count(*range) > MAX_CELLS) {
+            _large.push_back(entry);
+            return;
+        }
+        for (int y = range->top(); y <= range->bottom(); y++) {
+            for (int x = range->left(); x <= range->right(); x++) {
+                _cells[_key(x, y)].push_back(entry);
+            }
+        }
+    }
+
+    void _remove(T const *item, Geom::Rect const &bounds)
+    {
+        auto const is_item = [=] (Entry const &entry) { return entry.item == item; };
+        auto const range = _cell_range(bounds);
+        if (!range || _cell_count(*range) > MAX_CELLS) {
+            _large.erase(std::remove_if(_large.begin(), _large.end(), is_item), _large.end());
+            return;
+        }
+        for (int y = range->top(); y <= range->bottom(); y++) {
+            for (int x = range->left(); x <= range->right(); x++) {
+                if (auto it = _cells.find(_key(x, y)); it != _cells.end()) {
+                    auto &entries = it->second;
+                    entries.erase(std::remove_if(entries.begin(), entries.end(), is_item), entries.end());
+                    if (entries.empty()) {
+                        _cells.erase(it);
+                    }
+                }
+            }
+        }
+    }
+};
+
+} // namespace Inkscape
+
+#endif // SEEN_DISPLAY_CONTROL_GRID_INDEX_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
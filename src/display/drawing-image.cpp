@@ -26,10 +26,32 @@ DrawingImage::DrawingImage(Drawing &drawing)
 {
 }
 
-void DrawingImage::setPixbuf(std::shared_ptr<Inkscape::Pixbuf const> pixbuf)
+void DrawingImage::setPixbuf(std::shared_ptr<Inkscape::Pixbuf const> pixbuf, std::function<void()> onrendered)
 {
-    defer([this, pixbuf = std::move(pixbuf)] () mutable {
+    defer([this, pixbuf = std::move(pixbuf), onrendered = std::move(onrendered)] () mutable {
         _pixbuf = std::move(pixbuf);
+        _mipmap.reset();
+        _size = {};
+        _onneeded = nullptr;
+        _onrendered = std::move(onrendered);
+        _reported = 0;
+        if (_pixbuf) {
+            _mipmap = std::make_unique<PixbufMipmap>(_pixbuf, _drawing.mipmapCache());
+            _size = Geom::IntPoint(_pixbuf->width(), _pixbuf->height());
+        }
+        _markForUpdate(STATE_ALL, false);
+    });
+}
+
+void DrawingImage::setPlaceholder(Geom::IntPoint const &size, std::function<void()> onneeded)
+{
+    defer([this, size, onneeded = std::move(onneeded)] () mutable {
+        _pixbuf.reset();
+        _mipmap.reset();
+        _size = size;
+        _onneeded = std::move(onneeded);
+        _onrendered = nullptr;
+        _requested = false;
         _markForUpdate(STATE_ALL, false);
     });
 }
@@ -60,10 +82,10 @@ void DrawingImage::setClipbox(Geom::Rect const &box)
 
 Geom::Rect DrawingImage::bounds() const
 {
-    if (!_pixbuf) return _clipbox;
+    if (!_pixbuf && !_onneeded) return _clipbox;
 
-    double pw = _pixbuf->width();
-    double ph = _pixbuf->height();
+    double pw = _size.x();
+    double ph = _size.y();
     double vw = pw * _scale[Geom::X];
     double vh = ph * _scale[Geom::Y];
     Geom::Point wh(vw, vh);
@@ -91,7 +113,7 @@ void DrawingImage::setStyle(SPStyle const *style, SPStyle const *context_style)
 unsigned DrawingImage::_updateItem(Geom::IntRect const &, UpdateContext const &, unsigned, unsigned)
 {
     // Calculate bbox
-    if (_pixbuf) {
+    if (_pixbuf || _onneeded) {
         Geom::Rect r = bounds() * _ctm;
         _bbox = r.roundOutwards();
     } else {
@@ -101,12 +123,33 @@ unsigned DrawingImage::_updateItem(Geom::IntRect const &, UpdateContext const &,
     return STATE_ALL;
 }
 
-unsigned DrawingImage::_renderItem(DrawingContext &dc, RenderContext &rc, Geom::IntRect const &/*area*/, unsigned flags, DrawingItem const */*stop_at*/) const
+unsigned DrawingImage::_renderItem(DrawingContext &dc, RenderContext &rc, Geom::IntRect const &area, unsigned flags, DrawingItem const */*stop_at*/) const
 {
     bool const outline = (flags & RENDER_OUTLINE) && !_drawing.imageOutlineMode();
 
-    if (!outline) {
-        if (!_pixbuf) return RENDER_OK;
+    if (!outline && !_pixbuf) {
+        if (!_onneeded) return RENDER_OK;
+
+        // The image is still being decoded. Ask for it once and draw a neutral box in its place.
+        if (!_requested.exchange(true)) {
+            _onneeded();
+        }
+
+        Inkscape::DrawingContext::Save save(dc);
+        dc.transform(_ctm);
+        dc.newPath();
+        dc.rectangle(bounds());
+        dc.setSource(0.5, 0.5, 0.5, 0.25);
+        dc.fill();
+
+    } else if (!outline) {
+        if (_onrendered) {
+            auto const now = g_get_monotonic_time();
+            auto last = _reported.load();
+            if (now - last > 1000000 && _reported.compare_exchange_strong(last, now)) {
+                _onrendered();
+            }
+        }
 
         Inkscape::DrawingContext::Save save(dc);
         dc.transform(_ctm);
@@ -116,10 +159,39 @@ unsigned DrawingImage::_renderItem(DrawingContext &dc, RenderContext &rc, Geom::
 
         dc.translate(_origin);
         dc.scale(_scale);
-        // const_cast required since Cairo needs to modify the internal refcount variable, but we do not want to give up the
-        // benefits of const for the rest of our code. The underlying object is guaranteed to be non-const, so this is well-defined.
-        // It is also thread-safe to modify the refcount in this way, since Cairo uses atomics internally.
-        dc.setSource(const_cast<cairo_surface_t*>(_pixbuf->getSurfaceRaw()), 0, 0);
+
+        // When the image is drawn much smaller than its size and will be smoothed, draw the visible
+        // part of a level of its mipmap instead, so that Cairo does not have to filter it down from
+        // full size on every render.
+        int level = 0;
+        bool const smooth = style_image_rendering == SP_CSS_IMAGE_RENDERING_AUTO ||
+                            style_image_rendering == SP_CSS_IMAGE_RENDERING_OPTIMIZEQUALITY;
+        auto const pixel_to_device = Geom::Scale(_scale) * Geom::Translate(_origin) * _ctm;
+        if (smooth && _mipmap && _drawing.cacheBudget() > 0) {
+            level = _mipmap->levelFor(std::max(pixel_to_device.expansionX(), pixel_to_device.expansionY()));
+        }
+
+        Geom::OptIntRect region;
+        if (level > 0) {
+            auto const visible = Geom::Rect(area) * pixel_to_device.inverse() & Geom::Rect(0, 0, _pixbuf->width(), _pixbuf->height());
+            if (visible) {
+                // Leave some margin for the filter to sample from.
+                region = (*visible * Geom::Scale(1.0 / (1 << level))).roundOutwards();
+                region->expandBy(2);
+                region &= _mipmap->levelRect(level);
+            }
+        }
+
+        if (region) {
+            auto surface = _mipmap->region(level, *region);
+            dc.transform(Geom::Translate(Geom::Point(region->min())) * Geom::Scale(1 << level));
+            dc.setSource(surface->cobj(), 0, 0);
+        } else {
+            // const_cast required since Cairo needs to modify the internal refcount variable, but we do not want to give up the
+            // benefits of const for the rest of our code. The underlying object is guaranteed to be non-const, so this is well-defined.
+            // It is also thread-safe to modify the refcount in this way, since Cairo uses atomics internally.
+            dc.setSource(const_cast<cairo_surface_t*>(_pixbuf->getSurfaceRaw()), 0, 0);
+        }
         dc.patternSetExtend(CAIRO_EXTEND_PAD);
 
         // See: http://www.w3.org/TR/SVG/painting.html#ImageRenderingProperty
@@ -201,7 +273,7 @@ static double distance_to_segment(Geom::Point const &p, Geom::Point const &a1, G
 
 DrawingItem *DrawingImage::_pickItem(Geom::Point const &p, double delta, unsigned flags)
 {
-    if (!_pixbuf) return nullptr;
+    if (!_pixbuf && !_onneeded) return nullptr;
 
     bool outline = (flags & PICK_OUTLINE) && !_drawing.imageOutlineMode();
 
@@ -220,6 +292,10 @@ DrawingItem *DrawingImage::_pickItem(Geom::Point const &p, double delta, unsigne
         }
         return nullptr;
 
+    } else if (!_pixbuf) {
+        // Placeholder; treat as opaque.
+        return bounds().contains(p * _ctm.inverse()) ? this : nullptr;
+
     } else {
         auto pixels = _pixbuf->pixels();
         int width = _pixbuf->width();
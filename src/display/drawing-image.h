@@ -13,12 +13,15 @@
 #ifndef INKSCAPE_DISPLAY_DRAWING_IMAGE_H
 #define INKSCAPE_DISPLAY_DRAWING_IMAGE_H
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <2geom/transforms.h>
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <cairo.h>
 
 #include "display/drawing-item.h"
+#include "display/pixbuf-mipmap.h"
 
 namespace Inkscape {
 class Pixbuf;
@@ -32,7 +35,16 @@ public:
 
     void setStyle(SPStyle const *style, SPStyle const *context_style = nullptr) override;
 
-    void setPixbuf(std::shared_ptr<Inkscape::Pixbuf const> pb);
+    /**
+     * Draw the given image. \a onrendered, if given, is called from a rendering thread when the
+     * image is drawn, at most about once a second.
+     */
+    void setPixbuf(std::shared_ptr<Inkscape::Pixbuf const> pb, std::function<void()> onrendered = {});
+    /**
+     * Draw a placeholder for an image of the given size in pixels until setPixbuf() is called.
+     * \a onneeded is called the first time the placeholder is rendered, from a rendering thread.
+     */
+    void setPlaceholder(Geom::IntPoint const &size, std::function<void()> onneeded);
     void setScale(double sx, double sy);
     void setOrigin(Geom::Point const &o);
     void setClipbox(Geom::Rect const &box);
@@ -46,6 +58,12 @@ protected:
     DrawingItem *_pickItem(Geom::Point const &p, double delta, unsigned flags) override;
 
     std::shared_ptr<Inkscape::Pixbuf const> _pixbuf;
+    std::unique_ptr<PixbufMipmap> _mipmap; ///< for drawing the pixbuf at reduced size
+    Geom::IntPoint _size; ///< of the pixbuf or placeholder
+    std::function<void()> _onneeded; ///< set while showing a placeholder
+    mutable std::atomic<bool> _requested = false;
+    std::function<void()> _onrendered;
+    mutable std::atomic<gint64> _reported = 0; ///< when _onrendered was last called
 
     SPImageRendering style_image_rendering;
 
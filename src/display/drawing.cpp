@@ -15,6 +15,7 @@
 #include <thread>
 #include "display/drawing.h"
 #include "display/control/canvas-item-drawing.h"
+#include "display/pixbuf-mipmap.h"
 #include "nr-filter-gaussian.h"
 #include "nr-filter-types.h"
 
@@ -51,6 +52,7 @@ static auto default_numthreads()
 Drawing::Drawing(Inkscape::CanvasItemDrawing *canvas_item_drawing)
     : _canvas_item_drawing(canvas_item_drawing)
     , _grayscale_matrix(std::vector<double>(grayscale_matrix.begin(), grayscale_matrix.end()))
+    , _mipmap_cache(std::make_shared<MipmapTileCache>())
 {
     _loadPrefs();
 }
@@ -281,6 +283,9 @@ void Drawing::_pickItemsForCaching()
     }
     std::sort(to_cache.begin(), to_cache.end());
 
+    // Mipmap tiles get what the item cache leaves over.
+    _mipmap_cache->setBudget(_cache_budget - used);
+
     // Uncache the items that are cached but should not be cached.
     // Note: setCached() modifies _cached_items, so the temporary container is necessary.
     std::vector<DrawingItem*> to_uncache;
@@ -329,6 +334,7 @@ void Drawing::_loadPrefs()
     } else {
         _cache_budget = 0;
     }
+    _mipmap_cache->setBudget(_cache_budget); // Nothing is cached yet.
 
     // Set the global variable governing the number of filter threads, and track it too. (This is ugly, but hopefully transitional.)
     set_num_filter_threads(prefs->getIntLimited("/options/threading/numthreads", default_numthreads(), 1, 256));
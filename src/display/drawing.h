@@ -15,6 +15,7 @@
 
 #include <set>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <boost/operators.hpp>
 #include <2geom/rect.h>
@@ -32,6 +33,7 @@ namespace Inkscape {
 class DrawingItem;
 class CanvasItemDrawing;
 class DrawingContext;
+class MipmapTileCache;
 
 class Drawing
 {
@@ -71,11 +73,14 @@ public:
     uint32_t imageOutlineColor() const { return _image_outline_color; }
     bool imageOutlineMode() const { return _image_outline_mode; }
     int filterQuality() const { return _filter_quality; }
+    bool hasClip() const { return _clip.has_value(); }
     int blurQuality() const { return _blur_quality; }
     bool useDithering() const { return _use_dithering; }
     double cursorTolerance() const { return _cursor_tolerance; }
     bool selectZeroOpacity() const { return _select_zero_opacity; }
     Geom::OptIntRect const &cacheLimit() const { return _cache_limit; }
+    size_t cacheBudget() const { return _cache_budget; }
+    std::shared_ptr<MipmapTileCache> const &mipmapCache() const { return _mipmap_cache; }
 
     void update(Geom::IntRect const &area = Geom::IntRect::infinite(), Geom::Affine const &affine = Geom::identity(),
                 unsigned flags = DrawingItem::STATE_ALL, unsigned reset = 0);
@@ -112,6 +117,7 @@ private:
     bool _use_dithering;
     double _cursor_tolerance;
     size_t _cache_budget; ///< Maximum allowed size of cache.
+    std::shared_ptr<MipmapTileCache> _mipmap_cache; ///< Image tiles; takes the part of the cache budget the items leave.
     Geom::OptIntRect _cache_limit;
     std::optional<Geom::PathVector> _clip;
     bool _select_zero_opacity;
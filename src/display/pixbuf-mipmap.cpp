@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/**
+ * @file
+ * Lazily built, tiled mipmap pyramid for bitmap images.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "pixbuf-mipmap.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <boost/functional/hash.hpp>
+
+#include "cairo-utils.h"
+
+namespace Inkscape {
+namespace {
+
+int constexpr TILE_SIZE = 256;
+
+// Levels smaller than this in both dimensions are not worth having.
+int constexpr MIN_LEVEL_SIZE = 16;
+
+int level_dim(int dim, int level)
+{
+    return (dim + (1 << level) - 1) >> level;
+}
+
+/// Average four premultiplied ARGB32 pixels.
+uint32_t average(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint32_t sum = ((a >> shift) & 0xff) + ((b >> shift) & 0xff) + ((c >> shift) & 0xff) + ((d >> shift) & 0xff);
+        result |= ((sum + 2) >> 2) << shift;
+    }
+    return result;
+}
+
+struct PixelSource
+{
+    unsigned char const *data = nullptr;
+    int stride = 0;
+    int x0 = 0, y0 = 0;
+
+    uint32_t get(int x, int y) const
+    {
+        return *reinterpret_cast<uint32_t const *>(data + (y - y0) * stride + (x - x0) * 4);
+    }
+};
+
+} // namespace
+
+bool MipmapTileCache::Key::operator==(Key const &other) const
+{
+    return owner == other.owner && level == other.level && x == other.x && y == other.y;
+}
+
+std::size_t MipmapTileCache::KeyHash::operator()(Key const &key) const
+{
+    std::size_t hash = std::hash<PixbufMipmap const *>()(key.owner);
+    boost::hash_combine(hash, key.level);
+    boost::hash_combine(hash, key.x);
+    boost::hash_combine(hash, key.y);
+    return hash;
+}
+
+void MipmapTileCache::setBudget(std::size_t bytes)
+{
+    auto lock = std::lock_guard(_mutables);
+    _budget = bytes;
+    _shrink();
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> MipmapTileCache::_get(Key const &key)
+{
+    auto lock = std::lock_guard(_mutables);
+    auto it = _map.find(key);
+    if (it == _map.end()) {
+        return {};
+    }
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return it->second->second;
+}
+
+void MipmapTileCache::_put(Key const &key, Cairo::RefPtr<Cairo::ImageSurface> tile)
+{
+    auto lock = std::lock_guard(_mutables);
+    if (_map.count(key)) {
+        return; // Another thread got there first.
+    }
+    _used += tile->get_stride() * tile->get_height();
+    _lru.emplace_front(key, std::move(tile));
+    _map.emplace(key, _lru.begin());
+    _shrink();
+}
+
+void MipmapTileCache::_drop(PixbufMipmap const *owner)
+{
+    auto lock = std::lock_guard(_mutables);
+    for (auto it = _lru.begin(); it != _lru.end(); ) {
+        if (it->first.owner == owner) {
+            _used -= it->second->get_stride() * it->second->get_height();
+            _map.erase(it->first);
+            it = _lru.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void MipmapTileCache::_shrink()
+{
+    // Tiles in use by a renderer stay alive through their reference count.
+    while (_used > _budget && !_lru.empty()) {
+        auto &[key, tile] = _lru.back();
+        _used -= tile->get_stride() * tile->get_height();
+        _map.erase(key);
+        _lru.pop_back();
+    }
+}
+
+PixbufMipmap::PixbufMipmap(std::shared_ptr<Pixbuf const> pixbuf, std::shared_ptr<MipmapTileCache> cache)
+    : _pixbuf(std::move(pixbuf))
+    , _cache(std::move(cache))
+{
+    // Only premultiplied pixels can be averaged directly.
+    if (!_pixbuf || _pixbuf->pixelFormat() != Pixbuf::PF_CAIRO) {
+        return;
+    }
+
+    while (level_dim(_pixbuf->width(), _levels) >= MIN_LEVEL_SIZE ||
+           level_dim(_pixbuf->height(), _levels) >= MIN_LEVEL_SIZE)
+    {
+        _levels++;
+    }
+}
+
+PixbufMipmap::~PixbufMipmap()
+{
+    if (_levels > 1) {
+        _cache->_drop(this);
+    }
+}
+
+int PixbufMipmap::levelFor(double scale) const
+{
+    if (scale <= 0.0 || scale >= 0.5) {
+        return 0;
+    }
+    int level = std::floor(std::log2(1.0 / scale));
+    return std::clamp(level, 0, _levels - 1);
+}
+
+Geom::IntRect PixbufMipmap::levelRect(int level) const
+{
+    return Geom::IntRect(0, 0, level_dim(_pixbuf->width(), level), level_dim(_pixbuf->height(), level));
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> PixbufMipmap::region(int level, Geom::IntRect const &area) const
+{
+    assert(level > 0 && level < _levels);
+
+    auto surface = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, area.width(), area.height());
+    auto const dst = surface->get_data();
+    int const dst_stride = surface->get_stride();
+
+    for (int ty = area.top() / TILE_SIZE; ty * TILE_SIZE < area.bottom(); ty++) {
+        for (int tx = area.left() / TILE_SIZE; tx * TILE_SIZE < area.right(); tx++) {
+            auto tile = _tile(level, tx, ty);
+            auto const tile_rect = Geom::IntRect::from_xywh(tx * TILE_SIZE, ty * TILE_SIZE, tile->get_width(), tile->get_height());
+            auto const common = tile_rect & area;
+            if (!common) {
+                continue;
+            }
+            auto const src = tile->get_data();
+            int const src_stride = tile->get_stride();
+            for (int y = common->top(); y < common->bottom(); y++) {
+                std::copy_n(src + (y - tile_rect.top()) * src_stride + (common->left() - tile_rect.left()) * 4,
+                            common->width() * 4,
+                            dst + (y - area.top()) * dst_stride + (common->left() - area.left()) * 4);
+            }
+        }
+    }
+
+    surface->mark_dirty();
+    return surface;
+}
+
+/**
+ * Get a tile of a level from the cache, or compute it from the level below.
+ */
+Cairo::RefPtr<Cairo::ImageSurface> PixbufMipmap::_tile(int level, int x, int y) const
+{
+    auto const key = MipmapTileCache::Key{ this, level, x, y };
+    if (auto tile = _cache->_get(key)) {
+        return tile;
+    }
+
+    auto const rect = levelRect(level) & Geom::IntRect::from_xywh(x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+    auto const below = levelRect(level - 1);
+
+    // Gather the pixels of the level below: the image itself, or up to four tiles.
+    PixelSource sources[4];
+    Cairo::RefPtr<Cairo::ImageSurface> keepalive[4];
+    if (level == 1) {
+        sources[0] = { _pixbuf->pixels(), _pixbuf->rowstride(), 0, 0 };
+    } else {
+        for (int i = 0; i < 4; i++) {
+            int const sx = 2 * x + i % 2;
+            int const sy = 2 * y + i / 2;
+            if (sx * TILE_SIZE >= below.right() || sy * TILE_SIZE >= below.bottom()) {
+                continue;
+            }
+            keepalive[i] = _tile(level - 1, sx, sy);
+            sources[i] = { keepalive[i]->get_data(), keepalive[i]->get_stride(), sx * TILE_SIZE, sy * TILE_SIZE };
+        }
+    }
+
+    auto pixel = [&] (int sx, int sy) {
+        sx = std::min(sx, below.right() - 1);
+        sy = std::min(sy, below.bottom() - 1);
+        if (level == 1) {
+            return sources[0].get(sx, sy);
+        }
+        int const i = (sy / TILE_SIZE - 2 * y) * 2 + (sx / TILE_SIZE - 2 * x);
+        return sources[i].get(sx, sy);
+    };
+
+    auto tile = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, rect->width(), rect->height());
+    auto const data = tile->get_data();
+    int const stride = tile->get_stride();
+
+    for (int py = rect->top(); py < rect->bottom(); py++) {
+        auto row = reinterpret_cast<uint32_t *>(data + (py - rect->top()) * stride);
+        for (int px = rect->left(); px < rect->right(); px++) {
+            row[px - rect->left()] = average(pixel(2 * px,     2 * py),
+                                             pixel(2 * px + 1, 2 * py),
+                                             pixel(2 * px,     2 * py + 1),
+                                             pixel(2 * px + 1, 2 * py + 1));
+        }
+    }
+
+    tile->mark_dirty();
+    _cache->_put(key, tile);
+    return tile;
+}
+
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/**
+ * @file
+ * Lazily built, tiled mipmap pyramid for bitmap images.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#ifndef INKSCAPE_DISPLAY_PIXBUF_MIPMAP_H
+#define INKSCAPE_DISPLAY_PIXBUF_MIPMAP_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <2geom/rect.h>
+#include <cairomm/surface.h>
+
+namespace Inkscape {
+
+class Pixbuf;
+class PixbufMipmap;
+
+/**
+ * Thread-safe least-recently-used store for the tiles of all the mipmaps of a Drawing.
+ */
+class MipmapTileCache
+{
+public:
+    /// Set the maximum number of bytes used by tiles, discarding the least recently used ones to fit.
+    void setBudget(std::size_t bytes);
+
+private:
+    struct Key
+    {
+        PixbufMipmap const *owner;
+        int level, x, y;
+        bool operator==(Key const &other) const;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(Key const &key) const;
+    };
+
+    using Entry = std::pair<Key, Cairo::RefPtr<Cairo::ImageSurface>>;
+
+    std::mutex _mutables;
+    std::list<Entry> _lru; ///< Most recently used first.
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _map;
+    std::size_t _used = 0;
+    std::size_t _budget = 0;
+
+    Cairo::RefPtr<Cairo::ImageSurface> _get(Key const &key);
+    void _put(Key const &key, Cairo::RefPtr<Cairo::ImageSurface> tile);
+    void _drop(PixbufMipmap const *owner);
+    void _shrink();
+
+    friend class PixbufMipmap;
+};
+
+/**
+ * A mipmap pyramid for a Pixbuf. Level 0 is the pixbuf itself; each further level halves the
+ * resolution. Levels are stored as tiles that are only computed, from the level below, when
+ * asked for. Safe to use from several rendering threads at once.
+ */
+class PixbufMipmap
+{
+public:
+    PixbufMipmap(std::shared_ptr<Pixbuf const> pixbuf, std::shared_ptr<MipmapTileCache> cache);
+    PixbufMipmap(PixbufMipmap const &) = delete;
+    PixbufMipmap &operator=(PixbufMipmap const &) = delete;
+    ~PixbufMipmap();
+
+    /// Number of levels, including the original image. 1 if the image cannot be mipmapped.
+    int levels() const { return _levels; }
+
+    /// The coarsest level that still has at least \a scale times the resolution of the original.
+    int levelFor(double scale) const;
+
+    /// The size of a level in pixels.
+    Geom::IntRect levelRect(int level) const;
+
+    /// Assemble the given area of a level (in pixels of that level, level > 0) into a new surface.
+    Cairo::RefPtr<Cairo::ImageSurface> region(int level, Geom::IntRect const &area) const;
+
+private:
+    std::shared_ptr<Pixbuf const> _pixbuf;
+    std::shared_ptr<MipmapTileCache> _cache;
+    int _levels = 1;
+
+    Cairo::RefPtr<Cairo::ImageSurface> _tile(int level, int x, int y) const;
+};
+
+} // namespace Inkscape
+
+#endif // INKSCAPE_DISPLAY_PIXBUF_MIPMAP_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
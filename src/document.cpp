@@ -45,6 +45,7 @@
 
 #include <2geom/transforms.h>
 
+#include "conn-avoid-rerouter.h"
 #include "desktop.h"
 #include "document-undo.h"
 #include "event-log.h"
@@ -120,6 +121,7 @@ SPDocument::SPDocument() :
     actionkey(),
     object_id_counter(1),
     _router(std::make_unique<Avoid::Router>(Avoid::PolyLineRouting|Avoid::OrthogonalRouting)),
+    _rerouter(std::make_unique<Inkscape::ConnectorRerouter>()),
     current_persp3d(nullptr),
     current_persp3d_impl(nullptr),
     _parent_document(nullptr),
@@ -176,6 +178,7 @@ SPDocument::~SPDocument() {
 
     // kill/unhook this first
     _profileManager.reset();
+    _rerouter.reset();
     _desktop_activated_connection.disconnect();
 
     if (partial) {
@@ -350,6 +353,20 @@ void SPDocument::collectOrphans() {
     }
 }
 
+// The end of the version is stored as a string, so there is no way around a string comparison.
+static bool is_version_1_3_1(Inkscape::Version const &version)
+{
+    gchar *version_string = sp_version_to_string(version);
+    bool const result = std::strncmp(version_string, "1.3.1", 5) == 0;
+    g_free(version_string);
+    return result;
+}
+
+bool SPDocument::needsVersionFixups(Inkscape::Version const &version)
+{
+    return sp_version_inside_range(version, 0, 1, 1, 2) || is_version_1_3_1(version);
+}
+
 SPDocument *SPDocument::createDoc(Inkscape::XML::Document *rdoc,
                                   gchar const *filename,
                                   gchar const *document_base,
@@ -469,6 +486,10 @@ SPDocument *SPDocument::createDoc(Inkscape::XML::Document *rdoc,
 
     // ************* Fix Document **************
     // Move to separate function?
+    // Keep needsVersionFixups() in step with the checks below.
+    if (!needsVersionFixups(document->root->version.inkscape)) {
+        return document;
+    }
 
     /** Fix baseline spacing (pre-92 files) **/
     if ( (!sp_no_convert_text_baseline_spacing)
@@ -497,8 +518,7 @@ SPDocument *SPDocument::createDoc(Inkscape::XML::Document *rdoc,
     }
 
     /** Fix 1.3.1 issue deleting the d attributes on shapes (stars, etc) **/
-    std::string version_string = sp_version_to_string(document->root->version.inkscape); // end of version is stored as a string so we can't escape a string comparison
-    if (version_string.size() > 4 && version_string.substr(0, 5) == "1.3.1") {
+    if (is_version_1_3_1(document->root->version.inkscape)) {
         document->getRoot()->updateRepr(SP_OBJECT_CHILD_MODIFIED_FLAG);
     }
 
@@ -519,6 +539,9 @@ SPDocument *SPDocument::createDoc(Inkscape::XML::Document *rdoc,
  */
 std::unique_ptr<SPDocument> SPDocument::copy() const
 {
+    // The copy must not miss content that is still being loaded.
+    const_cast<SPDocument *>(this)->finishLoading();
+
     // New SimpleDocument object where we will put all the same data
     Inkscape::XML::Document *new_rdoc = new Inkscape::XML::SimpleDocument();
 
@@ -1464,6 +1487,9 @@ gint SPDocument::ensureUpToDate()
             // to be modified, hence the second update pass.
         if (pass == 1) {
             _router->processTransaction();
+            if (_rerouter) {
+                _rerouter->routed();
+            }
         }
     }
 
@@ -1497,7 +1523,16 @@ SPDocument::rerouting_handler()
     // Process any queued movement actions and determine new routings for
     // object-avoiding connectors.  Callbacks will be used to update and
     // redraw affected connectors.
-    _router->processTransaction();
+    if (_rerouter && Inkscape::Preferences::get()->getBool("/tools/connector/backgroundrouting", true)) {
+        // The router itself is left to catch up the next time the document
+        // is brought fully up to date.
+        _rerouter->start();
+    } else {
+        _router->processTransaction();
+        if (_rerouter) {
+            _rerouter->routed();
+        }
+    }
 
     // We don't need to handle rerouting again until there are further
     // diagram updates.
@@ -1968,6 +2003,9 @@ unsigned int SPDocument::vacuumDocument()
 void SPDocument::setModifiedSinceSave(bool modified) {
     this->modified_since_save = modified;
     this->modified_since_autosave = modified;
+    if (modified) {
+        this->modification_count++;
+    }
     if (SP_ACTIVE_DESKTOP) {
         if (InkscapeWindow *window = SP_ACTIVE_DESKTOP->getInkscapeWindow()) {
             // During load, SP_ACTIVE_DESKTOP may be != nullptr, but parent might still be nullptr.
@@ -1980,6 +2018,13 @@ void SPDocument::setModifiedSinceSave(bool modified) {
     }
 }
 
+void SPDocument::finishLoading()
+{
+    if (auto finish = std::move(_finish_loading)) {
+        _finish_loading = nullptr;
+        finish();
+    }
+}
 
 /**
  * Paste SVG defs from the document retrieved from the clipboard or imported document into the active document.
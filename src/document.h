@@ -21,6 +21,7 @@
 
 #include <cstddef>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
@@ -77,10 +78,12 @@ class SPRoot;
 class SPNamedView;
 
 namespace Inkscape {
+    class ConnectorRerouter;
     class Selection; 
     class UndoStackObserver;
     class EventLog;
     class ProfileManager;
+    class Version;
     class PageManager;
     namespace XML {
         struct Document;
@@ -125,6 +128,8 @@ public:
     static SPDocument *createDoc(Inkscape::XML::Document *rdoc, char const *filename,
             char const *base, char const *name, bool keepalive,
             SPDocument *parent);
+    // Whether createDoc() fixes up documents written by this Inkscape version.
+    static bool needsVersionFixups(Inkscape::Version const &version);
     static SPDocument *createNewDoc(char const *filename, bool keepalive,
             bool make_new = false, SPDocument *parent=nullptr );
     static SPDocument *createNewDocFromMem(char const *buffer, int length, bool keepalive,
@@ -155,6 +160,15 @@ public:
     bool isModifiedSinceAutoSave() const { return modified_since_autosave; }
     void setModifiedSinceSave(bool const modified = true);
     void setModifiedSinceAutoSaveFalse() { modified_since_autosave = false; };
+    // Counts the calls to setModifiedSinceSave(true), to tell whether a snapshot is still current.
+    unsigned getModificationCount() const { return modification_count; }
+
+    // Whether content is still being added in the background (see Inkscape::IO::ProgressiveOpen).
+    bool isLoading() const { return static_cast<bool>(_finish_loading); }
+    // Set the function that adds all outstanding content at once, or clear it when done.
+    void setLoading(std::function<void ()> finish) { _finish_loading = std::move(finish); }
+    // Add all outstanding content now. Must be called before relying on the XML tree being complete.
+    void finishLoading();
 
     bool idle_handler();
     bool rerouting_handler();
@@ -197,6 +211,8 @@ public:
     // Document structure -----------------
     Inkscape::ProfileManager &getProfileManager() const { return *_profileManager; }
     Avoid::Router* getRouter() const { return _router.get(); }
+    /// Null once the document is being destroyed.
+    Inkscape::ConnectorRerouter *getConnectorRerouter() const { return _rerouter.get(); }
 
     
     /** Returns our SPRoot */
@@ -375,6 +391,7 @@ private:
     // Document ------------------------------
     std::unique_ptr<Inkscape::ProfileManager> _profileManager;   // Color profile.
     std::unique_ptr<Avoid::Router> _router; // Instance of the connector router
+    std::unique_ptr<Inkscape::ConnectorRerouter> _rerouter; // Routes connectors in the background
     std::unique_ptr<Inkscape::Selection> _selection;
 
     // Document status -----------------------
@@ -383,6 +400,8 @@ private:
     bool virgin ;   ///< Has the document never been touched?
     bool modified_since_save = false;
     bool modified_since_autosave = false;
+    unsigned modification_count = 0;
+    std::function<void ()> _finish_loading;
     sigc::connection modified_connection;
     sigc::connection rerouting_connection;
 
@@ -124,10 +124,8 @@ Extension::Extension(Inkscape::XML::Node *in_repr, Implementation::Implementatio
                 throw extension_no_name();
             }
         } else if (InxWidget::is_valid_widget_name(chname)) {
-            InxWidget *widget = InxWidget::make(child_repr, this);
-            if (widget) {
-                _widgets.push_back(widget);
-            }
+            // Built on first use, see _build_widgets().
+            _widget_reprs.push_back(child_repr);
         } else if (!strcmp(chname, "dependency")) {
             _deps.push_back(new Dependency(child_repr, this));
         } else if (!strcmp(chname, "script")) { // TODO: should these be parsed in their respective Implementation?
@@ -616,6 +614,7 @@ void
 Extension::paramListString (std::list <std::string> &retlist)
 {
     // first collect all widgets in the current extension
+    _build_widgets();
     std::vector<InxWidget *> widget_list;
     for (auto widget : _widgets) {
         widget->get_widgets(widget_list);
@@ -644,6 +643,7 @@ Extension::paramListString (std::list <std::string> &retlist)
 
 InxParameter *Extension::get_param(const gchar *name)
 {
+    _build_widgets();
     if (!name || _widgets.empty()) {
         throw Extension::param_not_exist();
     }
@@ -1033,6 +1033,7 @@ Extension::autogui (SPDocument *doc, Inkscape::XML::Node *node, sigc::signal<voi
     agui->set_spacing(InxParameter::GUI_BOX_SPACING);
 
     // go through the list of widgets and add the all non-hidden ones
+    _build_widgets();
     for (auto widget : _widgets) {
         if (widget->get_hidden()) {
             continue;
@@ -1104,9 +1105,39 @@ Extension::get_params_widget()
     return retval;
 }
 
+/**
+ * Build the widgets from their XML. Not done in the constructor, as most extensions never have
+ * their parameters looked at in a session.
+ */
+void Extension::_build_widgets()
+{
+    if (_widgets_built) {
+        return;
+    }
+    _widgets_built = true;
+
+    for (auto widget_repr : _widget_reprs) {
+        InxWidget *widget = InxWidget::make(widget_repr, this);
+        if (widget) {
+            _widgets.push_back(widget);
+        }
+    }
+    _widget_reprs.clear();
+}
+
 unsigned int Extension::widget_visible_count ( )
 {
     unsigned int _visible_count = 0;
+    if (!_widgets_built) {
+        // Asked for every effect at startup, so count without building the widgets. Only the
+        // "gui-hidden" attribute hides a top-level widget until its extension changes it.
+        for (auto widget_repr : _widget_reprs) {
+            if (InxWidget::can_make(widget_repr) && g_strcmp0(widget_repr->attribute("gui-hidden"), "true")) {
+                _visible_count++;
+            }
+        }
+        return _visible_count;
+    }
     for (auto widget : _widgets) {
         if (!widget->get_hidden()) {
             _visible_count++;
@@ -188,6 +188,9 @@ public:
     /* Parameter Stuff */
 private:
     std::vector<InxWidget *> _widgets; /**< A list of widgets for this extension. */
+    std::vector<Inkscape::XML::Node *> _widget_reprs; /**< Their XML, until they are built. */
+    bool _widgets_built = false;
+    void _build_widgets();
 
 public:
     /** \brief  A function to get the number of visible parameters of the extension.
@@ -17,12 +17,15 @@
 # include "config.h"  // only include where actually required!
 #endif
 
+#include <memory>
 #include <glibmm/fileutils.h>
 #include <glibmm/i18n.h>
 #include <glibmm/ustring.h>
 
 #include "db.h"
+#include "debug/startup-report.h"
 #include "inkscape.h"
+#include "registry-cache.h"
 #include "internal/emf-inout.h"
 #include "internal/emf-print.h"
 #include "internal/svgz.h"
@@ -146,6 +149,9 @@ update_pref(Glib::ustring const &pref_path,
 static std::vector<Glib::ustring> user_extensions;
 static std::vector<Glib::ustring> shared_extensions;
 
+// Where .inx files are read from while initializing, if enabled.
+static RegistryCache *registry_cache = nullptr;
+
 /**
  * Invokes the init routines for internal modules.
  *
@@ -242,14 +248,27 @@ init()
 #endif /* WITH_MAGICK */
 
     Internal::Filter::Filter::filters_all();
+    Debug::startup_phase("internal extensions");
+
+    std::unique_ptr<RegistryCache> cache;
+    if (Inkscape::Preferences::get()->getBool("/options/extensions/registrycache", true)) {
+        cache = std::make_unique<RegistryCache>(RegistryCache::default_path());
+        registry_cache = cache.get();
+    }
 
     // User extensions first so they can over-ride
     load_user_extensions();
     load_shared_extensions();
 
     for(auto &filename: get_filenames(SYSTEM, EXTENSIONS, {SP_MODULE_EXTENSION})) {
-        build_from_file(filename.c_str());
+        build_from_file(filename.c_str(), registry_cache);
+    }
+
+    if (cache) {
+        cache->save();
+        registry_cache = nullptr;
     }
+    Debug::startup_phase("extension files");
 
     /* this is at the very end because it has several catch-alls
      * that are possibly over-ridden by other extensions (such as
@@ -259,6 +278,7 @@ init()
 
     /* now we need to check and make sure everyone is happy */
     check_extensions();
+    Debug::startup_phase("extension checks");
 
     /* This is a hack to deal with updating saved outdated module
      * names in the prefs...
@@ -288,7 +308,7 @@ load_user_extensions()
             }
         }
         if (!exist) {
-            build_from_file(filename.c_str());
+            build_from_file(filename.c_str(), registry_cache);
             user_extensions.push_back(filename);
         }
     }
@@ -313,7 +333,7 @@ load_shared_extensions()
             }
         }
         if (!exist) {
-            build_from_file(filename.c_str());
+            build_from_file(filename.c_str(), registry_cache);
             shared_extensions.push_back(filename);
         }
     }
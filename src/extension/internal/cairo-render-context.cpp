@@ -29,6 +29,7 @@
 
 #include <csignal>
 #include <cerrno>
+#include <cstring>
 #include <2geom/pathvector.h>
 
 #include <glib.h>
@@ -1707,6 +1708,61 @@ CairoRenderContext::renderPathVector(Geom::PathVector const & pathv, SPStyle con
     return true;
 }
 
+/**
+ * A surface showing the pixels of \a surface, with an id derived from them. The PDF surface writes
+ * sources with the same id only once, so an image drawn many times, even through several
+ * separately loaded Pixbufs such as those of clones, ends up in the file once. The id goes on a
+ * surface of its own since \a surface may be shared; the encoded data it carries is copied along.
+ * Returns a new reference.
+ */
+static cairo_surface_t *tag_image_contents(cairo_surface_t *surface)
+{
+    if (cairo_surface_get_type(surface) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return cairo_surface_reference(surface);
+    }
+
+    static cairo_user_data_key_t const source_key{};
+    cairo_surface_flush(surface);
+    int const header[] = { cairo_image_surface_get_format(surface),
+                           cairo_image_surface_get_width(surface),
+                           cairo_image_surface_get_height(surface),
+                           cairo_image_surface_get_stride(surface) };
+    auto const data = cairo_image_surface_get_data(surface);
+    auto tagged = cairo_image_surface_create_for_data(data, static_cast<cairo_format_t>(header[0]), header[1],
+                                                      header[2], header[3]);
+    // The pixels stay with the surface they belong to.
+    cairo_surface_set_user_data(tagged, &source_key, cairo_surface_reference(surface),
+                                reinterpret_cast<cairo_destroy_func_t>(cairo_surface_destroy));
+
+    for (auto mimetype : { CAIRO_MIME_TYPE_JPEG, CAIRO_MIME_TYPE_JP2, CAIRO_MIME_TYPE_PNG, CAIRO_MIME_TYPE_UNIQUE_ID }) {
+        unsigned char const *mime = nullptr;
+        unsigned long length = 0;
+        cairo_surface_get_mime_data(surface, mimetype, &mime, &length);
+        if (mime) {
+            auto copy = static_cast<unsigned char *>(g_malloc(length));
+            std::memcpy(copy, mime, length);
+            cairo_surface_set_mime_data(tagged, mimetype, copy, length, g_free, copy);
+        }
+    }
+
+    unsigned char const *existing = nullptr;
+    unsigned long existing_length = 0;
+    cairo_surface_get_mime_data(tagged, CAIRO_MIME_TYPE_UNIQUE_ID, &existing, &existing_length);
+    if (existing) {
+        return tagged;
+    }
+
+    auto checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<guchar const *>(header), sizeof(header));
+    g_checksum_update(checksum, data, static_cast<gssize>(header[2]) * header[3]);
+    auto id = g_strdup_printf("inkscape-image-%s", g_checksum_get_string(checksum));
+    g_checksum_free(checksum);
+
+    cairo_surface_set_mime_data(tagged, CAIRO_MIME_TYPE_UNIQUE_ID, reinterpret_cast<unsigned char *>(id),
+                                std::strlen(id), g_free, id);
+    return tagged;
+}
+
 bool CairoRenderContext::renderImage(Inkscape::Pixbuf const *pb,
                                      Geom::Affine const &image_transform, SPStyle const *style)
 {
@@ -1734,8 +1790,14 @@ bool CairoRenderContext::renderImage(Inkscape::Pixbuf const *pb,
     // scaling by width & height is not needed because it will be done by Cairo
     transform(image_transform);
 
-    // cairo_set_source_surface only modifies refcount of 'image_surface', which is an implementation detail
-    cairo_set_source_surface(_cr, const_cast<cairo_surface_t*>(image_surface), 0.0, 0.0);
+    if (_vector_based_target) {
+        auto tagged = tag_image_contents(const_cast<cairo_surface_t*>(image_surface));
+        cairo_set_source_surface(_cr, tagged, 0.0, 0.0);
+        cairo_surface_destroy(tagged);
+    } else {
+        // cairo_set_source_surface only modifies refcount of 'image_surface', which is an implementation detail
+        cairo_set_source_surface(_cr, const_cast<cairo_surface_t*>(image_surface), 0.0, 0.0);
+    }
 
     // set clip region so that the pattern will not be repeated (bug in Cairo-PDF)
     if (_vector_based_target) {
@@ -26,9 +26,15 @@
 #endif
 
 
+#include <algorithm>
 #include <csignal>
 #include <cerrno>
+#include <cmath>
+#include <optional>
+#include <thread>
 
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include <2geom/transforms.h>
 #include <2geom/pathvector.h>
@@ -79,11 +85,13 @@
 #include "object/sp-radial-gradient.h"
 #include "object/sp-root.h"
 #include "object/sp-shape.h"
+#include "object/sp-switch.h"
 #include "object/sp-symbol.h"
 #include "object/sp-text.h"
 #include "object/sp-use.h"
 
 #include "util/units.h"
+#include "preferences.h"
 
 //#define TRACE(_args) g_printf _args
 #define TRACE(_args)
@@ -139,7 +147,7 @@ Here comes the rendering part which could be put into the 'render' methods of SP
 /* The below functions are copy&pasted plus slightly modified from *_invoke_print functions. */
 static void sp_item_invoke_render(SPItem *item, CairoRenderContext *ctx, SPItem *origin = nullptr, SPPage *page = nullptr);
 static void sp_group_render(SPGroup *group, CairoRenderContext *ctx, SPItem *origin = nullptr, SPPage *page = nullptr);
-static void sp_anchor_render(SPAnchor *a, CairoRenderContext *ctx);
+static void sp_anchor_render(SPAnchor *a, CairoRenderContext *ctx, SPPage *page = nullptr);
 static void sp_use_render(SPUse *use, CairoRenderContext *ctx, SPPage *page = nullptr);
 static void sp_shape_render(SPShape *shape, CairoRenderContext *ctx, SPItem *origin = nullptr);
 static void sp_text_render(SPText *text, CairoRenderContext *ctx);
@@ -417,15 +425,16 @@ static void sp_flowtext_render(SPFlowtext *flowtext, CairoRenderContext *ctx)
 
 static void sp_image_render(SPImage *image, CairoRenderContext *ctx)
 {
-    if (!image->pixbuf) {
+    auto pixbuf = image->getPixbuf();
+    if (!pixbuf) {
         return;
     }
     if ((image->width.computed <= 0.0) || (image->height.computed <= 0.0)) {
         return;
     }
 
-    int w = image->pixbuf->width();
-    int h = image->pixbuf->height();
+    int w = pixbuf->width();
+    int h = pixbuf->height();
 
     double x = image->x.computed;
     double y = image->y.computed;
@@ -445,10 +454,10 @@ static void sp_image_render(SPImage *image, CairoRenderContext *ctx)
     Geom::Scale s(width / (double)w, height / (double)h);
     Geom::Affine t(s * tp);
 
-    ctx->renderImage(image->pixbuf.get(), t, image->style);
+    ctx->renderImage(pixbuf.get(), t, image->style);
 }
 
-static void sp_anchor_render(SPAnchor *a, CairoRenderContext *ctx)
+static void sp_anchor_render(SPAnchor *a, CairoRenderContext *ctx, SPPage *page)
 {
     CairoRenderer *renderer = ctx->getRenderer();
 
@@ -458,7 +467,7 @@ static void sp_anchor_render(SPAnchor *a, CairoRenderContext *ctx)
     for(auto x : l){
         auto item = cast<SPItem>(x);
         if (item) {
-            renderer->renderItem(ctx, item);
+            renderer->renderItem(ctx, item, nullptr, page);
         }
     }
     if (a->href)
@@ -519,11 +528,27 @@ static void sp_root_render(SPRoot *root, CairoRenderContext *ctx)
     ctx->popState();
 }
 
-/**
-    This function converts the item to a raster image and includes the image into the cairo renderer.
-    It is only used for filters and then only when rendering filters as bitmaps is requested.
-*/
-static void sp_asbitmap_render(SPItem *item, CairoRenderContext *ctx, SPPage *page)
+namespace {
+
+/// Where the bitmap of an item rendered as a bitmap goes.
+struct BitmapPlacement
+{
+    Geom::Rect area; ///< In document coordinates.
+    double res;
+    Geom::Affine transform; ///< From bitmap pixels to the item's coordinates.
+};
+
+// Upper limit for the pixels of bitmaps rendered ahead but not yet written out.
+std::size_t constexpr RASTERIZE_AHEAD_BUDGET = 256 * 1024 * 1024;
+
+std::size_t pixbuf_bytes(Inkscape::Pixbuf const *pb)
+{
+    return pb ? static_cast<std::size_t>(pb->rowstride()) * pb->height() : 0;
+}
+
+} // namespace
+
+static std::optional<BitmapPlacement> sp_asbitmap_placement(SPItem *item, CairoRenderContext *ctx, SPPage *page)
 {
 
     // The code was adapted from sp_selection_create_bitmap_copy in selection-chemistry.cpp
@@ -545,14 +570,14 @@ static void sp_asbitmap_render(SPItem *item, CairoRenderContext *ctx, SPPage *pa
 
     // no bbox, e.g. empty group or item not overlapping its page
     if (!bbox) {
-        return;
+        return {};
     }
 
     // The width and height of the bitmap in pixels
     unsigned width =  ceil(bbox->width() * Inkscape::Util::Quantity::convert(res, "px", "in"));
     unsigned height = ceil(bbox->height() * Inkscape::Util::Quantity::convert(res, "px", "in"));
 
-    if (width == 0 || height == 0) return;
+    if (width == 0 || height == 0) return {};
 
     // Scale to exactly fit integer bitmap inside bounding box
     double scale_x = bbox->width() / width;
@@ -578,18 +603,30 @@ static void sp_asbitmap_render(SPItem *item, CairoRenderContext *ctx, SPPage *pa
     Geom::Affine t_item =  item->i2doc_affine();
     Geom::Affine t = t_on_document * t_item.inverse();
 
-    // Do the export
-    SPDocument *document = item->document;
+    return BitmapPlacement{ *bbox, res, t };
+}
 
-    std::vector<SPItem*> items;
-    items.push_back(item);
+/**
+    This function converts the item to a raster image and includes the image into the cairo renderer.
+    It is only used for filters and then only when rendering filters as bitmaps is requested.
+*/
+static void sp_asbitmap_render(SPItem *item, CairoRenderContext *ctx, SPPage *page)
+{
+    auto const placement = sp_asbitmap_placement(item, ctx, page);
+    if (!placement) {
+        return;
+    }
 
-    std::unique_ptr<Inkscape::Pixbuf> pb(sp_generate_internal_bitmap(document, *bbox, res, items, true));
+    // Use the bitmap rendered ahead if there is one, otherwise do the export now.
+    auto pb = ctx->getRenderer()->takeRasterized(ctx, item, page);
+    if (!pb) {
+        pb.reset(sp_generate_internal_bitmap(item->document, placement->area, placement->res, {item}, true));
+    }
 
     if (pb) {
         //TEST(gdk_pixbuf_save( pb, "bitmap.png", "png", NULL, NULL ));
 
-        ctx->renderImage(pb.get(), t, item->style);
+        ctx->renderImage(pb.get(), placement->transform, item->style);
     }
 }
 
@@ -604,7 +641,7 @@ static void sp_item_invoke_render(SPItem *item, CairoRenderContext *ctx, SPItem
         sp_symbol_render(symbol, ctx, origin, page);
     } else if (auto anchor = cast<SPAnchor>(item)) {
         TRACE(("<a>\n"));
-        sp_anchor_render(anchor, ctx);
+        sp_anchor_render(anchor, ctx, page);
     } else if (auto shape = cast<SPShape>(item)) {
         TRACE(("shape\n"));
         sp_shape_render(shape, ctx, origin);
@@ -681,6 +718,126 @@ void CairoRenderer::_doRender(SPItem *item, CairoRenderContext *ctx, SPItem *ori
     }
 }
 
+void CairoRenderer::_queueRasterized(CairoRenderContext *ctx, SPItem *item, SPPage *page)
+{
+    // Mirrors the traversal of renderItem(), as far as it is worth following.
+    if (item->isHidden() || has_hidder_filter(item) || is<SPMarker>(item)) {
+        return;
+    }
+
+    if (_shouldRasterize(ctx, item)) {
+        _raster_queue.emplace_back(item, page);
+    } else if (auto use = cast<SPUse>(item)) {
+        if (use->child) {
+            _queueRasterized(ctx, use->child, page);
+        }
+    } else if (auto group = cast<SPGroup>(item)) {
+        if (auto symbol = cast<SPSymbol>(group); symbol && !symbol->cloned) {
+            return;
+        }
+        if (auto switch_ = cast<SPSwitch>(group)) {
+            // Only the child that passes the conditional processing is drawn.
+            if (auto child_item = cast<SPItem>(switch_->_evaluateFirst())) {
+                _queueRasterized(ctx, child_item, page);
+            }
+            return;
+        }
+        // The root renders its children outside of any page.
+        auto const child_page = is<SPRoot>(group) ? nullptr : page;
+        for (auto &child : group->children) {
+            if (auto child_item = cast<SPItem>(&child)) {
+                _queueRasterized(ctx, child_item, child_page);
+            }
+        }
+    }
+}
+
+/**
+ * Render the bitmaps of the items at the front of the queue concurrently, as many as fit in the
+ * memory budget but at least one. Showing the items for rendering happens on this thread.
+ */
+void CairoRenderer::_rasterizeAhead(CairoRenderContext *ctx)
+{
+    std::vector<RasterKey> keys;
+    std::vector<std::unique_ptr<InternalBitmapRender>> renders;
+    std::size_t bytes = _rasterized_bytes;
+
+    std::size_t const numthreads = Inkscape::Preferences::get()->getIntLimited("/options/threading/numthreads", std::thread::hardware_concurrency(), 1, 256);
+
+    while (!_raster_queue.empty() && renders.size() < 2 * numthreads) {
+        auto const key = _raster_queue.front();
+        auto const placement = sp_asbitmap_placement(key.first, ctx, key.second);
+        if (!placement) {
+            _raster_queue.pop_front();
+            continue;
+        }
+
+        auto const scale = Inkscape::Util::Quantity::convert(placement->res, "px", "in");
+        std::size_t const size = 4 * std::ceil(placement->area.width() * scale) * std::ceil(placement->area.height() * scale);
+        if (!renders.empty() && bytes + size > RASTERIZE_AHEAD_BUDGET) {
+            break;
+        }
+
+        _raster_queue.pop_front();
+        keys.push_back(key);
+        renders.push_back(std::make_unique<InternalBitmapRender>(key.first->document, placement->area, placement->res,
+                                                                 std::vector<SPItem *>{key.first}, true));
+        bytes += size;
+    }
+
+    std::vector<std::unique_ptr<Inkscape::Pixbuf>> results(renders.size());
+
+    if (renders.size() == 1) {
+        results[0] = renders[0]->render();
+    } else if (!renders.empty()) {
+        auto pool = boost::asio::thread_pool(std::min<std::size_t>(numthreads, renders.size()));
+        for (std::size_t i = 0; i < renders.size(); i++) {
+            boost::asio::post(pool, [&, i] {
+                results[i] = renders[i]->render();
+            });
+        }
+        pool.join();
+    }
+
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        _rasterized_bytes += pixbuf_bytes(results[i].get());
+        _rasterized[keys[i]] = std::move(results[i]);
+    }
+}
+
+void CairoRenderer::_clearRasterized()
+{
+    _raster_queue.clear();
+    _rasterized.clear();
+    _rasterized_bytes = 0;
+}
+
+std::unique_ptr<Inkscape::Pixbuf> CairoRenderer::takeRasterized(CairoRenderContext *ctx, SPItem *item, SPPage *page)
+{
+    auto const key = RasterKey{ item, page };
+
+    if (!_rasterized.count(key)) {
+        auto it = std::find(_raster_queue.begin(), _raster_queue.end(), key);
+        if (it == _raster_queue.end()) {
+            return nullptr;
+        }
+        // Anything queued before this item, rendered ahead or not, was not drawn after all.
+        _raster_queue.erase(_raster_queue.begin(), it);
+        _rasterized.clear();
+        _rasterized_bytes = 0;
+        _rasterizeAhead(ctx);
+    }
+
+    auto it = _rasterized.find(key);
+    if (it == _rasterized.end()) {
+        return nullptr;
+    }
+    auto result = std::move(it->second);
+    _rasterized.erase(it);
+    _rasterized_bytes -= pixbuf_bytes(result.get());
+    return result;
+}
+
 // TODO change this to accept a const SPItem:
 void CairoRenderer::renderItem(CairoRenderContext *ctx, SPItem *item, SPItem *origin, SPPage *page)
 {
@@ -811,7 +968,9 @@ CairoRenderer::renderPages(CairoRenderContext *ctx, SPDocument *doc, bool stretc
     auto pages = doc->getPageManager().getPages();
     if (pages.size() == 0) {
         // Output the page bounding box as already set up in the initial setupDocument.
+        _queueRasterized(ctx, doc->getRoot(), nullptr);
         renderItem(ctx, doc->getRoot());
+        _clearRasterized();
         return true;
     }
 
@@ -860,7 +1019,12 @@ CairoRenderer::renderPage(CairoRenderContext *ctx, SPDocument *doc, SPPage *page
     // Set up page transformation which pushes objects back into the 0,0 location
     ctx->transform(Geom::Translate(rect.corner(0)).inverse());
 
-    for (auto &child : page->getOverlappingItems(false, true, false)) {
+    auto const children = page->getOverlappingItems(false, true, false);
+    for (auto &child : children) {
+        _queueRasterized(ctx, child, page);
+    }
+
+    for (auto &child : children) {
         ctx->pushState();
 
         // This process does not return layers, so those affines are added manually.
@@ -876,6 +1040,8 @@ CairoRenderer::renderPage(CairoRenderContext *ctx, SPDocument *doc, SPPage *page
         renderItem(ctx, child, nullptr, page);
         ctx->popState();
     }
+
+    _clearRasterized();
     return true;
 }
 
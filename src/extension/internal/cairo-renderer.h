@@ -16,8 +16,12 @@
  */
 
 #include "extension/extension.h"
+#include <deque>
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 
 //#include "libnrtype/font-instance.h"
 #include <cairo.h>
@@ -29,6 +33,8 @@ class SPHatchPath;
 class SPPage;
 
 namespace Inkscape {
+class Pixbuf;
+
 namespace Extension {
 namespace Internal {
 
@@ -60,6 +66,13 @@ public:
     bool renderPages(CairoRenderContext *ctx, SPDocument *doc, bool stretch_to_fit);
     bool renderPage(CairoRenderContext *ctx, SPDocument *doc, SPPage *page, bool stretch_to_fit);
 
+    /**
+     * Take the bitmap of an item that is rendered as a bitmap, if it was queued to be rendered
+     * ahead of the vector pass. Renders it first if needed, in parallel with the items queued
+     * after it. Returns null if the item was not queued and must be rasterized on the spot.
+     */
+    std::unique_ptr<Inkscape::Pixbuf> takeRasterized(CairoRenderContext *ctx, SPItem *item, SPPage *page);
+
 private:
     /** Extract metadata from doc and set it on ctx. */
     void setMetadata(CairoRenderContext *ctx, SPDocument *doc);
@@ -71,6 +84,17 @@ private:
     static void _doRender(SPItem *item, CairoRenderContext *ctx, SPItem *origin = nullptr,
                           SPPage *page = nullptr);
 
+    /** Queue the items below item that will be rendered as bitmaps, in rendering order. */
+    void _queueRasterized(CairoRenderContext *ctx, SPItem *item, SPPage *page);
+    void _rasterizeAhead(CairoRenderContext *ctx);
+    /** Drop whatever was queued or rendered ahead but not taken. */
+    void _clearRasterized();
+
+    using RasterKey = std::pair<SPItem *, SPPage *>;
+    std::deque<RasterKey> _raster_queue;
+    std::map<RasterKey, std::unique_ptr<Inkscape::Pixbuf>> _rasterized;
+    std::size_t _rasterized_bytes = 0; ///< Held in _rasterized, counted against the budget.
+
 };
 
 // FIXME: this should be a static method of CairoRenderer
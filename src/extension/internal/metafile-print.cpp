@@ -245,12 +245,12 @@ void PrintMetafile::hatch_classify(char *name, int *hatchType, U_COLORREF *hatch
 
 //
 //  Recurse down from a brush pattern, try to figure out what it is.
-//  If an image is found set a pointer to the epixbuf, else set that to NULL
+//  If an image is found set epixbuf to its pixels, else set that to NULL
 //  If a pattern is found with a name like [EW]MFhatch3_3F7FFF return hatchType=3, hatchColor=3F7FFF (as a uint32_t),
 //    otherwise hatchType is set to -1 and hatchColor is not defined.
 //
 
-void PrintMetafile::brush_classify(SPObject *parent, int depth, Inkscape::Pixbuf const **epixbuf, int *hatchType, U_COLORREF *hatchColor, U_COLORREF *bkColor)
+void PrintMetafile::brush_classify(SPObject *parent, int depth, std::shared_ptr<Inkscape::Pixbuf const> *epixbuf, int *hatchType, U_COLORREF *hatchColor, U_COLORREF *bkColor)
 {
     if (depth == 0) {
         *epixbuf    = nullptr;
@@ -279,7 +279,7 @@ void PrintMetafile::brush_classify(SPObject *parent, int depth, Inkscape::Pixbuf
             }
         }
     } else if (auto img = cast<SPImage>(parent)) {
-        *epixbuf = img->pixbuf.get();
+        *epixbuf = img->getPixbuf();
         return;
     } else { // some inkscape rearrangements pass through nodes between pattern and image which are not classified as either.
         for (auto& child: parent->children) {
@@ -13,6 +13,7 @@
 #define SEEN_INKSCAPE_EXTENSION_INTERNAL_METAFILE_PRINT_H
 
 #include <map>
+#include <memory>
 #include <stack>
 
 #include <glibmm/ustring.h>
@@ -94,7 +95,7 @@ protected:
     U_COLORREF weight_colors(U_COLORREF c1, U_COLORREF c2, double t);
 
     void        hatch_classify(char *name, int *hatchType, U_COLORREF *hatchColor, U_COLORREF *bkColor);
-    void        brush_classify(SPObject *parent, int depth, Inkscape::Pixbuf const **epixbuf, int *hatchType, U_COLORREF *hatchColor, U_COLORREF *bkColor);
+    void        brush_classify(SPObject *parent, int depth, std::shared_ptr<Inkscape::Pixbuf const> *epixbuf, int *hatchType, U_COLORREF *hatchColor, U_COLORREF *bkColor);
     static void swapRBinRGBA(char *px, int pixels);
 
     int         hold_gradient(void *gr, int mode);
@@ -2685,7 +2685,7 @@ void PdfParser::doImage(Object * /*ref*/, Stream *str, GBool inlineImg)
 				maskStr, maskWidth, maskHeight, maskInvert, maskInterpolate);
         } else {
 	    builder->addImage(state, str, width, height, colorMap, interpolate,
-		        haveColorKeyMask ? maskColors : static_cast<int *>(nullptr));
+		        haveColorKeyMask ? maskColors : static_cast<int *>(nullptr), inlineImg);
         }
         delete colorMap;
         
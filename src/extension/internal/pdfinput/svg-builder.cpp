@@ -19,6 +19,9 @@
 #include <string>
 #include <locale>
 #include <codecvt>
+#include <cstring>
+#include <map>
+#include <glibmm/checksum.h>
 
 #ifdef HAVE_POPPLER
 #define USE_CMS
@@ -66,6 +69,145 @@ namespace Internal {
 
 #define TRACE(_args) IFTRACE(g_print _args)
 
+/**
+ * Resources that have already been written to <defs>, looked up by their content. Many PDFs
+ * repeat the same gradients, clips, patterns and images on every page.
+ */
+struct SharedDefs
+{
+    struct Image
+    {
+        Inkscape::XML::Node *first = nullptr; ///< anchored, placed as is until the image turns up again
+        Inkscape::XML::Node *def = nullptr;
+    };
+
+    std::map<std::string, Inkscape::XML::Node *> defs;
+    std::map<Inkscape::XML::Node const *, int> uses;
+    std::map<std::string, Image> images;
+
+    ~SharedDefs()
+    {
+        for (auto &[key, image] : images) {
+            if (image.first) {
+                Inkscape::GC::release(image.first);
+            }
+        }
+    }
+};
+
+namespace {
+
+/**
+ * Append everything that makes up \a node, except for its own id, to \a key.
+ */
+void append_content_key(std::string &key, Inkscape::XML::Node const *node, bool is_top = true)
+{
+    key += node->name();
+    key += '\n';
+    for (auto const &attr : node->attributeList()) {
+        auto const name = g_quark_to_string(attr.key);
+        if (is_top && std::strcmp(name, "id") == 0) {
+            continue;
+        }
+        key += name;
+        key += '=';
+        key += attr.value.pointer();
+        key += '\n';
+    }
+    if (auto content = node->content()) {
+        key += content;
+    }
+    key += '{';
+    for (auto child = node->firstChild(); child; child = child->next()) {
+        append_content_key(key, child, false);
+    }
+    key += '}';
+}
+
+/**
+ * The EXIF orientation of a JPEG image, or 1 if it has none. Inkscape applies it when loading
+ * the image, but PDF viewers do not.
+ */
+int jpeg_orientation(std::vector<guchar> const &data)
+{
+    std::size_t pos = 2; // after the start of image marker
+    while (pos + 4 <= data.size() && data[pos] == 0xff) {
+        int const marker = data[pos + 1];
+        if (marker == 0xda || marker == 0xd9) {
+            break; // The image data starts, so there is no more metadata.
+        }
+        std::size_t const length = (data[pos + 2] << 8) | data[pos + 3];
+        std::size_t const start = pos + 4;
+        pos += 2 + length;
+        if (marker != 0xe1 || length < 8 || pos > data.size() ||
+            std::memcmp(data.data() + start, "Exif\0\0", 6) != 0) {
+            continue;
+        }
+
+        // A TIFF structure follows, in either byte order.
+        auto const tiff = data.data() + start + 6;
+        std::size_t const size = length - 8;
+        bool const big_endian = size >= 2 && tiff[0] == 'M';
+        auto read = [&] (std::size_t offset, int bytes) -> std::size_t {
+            std::size_t value = 0;
+            for (int i = 0; i < bytes; i++) {
+                value |= std::size_t{tiff[offset + i]} << (8 * (big_endian ? bytes - 1 - i : i));
+            }
+            return value;
+        };
+        if (size < 8) {
+            return 1;
+        }
+        auto const ifd = read(4, 4);
+        if (ifd + 2 > size) {
+            return 1;
+        }
+        auto const entries = read(ifd, 2);
+        for (std::size_t i = 0; i < entries && ifd + 2 + 12 * (i + 1) <= size; i++) {
+            auto const entry = ifd + 2 + 12 * i;
+            if (read(entry, 2) == 0x0112) {
+                return read(entry + 8, 2);
+            }
+        }
+        return 1;
+    }
+    return 1;
+}
+
+/**
+ * Whether the DCTDecode parameters of \a str turn off the conversion from YCbCr that JPEG
+ * decoders otherwise apply to images with three components.
+ */
+bool lacks_color_transform(Stream *str)
+{
+    auto dict = str->getDict();
+    if (!dict) {
+        return false;
+    }
+    auto is_off = [] (Object const &parms) {
+        if (!parms.isDict()) {
+            return false;
+        }
+        Object transform = parms.getDict()->lookup("ColorTransform");
+        return transform.isInt() && transform.getInt() == 0;
+    };
+    Object parms = dict->lookup("DecodeParms");
+    if (parms.isNull()) {
+        parms = dict->lookup("DP");
+    }
+    if (parms.isArray()) {
+        for (int i = 0; i < parms.arrayGetLength(); i++) {
+            if (is_off(parms.arrayGet(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return is_off(parms);
+}
+
+} // namespace
+
 
 /**
  * \class SvgBuilder
@@ -85,6 +227,7 @@ SvgBuilder::SvgBuilder(SPDocument *document, gchar *docname, XRef *xref)
     // Set default preference settings
     _preferences = _xml_doc->createElement("svgbuilder:prefs");
     _preferences->setAttribute("embedImages", "1");
+    _shared_defs = std::make_shared<SharedDefs>();
 }
 
 SvgBuilder::SvgBuilder(SvgBuilder *parent, Inkscape::XML::Node *root) {
@@ -94,6 +237,7 @@ SvgBuilder::SvgBuilder(SvgBuilder *parent, Inkscape::XML::Node *root) {
     _xref = parent->_xref;
     _xml_doc = parent->_xml_doc;
     _preferences = parent->_preferences;
+    _shared_defs = parent->_shared_defs;
     _container = this->_root = root;
     _init();
 }
@@ -835,10 +979,102 @@ Inkscape::XML::Node *SvgBuilder::_createClip(const std::string &d, const Geom::A
     clip_path->appendChild(path);
     Inkscape::GC::release(path);
 
-    // Append clipPath to defs and get id
-    _doc->getDefs()->getRepr()->appendChild(clip_path);
+    // Append clipPath to defs, or reuse an identical one
+    auto def = _internDef(clip_path);
     Inkscape::GC::release(clip_path);
-    return clip_path;
+    return def;
+}
+
+/**
+ * Add a newly built resource to <defs>, unless an identical one is already there.
+ * \return the node in <defs> to refer to; the caller keeps its reference to \a node either way
+ */
+Inkscape::XML::Node *SvgBuilder::_internDef(Inkscape::XML::Node *node)
+{
+    std::string content;
+    append_content_key(content, node);
+    std::string key = Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA256, content);
+
+    auto &def = _shared_defs->defs[key];
+    if (!def) {
+        _doc->getDefs()->getRepr()->appendChild(node);
+        def = node;
+    }
+    _shared_defs->uses[def]++;
+    return def;
+}
+
+/**
+ * Share the pixels of images that occur more than once. The first occurrence is kept as an
+ * image; when another turns up, the pixels move into <defs> and every occurrence becomes a
+ * <use> of them.
+ * \param image_node a newly created image without placement, owned by the caller
+ * \param key identifies the pixels and rendering of the image
+ * \return the node to place instead of \a image_node, owned by the caller
+ */
+Inkscape::XML::Node *SvgBuilder::_internImage(Inkscape::XML::Node *image_node, std::string const &key)
+{
+    auto &image = _shared_defs->images[key];
+    if (!image.first && !image.def) {
+        image.first = image_node;
+        Inkscape::GC::anchor(image_node);
+        return image_node;
+    }
+
+    auto create_use = [this] (Inkscape::XML::Node const *def) {
+        auto use = _xml_doc->createElement("svg:use");
+        use->setAttribute("xlink:href", std::string("#") + def->attribute("id"));
+        return use;
+    };
+
+    if (!image.def) {
+        image.def = image_node->duplicate(_xml_doc);
+        _doc->getDefs()->getRepr()->appendChild(image.def);
+        Inkscape::GC::release(image.def);
+
+        // Replace the first occurrence, keeping its placement
+        if (auto parent = image.first->parent()) {
+            auto use = create_use(image.def);
+            for (auto const &attr : image.first->attributeList()) {
+                auto const name = std::string(g_quark_to_string(attr.key));
+                if (name != "id" && name != "xlink:href" && name != "width" && name != "height" &&
+                    name != "preserveAspectRatio") {
+                    use->setAttribute(name, attr.value.pointer());
+                }
+            }
+            parent->addChild(use, image.first);
+            parent->removeChild(image.first);
+            Inkscape::GC::release(use);
+        }
+        Inkscape::GC::release(image.first);
+        image.first = nullptr;
+    }
+
+    Inkscape::GC::release(image_node);
+    return create_use(image.def);
+}
+
+/**
+ * Whether \a node is a resource in <defs> that more than one object refers to.
+ */
+bool SvgBuilder::_isSharedDef(Inkscape::XML::Node const *node) const
+{
+    auto it = _shared_defs->uses.find(node);
+    return it != _shared_defs->uses.end() && it->second > 1;
+}
+
+/**
+ * Stop handing out \a node for identical resources, because it is about to be changed.
+ */
+void SvgBuilder::_forgetDef(Inkscape::XML::Node const *node)
+{
+    _shared_defs->uses.erase(node);
+    for (auto it = _shared_defs->defs.begin(); it != _shared_defs->defs.end(); ++it) {
+        if (it->second == node) {
+            _shared_defs->defs.erase(it);
+            return;
+        }
+    }
 }
 
 void SvgBuilder::beginMarkedContent(const char *name, const char *group)
@@ -1035,9 +1271,8 @@ gchar *SvgBuilder::_createTilingPattern(GfxTilingPattern *tiling_pattern,
     delete pdf_parser;
     delete pattern_builder;
 
-    // Append the pattern to defs
-    _doc->getDefs()->getRepr()->appendChild(pattern_node);
-    gchar *id = g_strdup(pattern_node->attribute("id"));
+    // Append the pattern to defs, or reuse an identical one
+    gchar *id = g_strdup(_internDef(pattern_node)->attribute("id"));
     Inkscape::GC::release(pattern_node);
 
     return id;
@@ -1103,8 +1338,7 @@ gchar *SvgBuilder::_createGradient(GfxShading *shading, const Geom::Affine pat_m
         return nullptr;
     }
 
-    _doc->getDefs()->getRepr()->appendChild(gradient);
-    gchar *id = g_strdup(gradient->attribute("id"));
+    gchar *id = g_strdup(_internDef(gradient)->attribute("id"));
     Inkscape::GC::release(gradient);
 
     return id;
@@ -1965,7 +2199,82 @@ Inkscape::XML::Node *SvgBuilder::_createImage(Stream *str, int width, int height
     png_write_end(png_ptr, info_ptr);
     png_destroy_write_struct(&png_ptr, &info_ptr);
 
-    // Create repr
+    if (embed_image) {
+        return _embedImage(png_buffer, "image/png", interpolate);
+    }
+    fclose(fp);
+    auto image_node = _createImageNode(file_name, interpolate);
+    g_free(file_name);
+    return image_node;
+}
+
+/**
+ * \brief Creates an <image> element embedding a JPEG image stream as it is, without decoding it
+ * \return nullptr if the image cannot be shown correctly from its encoded data alone
+ */
+Inkscape::XML::Node *SvgBuilder::_createEncodedImage(Stream *str, GfxImageColorMap *color_map, bool interpolate)
+{
+    if (str->getKind() != strDCT || !color_map || color_map->getBits() != 8 ||
+        !_preferences->getAttributeBoolean("embedImages", true)) {
+        return nullptr;
+    }
+    // Other colour spaces, such as CMYK or indexed, are not shown the same by JPEG decoders
+    auto const mode = color_map->getColorSpace()->getMode();
+    if (mode != csDeviceGray && mode != csDeviceRGB) {
+        return nullptr;
+    }
+    // Colours stored as RGB would be taken for YCbCr
+    if (mode == csDeviceRGB && lacks_color_transform(str)) {
+        return nullptr;
+    }
+    // A decode array inverts or rescales the colours
+    for (int i = 0; i < color_map->getNumPixelComps(); i++) {
+        if (color_map->getDecodeLow(i) != 0.0 || color_map->getDecodeHigh(i) != 1.0) {
+            return nullptr;
+        }
+    }
+
+    // Read the JPEG data from below the DCT filter
+    std::vector<guchar> jpeg_buffer;
+    auto encoded = str->getNextStream();
+    encoded->reset();
+    for (int c; (c = encoded->getChar()) != EOF; ) {
+        jpeg_buffer.push_back(c);
+    }
+    encoded->close();
+
+    // Start of image marker
+    if (jpeg_buffer.size() < 2 || jpeg_buffer[0] != 0xff || jpeg_buffer[1] != 0xd8) {
+        return nullptr;
+    }
+    // Inkscape would turn the image by its orientation tag, which the PDF ignores
+    if (jpeg_orientation(jpeg_buffer) != 1) {
+        return nullptr;
+    }
+    return _embedImage(jpeg_buffer, "image/jpeg", interpolate);
+}
+
+/**
+ * \brief Creates an <image> element showing \a data, shared with identical earlier images
+ */
+Inkscape::XML::Node *SvgBuilder::_embedImage(std::vector<guchar> const &data, char const *mime_type,
+                                             bool interpolate)
+{
+    // Append format specification to the URI
+    auto *base64String = g_base64_encode(data.data(), data.size());
+    auto href = std::string("data:") + mime_type + ";base64," + base64String;
+    g_free(base64String);
+    auto image_node = _createImageNode(href, interpolate);
+
+    std::string key = Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA256, data.data(), data.size());
+    return _internImage(image_node, key + ":" + mime_type + (interpolate ? "" : ":optimizeSpeed"));
+}
+
+/**
+ * \brief Creates an unplaced <image> element for the unit square
+ */
+Inkscape::XML::Node *SvgBuilder::_createImageNode(std::string const &href, bool interpolate)
+{
     Inkscape::XML::Node *image_node = _xml_doc->createElement("svg:image");
     image_node->setAttributeSvgDouble("width", 1);
     image_node->setAttributeSvgDouble("height", 1);
@@ -1979,20 +2288,7 @@ Inkscape::XML::Node *SvgBuilder::_createImage(Stream *str, int width, int height
 
     // PS/PDF images are placed via a transformation matrix, no preserveAspectRatio used
     image_node->setAttribute("preserveAspectRatio", "none");
-
-    // Create href
-    if (embed_image) {
-        // Append format specification to the URI
-        auto *base64String = g_base64_encode(png_buffer.data(), png_buffer.size());
-        auto png_data = std::string("data:image/png;base64,") + base64String;
-        g_free(base64String);
-        image_node->setAttributeOrRemoveIfEmpty("xlink:href", png_data);
-    } else {
-        fclose(fp);
-        image_node->setAttribute("xlink:href", file_name);
-        g_free(file_name);
-    }
-
+    image_node->setAttributeOrRemoveIfEmpty("xlink:href", href);
     return image_node;
 }
 
@@ -2025,9 +2321,16 @@ Inkscape::XML::Node *SvgBuilder::_createMask(double width, double height) {
 }
 
 void SvgBuilder::addImage(GfxState *state, Stream *str, int width, int height, GfxImageColorMap *color_map,
-                          bool interpolate, int *mask_colors)
+                          bool interpolate, int *mask_colors, bool inline_image)
 {
-    Inkscape::XML::Node *image_node = _createImage(str, width, height, color_map, interpolate, mask_colors);
+    // Inline image data is part of the content stream, which must not be read past the image.
+    Inkscape::XML::Node *image_node = nullptr;
+    if (!mask_colors && !inline_image) {
+        image_node = _createEncodedImage(str, color_map, interpolate);
+    }
+    if (!image_node) {
+        image_node = _createImage(str, width, height, color_map, interpolate, mask_colors);
+    }
     if (image_node) {
         _setBlendMode(image_node, state);
         _setTransform(image_node, state, Geom::Affine(1.0, 0.0, 0.0, -1.0, 0.0, 1.0));
@@ -2079,7 +2382,10 @@ void SvgBuilder::addMaskedImage(GfxState *state, Stream *str, int width, int hei
 {
     Inkscape::XML::Node *mask_image_node = _createImage(mask_str, mask_width, mask_height,
                                           nullptr, mask_interpolate, nullptr, true, invert_mask);
-    Inkscape::XML::Node *image_node = _createImage(str, width, height, color_map, interpolate, nullptr);
+    Inkscape::XML::Node *image_node = _createEncodedImage(str, color_map, interpolate);
+    if (!image_node) {
+        image_node = _createImage(str, width, height, color_map, interpolate, nullptr);
+    }
     if ( mask_image_node && image_node ) {
         // Create mask for the image
         Inkscape::XML::Node *mask_node = _createMask(1.0, 1.0);
@@ -2111,7 +2417,10 @@ void SvgBuilder::addSoftMaskedImage(GfxState *state, Stream *str, int width, int
 {
     Inkscape::XML::Node *mask_image_node = _createImage(mask_str, mask_width, mask_height,
                                                         mask_color_map, mask_interpolate, nullptr, true);
-    Inkscape::XML::Node *image_node = _createImage(str, width, height, color_map, interpolate, nullptr);
+    Inkscape::XML::Node *image_node = _createEncodedImage(str, color_map, interpolate);
+    if (!image_node) {
+        image_node = _createImage(str, width, height, color_map, interpolate, nullptr);
+    }
     if ( mask_image_node && image_node ) {
         // Create mask for the image
         Inkscape::XML::Node *mask_node = _createMask(1.0, 1.0);
@@ -2163,8 +2472,9 @@ void SvgBuilder::applyOptionalMask(Inkscape::XML::Node *mask, Inkscape::XML::Nod
         auto source = mask->firstChild();
         auto source_gr = _getGradientNode(source, true);
         auto target_gr = _getGradientNode(target, true);
-        // Both objects have a gradient, try and merge them
-        if (source_gr && target_gr && source_gr->childCount() == target_gr->childCount()) {
+        // Both objects have a gradient, try and merge them, unless other objects use them too
+        if (source_gr && target_gr && source_gr->childCount() == target_gr->childCount() &&
+            !_isSharedDef(source_gr) && !_isSharedDef(target_gr)) {
             bool same_pos = _attrEqual(source_gr, target_gr, "x1") && _attrEqual(source_gr, target_gr, "x2")
                          && _attrEqual(source_gr, target_gr, "y1") && _attrEqual(source_gr, target_gr, "y2");
 
@@ -2179,6 +2489,8 @@ void SvgBuilder::applyOptionalMask(Inkscape::XML::Node *mask, Inkscape::XML::Nod
             }
 
             if (same_pos && white_mask) {
+                _forgetDef(source_gr);
+                _forgetDef(target_gr);
                 // We move the stop-opacity from the source to the target
                 auto target_st = target_gr->firstChild();
                 for (auto source_st = source_gr->firstChild(); source_st != nullptr; source_st = source_st->next()) {
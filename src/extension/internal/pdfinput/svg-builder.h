@@ -89,6 +89,8 @@ struct SvgGlyph {
     std::shared_ptr<CairoFont> cairo_font; // A pointer to the selected cairo font
 };
 
+struct SharedDefs;
+
 /**
  * Builds the inner SVG representation using libpoppler from the calls of PdfParser.
  */
@@ -119,7 +121,7 @@ public:
 
     // Image handling
     void addImage(GfxState *state, Stream *str, int width, int height,
-                  GfxImageColorMap *color_map, bool interpolate, int *mask_colors);
+                  GfxImageColorMap *color_map, bool interpolate, int *mask_colors, bool inline_image);
     void addImageMask(GfxState *state, Stream *str, int width, int height,
                       bool invert, bool interpolate);
     void addMaskedImage(GfxState *state, Stream *str, int width, int height,
@@ -189,9 +191,18 @@ private:
                                       GfxImageColorMap *color_map, bool interpolate,
                                       int *mask_colors, bool alpha_only=false,
                                       bool invert_alpha=false);
+    Inkscape::XML::Node *_createEncodedImage(Stream *str, GfxImageColorMap *color_map, bool interpolate);
+    Inkscape::XML::Node *_embedImage(std::vector<guchar> const &data, char const *mime_type, bool interpolate);
+    Inkscape::XML::Node *_createImageNode(std::string const &href, bool interpolate);
     Inkscape::XML::Node *_createMask(double width, double height);
     Inkscape::XML::Node *_createClip(const std::string &d, const Geom::Affine tr, bool even_odd);
 
+    // Sharing of identical resources
+    Inkscape::XML::Node *_internDef(Inkscape::XML::Node *node);
+    Inkscape::XML::Node *_internImage(Inkscape::XML::Node *image_node, std::string const &key);
+    bool _isSharedDef(Inkscape::XML::Node const *node) const;
+    void _forgetDef(Inkscape::XML::Node const *node);
+
     // Style setting
     SPCSSAttr *_setStyle(GfxState *state, bool fill, bool stroke, bool even_odd=false);
     void _setStrokeStyle(SPCSSAttr *css, GfxState *state);
@@ -256,6 +267,7 @@ private:
     Inkscape::XML::Node *_root;  // Root node from the point of view of this SvgBuilder
     Inkscape::XML::Node *_container; // Current container (group/pattern/mask)
     Inkscape::XML::Node *_preferences;  // Preferences container node
+    std::shared_ptr<SharedDefs> _shared_defs; // Resources interned by content, common to all sub-builders
     double _width;       // Document size in px
     double _height;       // Document size in px
 
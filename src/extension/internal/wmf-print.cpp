@@ -332,7 +332,7 @@ int PrintWmf::create_brush(SPStyle const *style, U_COLORREF *fcolor)
     U_WLOGBRUSH   lb;
     uint32_t      brush, fmode;
     MFDrawMode    fill_mode;
-    Inkscape::Pixbuf const *pixbuf;
+    std::shared_ptr<Inkscape::Pixbuf const> pixbuf;
     uint32_t      brushStyle;
     int           hatchType;
     U_COLORREF    hatchColor;
@@ -12,8 +12,11 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <list>
+#include <string>
+#include <vector>
 
 #include <glibmm/i18n.h>
 #include <sigc++/sigc++.h>
@@ -107,6 +110,27 @@ InxParameter *InxParameter::make(Inkscape::XML::Node *in_repr, Inkscape::Extensi
     return param;
 }
 
+bool InxParameter::can_make(Inkscape::XML::Node const *in_repr)
+{
+    // keep in sync with make() above and the constructor below
+    static const std::vector<std::string> types = {"bool", "boolean", "int", "float", "string", "path",
+                                                   "description", "notebook", "optiongroup", "enum", "color"};
+
+    const char *type = in_repr->attribute("type");
+    if (!type || std::find(types.begin(), types.end(), type) == types.end()) {
+        return false;
+    }
+
+    const char *name = in_repr->attribute("name");
+    if (!name || std::all_of(name, name + strlen(name), [](char c) { return g_ascii_isspace(c); })) {
+        return false;
+    }
+
+    bool const has_text = in_repr->attribute("gui-text") || in_repr->attribute("_gui-text") ||
+                          !strcmp(type, "description") || !strcmp(type, "notebook");
+    return has_text || !g_strcmp0(in_repr->attribute("gui-hidden"), "true");
+}
+
 bool InxParameter::get_bool() const
 {
     ParamBool const *boolpntr = dynamic_cast<ParamBool const *>(this);
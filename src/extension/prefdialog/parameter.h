@@ -93,6 +93,9 @@ public:
      */
     static InxParameter *make(Inkscape::XML::Node *in_repr, Inkscape::Extension::Extension *in_ext);
 
+    /** Checks whether make() would create a parameter from in_repr, without creating it */
+    static bool can_make(Inkscape::XML::Node const *in_repr);
+
     const char *get_tooltip() const override { return _description; }
 
     /**
@@ -68,6 +68,26 @@ InxWidget *InxWidget::make(Inkscape::XML::Node *in_repr, Inkscape::Extension::Ex
     return widget;
 }
 
+bool InxWidget::can_make(Inkscape::XML::Node const *in_repr)
+{
+    // keep in sync with make() above
+    const char *name = in_repr->name();
+    if (!name) {
+        return false;
+    }
+    if (!strncmp(name, INKSCAPE_EXTENSION_NS_NC, strlen(INKSCAPE_EXTENSION_NS_NC))) {
+        name += strlen(INKSCAPE_EXTENSION_NS);
+    }
+    if (name[0] == '_') {
+        name++;
+    }
+
+    if (!strcmp(name, "param")) {
+        return InxParameter::can_make(in_repr);
+    }
+    return is_valid_widget_name(name);
+}
+
 bool InxWidget::is_valid_widget_name(const char *name)
 {
     // keep in sync with names supported in InxWidget::make() above
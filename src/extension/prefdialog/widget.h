@@ -58,6 +58,9 @@ public:
     /** Checks if name is a valid widget name, i.e. a widget can be constructed from it using make() */
     static bool is_valid_widget_name(const char *name);
 
+    /** Checks whether make() would create a widget from in_repr, without creating it */
+    static bool can_make(Inkscape::XML::Node const *in_repr);
+
     /** Return the instance's GTK::Widget representation for usage in a GUI
       *
       * @param changeSignal Can be used to subscribe to parameter changes.
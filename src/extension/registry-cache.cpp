@@ -0,0 +1,298 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Cache of the parsed extension description (.inx) files.
+ */
+#include "registry-cache.h"
+
+#include <glibmm/checksum.h>
+#include <glibmm/fileutils.h>
+
+#include "extension.h"
+#include "inkscape-version.h"
+
+#include "io/cache-file.h"
+#include "io/resource.h"
+#include "xml/repr.h"
+#include "xml/simple-document.h"
+#include "xml/text-node.h"
+
+namespace Inkscape {
+namespace Extension {
+
+namespace {
+
+// Bump when the format changes.
+constexpr std::uint32_t FORMAT_VERSION = 2;
+constexpr char const *MAGIC = "inkscape-extension-registry";
+
+enum NodeTag : std::uint8_t
+{
+    TAG_ELEMENT,
+    TAG_TEXT,
+    TAG_CDATA,
+    TAG_COMMENT,
+    TAG_PI
+};
+
+void write_node(IO::CacheWriter &out, XML::Node const *node)
+{
+    switch (node->type()) {
+        case XML::NodeType::ELEMENT_NODE: {
+            out.u8(TAG_ELEMENT);
+            out.str(node->name());
+            auto const &attributes = node->attributeList();
+            out.u32(attributes.size());
+            for (auto const &attribute : attributes) {
+                out.str(g_quark_to_string(attribute.key));
+                out.str(attribute.value);
+            }
+            std::uint32_t count = 0;
+            for (auto child = node->firstChild(); child; child = child->next()) {
+                count++;
+            }
+            out.u32(count);
+            for (auto child = node->firstChild(); child; child = child->next()) {
+                write_node(out, child);
+            }
+            break;
+        }
+        case XML::NodeType::TEXT_NODE: {
+            auto const text = dynamic_cast<XML::TextNode const *>(node);
+            out.u8(text && text->is_CData() ? TAG_CDATA : TAG_TEXT);
+            out.str(node->content());
+            break;
+        }
+        case XML::NodeType::COMMENT_NODE:
+            out.u8(TAG_COMMENT);
+            out.str(node->content());
+            break;
+        case XML::NodeType::PI_NODE:
+            out.u8(TAG_PI);
+            out.str(node->name());
+            out.str(node->content());
+            break;
+        case XML::NodeType::DOCUMENT_NODE:
+            g_assert_not_reached();
+            break;
+    }
+}
+
+/// Returns a new node, or null if the data is corrupt.
+XML::Node *read_node(IO::CacheReader &in, XML::Document *doc)
+{
+    XML::Node *node = nullptr;
+
+    switch (in.u8()) {
+        case TAG_ELEMENT: {
+            node = doc->createElement(in.str().c_str());
+            for (auto n = in.u32(); n > 0 && in.ok(); n--) {
+                auto const key = in.str();
+                auto const value = in.str();
+                node->setAttribute(key, value);
+            }
+            for (auto n = in.u32(); n > 0 && in.ok(); n--) {
+                auto child = read_node(in, doc);
+                if (!child) {
+                    GC::release(node);
+                    return nullptr;
+                }
+                node->appendChild(child);
+                GC::release(child);
+            }
+            break;
+        }
+        case TAG_TEXT:
+            node = doc->createTextNode(in.str().c_str());
+            break;
+        case TAG_CDATA:
+            node = doc->createTextNode(in.str().c_str(), true);
+            break;
+        case TAG_COMMENT:
+            node = doc->createComment(in.str().c_str());
+            break;
+        case TAG_PI: {
+            auto const target = in.str();
+            node = doc->createPI(target.c_str(), in.str().c_str());
+            break;
+        }
+        default:
+            return nullptr;
+    }
+
+    if (!in.ok()) {
+        GC::release(node);
+        return nullptr;
+    }
+    return node;
+}
+
+std::string serialise(XML::Document const *doc)
+{
+    IO::CacheWriter out;
+    std::uint32_t count = 0;
+    for (auto child = doc->firstChild(); child; child = child->next()) {
+        count++;
+    }
+    out.u32(count);
+    for (auto child = doc->firstChild(); child; child = child->next()) {
+        write_node(out, child);
+    }
+    return std::move(out.data());
+}
+
+XML::Document *deserialise(std::string const &data)
+{
+    IO::CacheReader in(data);
+    auto doc = new XML::SimpleDocument();
+    for (auto n = in.u32(); n > 0 && in.ok(); n--) {
+        auto child = read_node(in, doc);
+        if (!child) {
+            GC::release(doc);
+            return nullptr;
+        }
+        doc->appendChild(child);
+        GC::release(child);
+    }
+    if (!in.ok() || !in.done() || !doc->root()) {
+        GC::release(doc);
+        return nullptr;
+    }
+    return doc;
+}
+
+/// The content hash of a file, or an empty string if it can't be read.
+std::string hash_file(std::string const &filename)
+{
+    try {
+        return Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA1, Glib::file_get_contents(filename));
+    } catch (Glib::FileError const &) {
+        return {};
+    }
+}
+
+} // namespace
+
+RegistryCache::RegistryCache(std::string path)
+    : _path(std::move(path))
+{
+    std::string data;
+    try {
+        data = Glib::file_get_contents(_path);
+    } catch (Glib::FileError const &) {
+        return; // None yet.
+    }
+
+    IO::CacheReader in(data);
+    if (in.str() != MAGIC || in.u32() != FORMAT_VERSION || in.str() != Inkscape::version_string) {
+        return; // Written by another version; will be replaced.
+    }
+
+    for (auto n = in.u32(); n > 0 && in.ok(); n--) {
+        auto filename = in.str();
+        Entry entry;
+        entry.stamp.mtime = in.i64();
+        entry.stamp.size = in.i64();
+        entry.hash = in.str();
+        entry.data = in.str();
+        _entries.emplace(std::move(filename), std::move(entry));
+    }
+
+    if (!in.ok() || !in.done()) {
+        g_warning("Ignoring damaged extension cache '%s'.", _path.c_str());
+        _entries.clear();
+    }
+}
+
+std::string RegistryCache::default_path()
+{
+    return IO::Resource::get_path_string(IO::Resource::CACHE, IO::Resource::NONE, "extensions.cache");
+}
+
+XML::Document *RegistryCache::read(std::string const &filename)
+{
+    auto const stamp = IO::get_file_stamp(filename);
+    if (!stamp) {
+        return nullptr;
+    }
+
+    auto &entry = _entries[filename];
+    entry.used = true;
+
+    std::string hash;
+    if (!entry.data.empty() && entry.stamp != *stamp) {
+        // It may just have been touched or copied over with the same content.
+        hash = hash_file(filename);
+        if (hash != entry.hash) {
+            entry.data.clear();
+        }
+        entry.stamp = *stamp;
+        _dirty = true;
+    }
+
+    if (!entry.data.empty()) {
+        if (auto doc = deserialise(entry.data)) {
+            return doc;
+        }
+    }
+
+    auto doc = sp_repr_read_file(filename.c_str(), INKSCAPE_EXTENSION_URI);
+    if (!doc) {
+        _entries.erase(filename);
+        return nullptr;
+    }
+
+    entry.stamp = *stamp;
+    entry.hash = hash.empty() ? hash_file(filename) : hash;
+    entry.data = serialise(doc);
+    _dirty = true;
+
+    return doc;
+}
+
+void RegistryCache::save()
+{
+    // Forget extensions that have been removed.
+    for (auto it = _entries.begin(); it != _entries.end(); ) {
+        if (it->second.used) {
+            ++it;
+        } else {
+            it = _entries.erase(it);
+            _dirty = true;
+        }
+    }
+
+    if (!_dirty) {
+        return;
+    }
+
+    IO::CacheWriter out;
+    out.str(MAGIC);
+    out.u32(FORMAT_VERSION);
+    out.str(Inkscape::version_string);
+    out.u32(_entries.size());
+    for (auto const &[filename, entry] : _entries) {
+        out.str(filename);
+        out.i64(entry.stamp.mtime);
+        out.i64(entry.stamp.size);
+        out.str(entry.hash);
+        out.str(entry.data);
+    }
+
+    if (IO::write_cache_file(_path, out.data(), "extension cache")) {
+        _dirty = false;
+    }
+}
+
+} // namespace Extension
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Cache of the parsed extension description (.inx) files.
+ *
+ * Reading and parsing hundreds of .inx files is a noticeable part of starting Inkscape. The
+ * parsed documents are kept in a single file in the user's cache directory instead, from which
+ * they can be rebuilt without going through the XML parser. An entry is used as long as the
+ * modification time and size of its .inx file are unchanged, or failing that, its content hash.
+ */
+#ifndef INKSCAPE_EXTENSION_REGISTRY_CACHE_H
+#define INKSCAPE_EXTENSION_REGISTRY_CACHE_H
+
+#include <string>
+#include <unordered_map>
+
+#include "io/cache-file.h"
+
+namespace Inkscape {
+
+namespace XML {
+class Document;
+} // namespace XML
+
+namespace Extension {
+
+class RegistryCache
+{
+public:
+    /// Load the cache written by an earlier run to \a path, if there is a usable one.
+    explicit RegistryCache(std::string path);
+    RegistryCache(RegistryCache const &) = delete;
+    RegistryCache &operator=(RegistryCache const &) = delete;
+
+    /**
+     * Read the .inx file \a filename, taking its parsed content from the cache if the file has
+     * not changed. Returns null if the file could not be read. The caller owns the result.
+     */
+    XML::Document *read(std::string const &filename);
+
+    /// Write the entries that were read since loading to the cache file, if anything changed.
+    void save();
+
+    /// The default location of the cache file.
+    static std::string default_path();
+
+private:
+    struct Entry
+    {
+        IO::FileStamp stamp;
+        std::string hash;
+        std::string data; ///< The parsed document, serialised.
+        bool used = false;
+    };
+
+    std::string _path;
+    std::unordered_map<std::string, Entry> _entries;
+    bool _dirty = false;
+};
+
+} // namespace Extension
+} // namespace Inkscape
+
+#endif // INKSCAPE_EXTENSION_REGISTRY_CACHE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -35,6 +35,7 @@
 #include "patheffect.h"
 #include "preferences.h"
 #include "print.h"
+#include "registry-cache.h"
 #include "template.h"
 #include "ui/interface.h"
 #include "xml/rebase-hrefs.h"
@@ -225,6 +226,9 @@ save(Extension *key, SPDocument *doc, gchar const *filename, bool check_overwrit
         throw Output::file_read_only();
     }
 
+    // Never save a partially loaded document.
+    doc->finishLoading();
+
     Inkscape::XML::Node *repr = doc->getReprRoot();
 
 
@@ -445,15 +449,16 @@ build_from_reprdoc(Inkscape::XML::Document *doc, Implementation::Implementation
  * \brief    This function creates a module from a filename of an
  *           XML description.
  * \param    filename  The file holding the XML description of the module.
+ * \param    cache     If given, where to take the parsed file from when it is unchanged.
  *
  * This function calls build_from_reprdoc with using sp_repr_read_file to create the reprdoc.
  */
 void
-build_from_file(gchar const *filename)
+build_from_file(gchar const *filename, RegistryCache *cache)
 {
     std::string dir = Glib::path_get_dirname(filename);
 
-    Inkscape::XML::Document *doc = sp_repr_read_file(filename, INKSCAPE_EXTENSION_URI);
+    Inkscape::XML::Document *doc = cache ? cache->read(filename) : sp_repr_read_file(filename, INKSCAPE_EXTENSION_URI);
     if (!doc) {
         g_critical("Inkscape::Extension::build_from_file() - XML description loaded from '%s' not valid.", filename);
         return;
@@ -25,6 +25,7 @@ namespace Inkscape {
 namespace Extension {
 class Extension;
 class Print;
+class RegistryCache;
 
 namespace Implementation {
 class Implementation;
@@ -50,7 +51,7 @@ void save(Extension *key, SPDocument *doc, gchar const *filename,
           bool check_overwrite, bool official,
           Inkscape::Extension::FileSaveMethod save_method);
 Print *get_print(gchar const *key);
-void build_from_file(gchar const *filename);
+void build_from_file(gchar const *filename, RegistryCache *cache = nullptr);
 void build_from_mem(gchar const *buffer, Implementation::Implementation *in_imp);
 
 /**
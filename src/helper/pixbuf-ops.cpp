@@ -25,7 +25,6 @@
 #include "object/sp-defs.h"
 #include "object/sp-use.h"
 #include "util/units.h"
-#include "util/scope_exit.h"
 #include "inkscape.h"
 
 /**
@@ -44,10 +43,18 @@ Inkscape::Pixbuf *sp_generate_internal_bitmap(SPDocument *document,
                                               bool opaque,
                                               uint32_t const *checkerboard_color,
                                               double device_scale)
+{
+    auto bitmap = InternalBitmapRender(document, area, dpi, items, opaque);
+    return bitmap.render(checkerboard_color, device_scale).release();
+}
+
+InternalBitmapRender::InternalBitmapRender(SPDocument *document, Geom::Rect const &area, double dpi,
+                                           std::vector<SPItem *> const &items, bool opaque)
+    : _document(document)
 {
     // Geometry
     if (area.hasZeroArea()) {
-        return nullptr;
+        return;
     }
 
     Geom::Point origin = area.min();
@@ -59,38 +66,51 @@ Inkscape::Pixbuf *sp_generate_internal_bitmap(SPDocument *document,
 
     // Document
     document->ensureUpToDate();
-    unsigned dkey = SPItem::display_key_new(1);
+    _dkey = SPItem::display_key_new(1);
 
     // Drawing
-    Inkscape::Drawing drawing; // New drawing for offscreen rendering.
-    drawing.setRoot(document->getRoot()->invoke_show(drawing, dkey, SP_ITEM_SHOW_DISPLAY));
-    auto invoke_hide_guard = scope_exit([&] { document->getRoot()->invoke_hide(dkey); });
-    drawing.root()->setTransform(affine);
-    drawing.setExact(); // Maximum quality for blurs.
+    _drawing = std::make_unique<Inkscape::Drawing>(); // New drawing for offscreen rendering.
+    _drawing->setRoot(document->getRoot()->invoke_show(*_drawing, _dkey, SP_ITEM_SHOW_DISPLAY));
+    _drawing->root()->setTransform(affine);
+    _drawing->setExact(); // Maximum quality for blurs.
 
     // Hide all items we don't want, instead of showing only requested items,
     // because that would not work if the shown item references something in defs.
     if (!items.empty()) {
-        document->getRoot()->invoke_hide_except(dkey, items);
+        document->getRoot()->invoke_hide_except(_dkey, items);
     }
 
-    auto final_area = Geom::IntRect::from_xywh(0, 0, width, height);
-    drawing.update(final_area);
+    _area = Geom::IntRect::from_xywh(0, 0, width, height);
+    _drawing->update(*_area);
 
     if (opaque) {
         // Required by sp_asbitmap_render().
         for (auto item : items) {
-            if (item->get_arenaitem(dkey)) {
-                item->get_arenaitem(dkey)->setOpacity(1.0);
+            if (item->get_arenaitem(_dkey)) {
+                item->get_arenaitem(_dkey)->setOpacity(1.0);
             }
         }
     }
+}
+
+InternalBitmapRender::~InternalBitmapRender()
+{
+    if (_drawing) {
+        _document->getRoot()->invoke_hide(_dkey);
+    }
+}
+
+std::unique_ptr<Inkscape::Pixbuf> InternalBitmapRender::render(uint32_t const *checkerboard_color, double device_scale) const
+{
+    if (!_area) {
+        return nullptr;
+    }
 
     // Rendering
-    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, _area->width(), _area->height());
 
     if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
-        long long size = (long long)height * (long long)cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
+        long long size = (long long)_area->height() * (long long)cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, _area->width());
         g_warning("sp_generate_internal_bitmap: not enough memory to create pixel buffer. Need %lld.", size);
         cairo_surface_destroy(surface);
         return nullptr;
@@ -110,13 +130,13 @@ Inkscape::Pixbuf *sp_generate_internal_bitmap(SPDocument *document,
     }
 
     // render items
-    drawing.render(dc, final_area, Inkscape::DrawingItem::RENDER_BYPASS_CACHE);
+    _drawing->render(dc, *_area, Inkscape::DrawingItem::RENDER_BYPASS_CACHE);
 
     if (device_scale != 1.0) {
         cairo_surface_set_device_scale(surface, device_scale, device_scale);
     }
 
-    return new Inkscape::Pixbuf(surface);
+    return std::make_unique<Inkscape::Pixbuf>(surface);
 }
 
 /*
@@ -13,13 +13,48 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <memory>
 #include <vector>
 #include <cstdint>
 #include <2geom/forward.h>
+#include <2geom/rect.h>
 
 class SPDocument;
 class SPItem;
-namespace Inkscape { class Pixbuf; }
+namespace Inkscape {
+class Drawing;
+class Pixbuf;
+} // namespace Inkscape
+
+/**
+ * Offscreen rendering of a document area, split up so that the pixels can be rendered on another
+ * thread. Construction and destruction show and hide the items, so they must happen on the main
+ * thread; render() may run on any thread, as long as the document is not changed meanwhile.
+ * Several instances may render concurrently.
+ */
+class InternalBitmapRender
+{
+public:
+    /// See sp_generate_internal_bitmap() for the parameters.
+    InternalBitmapRender(SPDocument *document, Geom::Rect const &area, double dpi,
+                         std::vector<SPItem *> const &items = {}, bool set_opaque = false);
+    ~InternalBitmapRender();
+    InternalBitmapRender(InternalBitmapRender const &) = delete;
+    InternalBitmapRender &operator=(InternalBitmapRender const &) = delete;
+
+    /// The size of the bitmap in pixels, or empty if there is nothing to render.
+    Geom::OptIntRect area() const { return _area; }
+
+    /// Render the bitmap. Returns null if the area is empty or the pixels could not be allocated.
+    std::unique_ptr<Inkscape::Pixbuf> render(uint32_t const *checkerboard_color = nullptr,
+                                             double device_scale = 1.0) const;
+
+private:
+    SPDocument *_document;
+    unsigned _dkey = 0;
+    std::unique_ptr<Inkscape::Drawing> _drawing;
+    Geom::OptIntRect _area;
+};
 
 Inkscape::Pixbuf *sp_generate_internal_bitmap(SPDocument *document,
                                               Geom::Rect const &area,
@@ -27,14 +27,16 @@ bool save_image(const std::string& fname, const Inkscape::Pixbuf* pixbuf) {
 }
 
 bool extract_image(Gtk::Window* parent, SPImage* image) {
-    if (!image || !image->pixbuf || !parent) return false;
+    if (!image || !parent) return false;
+    auto pixbuf = image->getPixbuf();
+    if (!pixbuf) return false;
 
     std::string current_dir;
     auto fname = choose_file_save(_("Extract Image"), parent, "image/png", "image.png", current_dir);
     if (fname.empty()) return false;
 
     // save image
-    return save_image(fname, image->pixbuf.get());
+    return save_image(fname, pixbuf.get());
 }
 
 } // namespace Inkscape
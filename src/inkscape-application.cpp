@@ -61,15 +61,19 @@
 #include "desktop.h"                // Access to window
 #include "file.h"                   // sp_file_convert_dpi
 #include "inkscape.h"               // Inkscape::Application
+#include "message-stack.h"          // Progress of opening large files
 #include "path-prefix.h"            // Data directory
 
 #include "include/glibmm_version.h"
 
+#include "async/progress.h"         // Progress of opening large files
 #include "inkgc/gc-core.h"          // Garbage Collecting init
 #include "debug/logger.h"           // INKSCAPE_DEBUG_LOG support
+#include "debug/startup-report.h"   // INKSCAPE_STARTUP_REPORT support
 
 #include "extension/init.h"
 
+#include "io/action-server.h"       // Server mode
 #include "io/file.h"                // File open (command line).
 #include "io/resource.h"            // TEMPLATE
 #include "io/fix-broken-links.h"    // Fix up references.
@@ -176,11 +180,27 @@ InkscapeApplication::document_new(const std::string &Template)
 
 
 // Open a document, add it to app.
+// If progressive is set, large files are shown before they are fully built (see progressive_open_step).
 SPDocument*
-InkscapeApplication::document_open(const Glib::RefPtr<Gio::File>& file, bool *cancelled)
+InkscapeApplication::document_open(const Glib::RefPtr<Gio::File>& file, bool *cancelled, bool progressive)
 {
+    SPDocument *document = nullptr;
+    std::unique_ptr<Inkscape::IO::ProgressiveOpen> progressive_open;
+
+    if (progressive && Inkscape::IO::ProgressiveOpen::wanted(file)) {
+        progressive_open = Inkscape::IO::ProgressiveOpen::create(file->get_path());
+        if (progressive_open) {
+            document = progressive_open->document();
+            if (cancelled) {
+                *cancelled = false;
+            }
+        }
+    }
+
     // Open file
-    SPDocument *document = ink_file_open(file, cancelled);
+    if (!document) {
+        document = _document_cache ? _document_cache->open(file, cancelled).release() : ink_file_open(file, cancelled);
+    }
 
     if (document) {
         document->setVirgin(false); // Prevents replacing document in same window during file open.
@@ -212,6 +232,11 @@ InkscapeApplication::document_open(const Glib::RefPtr<Gio::File>& file, bool *ca
         }
 
         document_add (document);
+
+        if (progressive_open && progressive_open->pending()) {
+            _progressive_opens.emplace(document, std::move(progressive_open));
+            Glib::signal_idle().connect([this, document] { return progressive_open_step(document); });
+        }
     } else if (cancelled == nullptr || !(*cancelled)) {
         std::cerr << "InkscapeApplication::document_open: Failed to open: " << file->get_parse_name().raw() << std::endl;
     }
@@ -354,6 +379,9 @@ InkscapeApplication::document_close(SPDocument* document)
 {
     if (document) {
 
+        // Stop adding content to a document that is still being opened.
+        _progressive_opens.erase(document);
+
         auto it = _documents.find(document);
         if (it != _documents.end()) {
             if (it->second.size() != 0) {
@@ -424,6 +452,63 @@ InkscapeApplication::document_fix(InkscapeWindow* window)
     }
 }
 
+/** Add the next batch of content to a document opened with document_open(file, ..., true).
+ *  Runs from an idle callback, so the parts that are ready are drawn in between. Loading is
+ *  cancelled by closing the document.
+ */
+bool
+InkscapeApplication::progressive_open_step(SPDocument* document)
+{
+    auto it = _progressive_opens.find(document);
+    if (it == _progressive_opens.end()) {
+        return false; // Already closed.
+    }
+
+    // Show the progress in the status bar of each window showing the document.
+    class StatusBarProgress final : public Inkscape::Async::Progress<double>
+    {
+    public:
+        StatusBarProgress(std::vector<InkscapeWindow*> const &windows) : windows(&windows) {}
+
+    private:
+        std::vector<InkscapeWindow*> const *windows;
+
+        bool _keepgoing() const override { return !windows->empty(); }
+
+        bool _report(double const &progress) override
+        {
+            for (auto window : *windows) {
+                if (auto desktop = window->get_desktop()) {
+                    desktop->messageStack()->flashF(Inkscape::NORMAL_MESSAGE, _("Loading document: %d%%"), (int)(progress * 100));
+                }
+            }
+            return _keepgoing();
+        }
+    };
+
+    auto progress = StatusBarProgress(_documents[document]);
+
+    bool more = false;
+    try {
+        more = it->second->step(progress);
+    } catch (Inkscape::Async::CancelledException const &) {
+        // No window shows the document any more, but it is still open: add the rest at once
+        // rather than leave it half-loaded.
+        it->second->finish();
+        _progressive_opens.erase(it);
+        return false;
+    }
+
+    if (!more) {
+        _progressive_opens.erase(it);
+        if (auto const &windows = _documents[document]; !windows.empty()) {
+            document_fix(windows.front());
+        }
+    }
+
+    return more;
+}
+
 /** Get a list of open documents (from document map).
  */
 std::vector<SPDocument*>
@@ -796,6 +881,7 @@ InkscapeApplication::InkscapeApplication()
     gapp->add_main_option_entry(T::OPTION_TYPE_BOOL,     "batch-process",         '\0', N_("Close GUI after executing all actions"),                                    "");
     _start_main_option_section();
     gapp->add_main_option_entry(T::OPTION_TYPE_BOOL,     "shell",                 '\0', N_("Start Inkscape in interactive shell mode"),                                 "");
+    gapp->add_main_option_entry(T::OPTION_TYPE_FILENAME, "server",                '\0', N_("Serve action lists on a local socket, one per line, until sent 'quit'"), N_("SOCKET"));
     gapp->add_main_option_entry(T::OPTION_TYPE_BOOL,     "active-window",          'q', N_("Use active window from commandline"),                                       "");
     // clang-format on
 
@@ -865,7 +951,7 @@ InkscapeApplication::create_window(const Glib::RefPtr<Gio::File>& file)
 
     if (file) {
         startup_close();
-        document = document_open(file, &cancelled);
+        document = document_open(file, &cancelled, true);
         if (document) {
             // Remember document so much that we'll add it to recent documents
             auto recentmanager = Gtk::RecentManager::get_default();
@@ -875,7 +961,9 @@ InkscapeApplication::create_window(const Glib::RefPtr<Gio::File>& file)
             bool replace = old_document && old_document->getVirgin();
 
             window = create_window (document, replace);
-            document_fix(window);
+            if (!document->isLoading()) {
+                document_fix(window); // Otherwise done once loaded.
+            }
         } else if (!cancelled) {
             std::cerr << "ConcreteInkscapeApplication<T>::create_window: Failed to load: "
                       << file->get_parse_name().raw() << std::endl;
@@ -1015,6 +1103,9 @@ InkscapeApplication::process_document(SPDocument* document, std::string output_p
     if (_use_shell) {
         shell();
     }
+    if (!_server_socket.empty()) {
+        server();
+    }
     if (_with_gui && _active_window) {
         document_fix(_active_window);
     }
@@ -1054,6 +1145,7 @@ InkscapeApplication::on_startup()
 
     // Deprecated...
     Inkscape::Application::create(_with_gui);
+    Inkscape::Debug::startup_phase("application");
 
     // Extensions
     Inkscape::Extension::init();
@@ -1062,6 +1154,7 @@ InkscapeApplication::on_startup()
     parse_actions(_command_line_actions_input, _command_line_actions);
 
     if (!_with_gui) {
+        Inkscape::Debug::startup_report();
         return;
     }
 
@@ -1077,6 +1170,8 @@ InkscapeApplication::on_startup()
     // build_menu(); // Builds and adds menu to app. Used by all Inkscape windows. This can be done
                      // before all actions defined. * For the moment done by each window so we can add
                      // window action info to menu_label_to_tooltip map.
+
+    Inkscape::Debug::startup_report();
 }
 
 // Open document window with default document or pipe. Either this or on_open() is called.
@@ -1409,6 +1504,50 @@ InkscapeApplication::shell(bool active_window)
     }
 }
 
+// Serve action lists from other processes, see Inkscape::IO::ActionServer.
+void
+InkscapeApplication::server()
+{
+    auto prefs = Inkscape::Preferences::get();
+    _document_cache = std::make_unique<Inkscape::IO::DocumentCache>(prefs->getIntLimited("/options/server/cachesize", 16, 0, 1000));
+
+    // Every request starts out with the document and export settings the server was started with.
+    auto base_document = _active_document;
+    auto base_selection = _active_selection;
+    auto const base_export = _file_export;
+
+    auto handler = [&] (std::string const &request) {
+        auto const before = get_documents();
+
+        action_vector_t action_vector;
+        parse_actions(std::regex_replace(request, std::regex(" +$"), ""), action_vector);
+        for (auto const &[name, param] : action_vector) {
+            _gio_application->activate_action(name, param);
+        }
+
+        // Close whatever the request opened and did not close itself.
+        auto const after = get_documents();
+        for (auto document : after) {
+            if (std::find(before.begin(), before.end(), document) == before.end()) {
+                INKSCAPE.remove_document(document);
+                document_close(document);
+            }
+        }
+        if (std::find(after.begin(), after.end(), base_document) == after.end()) {
+            base_document = nullptr;
+            base_selection = nullptr;
+        }
+        _active_document = base_document;
+        _active_selection = base_selection;
+        _active_view = nullptr;
+        _file_export = base_export;
+    };
+
+    Inkscape::IO::ActionServer(_server_socket, handler).run();
+
+    _document_cache.reset();
+}
+
 // Todo: Code can be improved by using proper IPC rather than temporary file polling.
 void InkscapeApplication::redirect_output()
 {
@@ -1577,7 +1716,8 @@ InkscapeApplication::on_handle_local_options(const Glib::RefPtr<Glib::VariantDic
         options->contains("action-list")           ||
         options->contains("actions")               ||
         options->contains("actions-file")          ||
-        options->contains("shell")
+        options->contains("shell")                 ||
+        options->contains("server")
         ) {
         _with_gui = false;
     }
@@ -1593,6 +1733,9 @@ InkscapeApplication::on_handle_local_options(const Glib::RefPtr<Glib::VariantDic
     if (options->contains("batch-process"))  _batch_process = true;
     if (options->contains("shell"))          _use_shell = true;
     if (options->contains("pipe"))           _use_pipe  = true;
+    if (options->contains("server")) {
+        options->lookup_value("server", _server_socket);
+    }
 
     // Enable auto-export
     if (options->contains("export-filename")  ||
@@ -29,6 +29,8 @@
 #include "actions/actions-extra-data.h"
 #include "actions/actions-hint-data.h"
 #include "io/file-export-cmd.h"   // File export (non-verb)
+#include "io/progressive-open.h"  // Opening large files in stages
+#include "io/document-cache.h"    // Reusing parsed documents in server mode
 #include "extension/internal/pdfinput/enums.h"
 
 typedef std::vector<std::pair<std::string, Glib::VariantBase> > action_vector_t;
@@ -94,7 +96,8 @@ public:
     void                  document_add(SPDocument* document);
 
     SPDocument*           document_new(const std::string &Template = "");
-    SPDocument*           document_open(const Glib::RefPtr<Gio::File>& file, bool *cancelled = nullptr);
+    SPDocument*           document_open(const Glib::RefPtr<Gio::File>& file, bool *cancelled = nullptr,
+                                        bool progressive = false);
     SPDocument*           document_open(const std::string& data);
     bool                  document_swap(InkscapeWindow* window, SPDocument* document);
     bool                  document_revert(SPDocument* document);
@@ -138,6 +141,7 @@ protected:
     bool _batch_process = false; // Temp
     bool _use_shell   = false;
     bool _use_pipe    = false;
+    std::string _server_socket; // Serve actions on this socket, if set.
     bool _auto_export = false;
     int _pdf_poppler  = false;
     FontStrategy _pdf_font_strategy = FontStrategy::RENDER_MISSING;
@@ -148,6 +152,13 @@ protected:
     // std::vector<SPDocument*> _documents;   For a true headless version
     std::map<SPDocument*, std::vector<InkscapeWindow*> > _documents;
 
+    // Documents whose content is still being added after opening (see document_open).
+    std::map<SPDocument*, std::unique_ptr<Inkscape::IO::ProgressiveOpen>> _progressive_opens;
+    bool progressive_open_step(SPDocument* document);
+
+    // Recently opened documents, kept parsed in server mode (see document_open).
+    std::unique_ptr<Inkscape::IO::DocumentCache> _document_cache;
+
     // We keep track of these things so we don't need a window to find them (for headless operation).
     SPDocument*               _active_document   = nullptr;
     Inkscape::Selection*      _active_selection  = nullptr;
@@ -179,6 +190,7 @@ protected:
     void on_about();
     void redirect_output();
     void shell(bool active_window = false);
+    void server();
 
     void _start_main_option_section(const Glib::ustring& section_name = "");
 };
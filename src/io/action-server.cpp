@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Serve action lists over a local socket.
+ */
+#include "io/action-server.h"
+
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glibmm/main.h>
+
+#ifdef G_OS_UNIX
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glib-unix.h>
+#include <giomm/datainputstream.h>
+#include <giomm/socketservice.h>
+#include <giomm/unixsocketaddress.h>
+#endif
+
+#include "util/scope_exit.h"
+
+namespace Inkscape {
+namespace IO {
+
+namespace {
+
+#ifdef G_OS_UNIX
+
+using ServeFunc = std::function<bool(std::string const &request, std::string &reply)>;
+
+void close_quietly(Glib::RefPtr<Gio::SocketConnection> const &connection)
+{
+    try {
+        connection->close();
+    } catch (Glib::Error const &) {
+    }
+}
+
+/**
+ * Answer the requests on a connection one after the other, until the client hangs up or the
+ * server quits.
+ */
+void read_requests(Glib::RefPtr<Gio::SocketConnection> const &connection,
+                   Glib::RefPtr<Gio::DataInputStream> const &in, ServeFunc const &serve)
+{
+    in->read_line_async([=] (Glib::RefPtr<Gio::AsyncResult> &result) {
+        std::string request;
+        bool got = false;
+        try {
+            got = in->read_line_finish(result, request);
+        } catch (Glib::Error const &) {
+        }
+        if (!got) {
+            close_quietly(connection);
+            return;
+        }
+
+        if (!request.empty() && request.back() == '\r') {
+            request.pop_back();
+        }
+
+        std::string reply;
+        if (!serve(request, reply)) {
+            close_quietly(connection);
+            return;
+        }
+
+        try {
+            gsize written = 0;
+            connection->get_output_stream()->write_all(reply, written);
+        } catch (Glib::Error const &) {
+            close_quietly(connection);
+            return;
+        }
+
+        read_requests(connection, in, serve);
+    });
+}
+
+/**
+ * Remove a socket left behind by a server that did not shut down cleanly. Anything else at
+ * \a path, or a socket of another user, is left alone and reported.
+ */
+bool remove_stale_socket(std::string const &path)
+{
+    GStatBuf st;
+    if (g_lstat(path.c_str(), &st) != 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        std::cerr << "ActionServer::run: cannot check '" << path << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (!S_ISSOCK(st.st_mode) || st.st_uid != getuid()) {
+        std::cerr << "ActionServer::run: '" << path << "' exists and is not a socket of this user" << std::endl;
+        return false;
+    }
+    if (g_unlink(path.c_str()) != 0) {
+        std::cerr << "ActionServer::run: cannot remove '" << path << "': " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+gboolean quit_loop(gpointer loop)
+{
+    g_main_loop_quit(static_cast<GMainLoop *>(loop));
+    return G_SOURCE_REMOVE;
+}
+
+#endif // G_OS_UNIX
+
+} // namespace
+
+ActionServer::ActionServer(std::string socket_path, Handler handler)
+    : _socket_path(std::move(socket_path))
+    , _handler(std::move(handler))
+{
+}
+
+bool ActionServer::run()
+{
+#ifdef G_OS_UNIX
+    if (!remove_stale_socket(_socket_path)) {
+        return false;
+    }
+
+    auto service = Gio::SocketService::create();
+    try {
+        // Whoever can connect can run actions as this user, so only they may; the socket is
+        // created with mode 0600 rather than changed after the fact.
+        auto const old_mask = umask(0177);
+        auto mask_guard = scope_exit([=] {
+            umask(old_mask);
+        });
+        Glib::RefPtr<Gio::SocketAddress> effective;
+        service->add_address(Gio::UnixSocketAddress::create(_socket_path), Gio::SOCKET_TYPE_STREAM,
+                             Gio::SOCKET_PROTOCOL_DEFAULT, effective);
+    } catch (Glib::Error const &error) {
+        std::cerr << "ActionServer::run: cannot listen on '" << _socket_path << "': " << error.what() << std::endl;
+        return false;
+    }
+    auto unlink_guard = scope_exit([&] {
+        g_unlink(_socket_path.c_str());
+    });
+
+    auto loop = Glib::MainLoop::create();
+
+    // Connections may outlive the server; they are turned away once it has stopped.
+    auto running = std::make_shared<bool>(true);
+    auto serve = ServeFunc([this, loop, running] (std::string const &request, std::string &reply) {
+        if (!*running) {
+            return false;
+        }
+        if (request == "quit" || request == "q") {
+            loop->quit();
+            return false;
+        }
+        reply = _serve(request);
+        return true;
+    });
+
+    service->signal_incoming().connect([&serve] (Glib::RefPtr<Gio::SocketConnection> const &connection,
+                                                 Glib::RefPtr<Glib::Object> const &) {
+        read_requests(connection, Gio::DataInputStream::create(connection->get_input_stream()), serve);
+        return true;
+    });
+
+    auto const sigint = g_unix_signal_add(SIGINT, &quit_loop, loop->gobj());
+    auto const sigterm = g_unix_signal_add(SIGTERM, &quit_loop, loop->gobj());
+
+    std::cout << "Inkscape server listening on '" << _socket_path << "'. Send 'quit' to stop." << std::endl;
+    service->start();
+    loop->run();
+    *running = false;
+    service->stop();
+    service->close();
+
+    // The handlers remove themselves once they have run.
+    if (auto source = g_main_context_find_source_by_id(nullptr, sigint)) {
+        g_source_destroy(source);
+    }
+    if (auto source = g_main_context_find_source_by_id(nullptr, sigterm)) {
+        g_source_destroy(source);
+    }
+
+    return true;
+#else
+    std::cerr << "ActionServer::run: not supported on this platform" << std::endl;
+    return false;
+#endif
+}
+
+/**
+ * Run one request, returning everything it printed followed by the time it took.
+ */
+std::string ActionServer::_serve(std::string const &request)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    std::ostringstream out;
+    {
+        auto const cout = std::cout.rdbuf(out.rdbuf());
+        auto const cerr = std::cerr.rdbuf(out.rdbuf());
+        auto restore_guard = scope_exit([&] {
+            std::cout.rdbuf(cout);
+            std::cerr.rdbuf(cerr);
+        });
+
+        try {
+            _handler(request);
+        } catch (std::exception const &e) {
+            std::cerr << "ActionServer: " << e.what() << std::endl;
+        } catch (Glib::Error const &e) {
+            std::cerr << "ActionServer: " << e.what() << std::endl;
+        }
+    }
+
+    std::ostringstream elapsed;
+    elapsed << std::fixed << std::setprecision(3)
+            << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    _requests++;
+    std::cout << "Request " << _requests << ": " << elapsed.str() << " ms" << std::endl;
+
+    auto reply = out.str();
+    if (!reply.empty() && reply.back() != '\n') {
+        reply += '\n';
+    }
+    return reply + "%% " + elapsed.str() + "\n";
+}
+
+} // namespace IO
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
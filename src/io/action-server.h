@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Serve action lists over a local socket.
+ *
+ * Clients connect to a Unix domain socket and send one action list per line, in the same form
+ * as for --actions or the interactive shell. Every request is answered with the output of its
+ * actions, followed by a line of the form "%% <milliseconds>" giving the time spent on it. The
+ * request "quit" stops the server.
+ */
+#ifndef INKSCAPE_IO_ACTION_SERVER_H
+#define INKSCAPE_IO_ACTION_SERVER_H
+
+#include <functional>
+#include <string>
+
+namespace Inkscape {
+namespace IO {
+
+class ActionServer
+{
+public:
+    /// Runs the actions of one request. Anything written to std::cout or std::cerr is the reply.
+    using Handler = std::function<void(std::string const &request)>;
+
+    ActionServer(std::string socket_path, Handler handler);
+    ActionServer(ActionServer const &) = delete;
+    ActionServer &operator=(ActionServer const &) = delete;
+
+    /**
+     * Serve requests until asked to quit or interrupted. Connections are served concurrently,
+     * but requests run one at a time on the main loop. The socket is only accessible to the
+     * current user. Returns false if the socket could not be set up, including when something
+     * other than a stale socket of this user is in its place.
+     */
+    bool run();
+
+private:
+    std::string _socket_path;
+    Handler _handler;
+    unsigned _requests = 0;
+
+    std::string _serve(std::string const &request);
+};
+
+} // namespace IO
+} // namespace Inkscape
+
+#endif // INKSCAPE_IO_ACTION_SERVER_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
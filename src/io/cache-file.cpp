@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Reading and writing the binary cache files kept between runs.
+ */
+#include "io/cache-file.h"
+
+#include <cstring>
+#include <giomm/file.h>
+#include <giomm/fileinfo.h>
+#include <glib/gstdio.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+namespace Inkscape {
+namespace IO {
+
+void CacheWriter::u32(std::uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        u8(value >> (8 * i));
+    }
+}
+
+void CacheWriter::i64(std::int64_t value)
+{
+    auto const bits = static_cast<std::uint64_t>(value);
+    u32(bits);
+    u32(bits >> 32);
+}
+
+void CacheWriter::str(char const *value)
+{
+    auto const length = value ? std::strlen(value) : 0;
+    u32(length);
+    _data.append(value ? value : "", length);
+}
+
+void CacheWriter::str(std::string const &value)
+{
+    u32(value.size());
+    _data.append(value);
+}
+
+std::uint8_t CacheReader::u8()
+{
+    if (!_need(1)) {
+        return 0;
+    }
+    return static_cast<std::uint8_t>(_data[_pos++]);
+}
+
+std::uint32_t CacheReader::u32()
+{
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<std::uint32_t>(u8()) << (8 * i);
+    }
+    return value;
+}
+
+std::int64_t CacheReader::i64()
+{
+    std::uint64_t low = u32();
+    std::uint64_t high = u32();
+    return static_cast<std::int64_t>(low | high << 32);
+}
+
+std::string CacheReader::str()
+{
+    auto const length = u32();
+    if (!_need(length)) {
+        return {};
+    }
+    auto value = _data.substr(_pos, length);
+    _pos += length;
+    return value;
+}
+
+bool CacheReader::_need(std::size_t bytes)
+{
+    _ok = _ok && _data.size() - _pos >= bytes;
+    return _ok;
+}
+
+bool write_cache_file(std::string const &path, std::string const &data, char const *what)
+{
+    g_mkdir_with_parents(Glib::path_get_dirname(path).c_str(), 0755);
+    try {
+        // Writes a temporary file and renames it over the old one.
+        Glib::file_set_contents(path, data);
+        return true;
+    } catch (Glib::FileError const &error) {
+        g_warning("Could not write %s '%s': %s", what, path.c_str(), error.what().c_str());
+        return false;
+    }
+}
+
+std::optional<FileStamp> get_file_stamp(std::string const &path)
+{
+    try {
+        auto const info = Gio::File::create_for_path(path)->query_info(
+            G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC "," G_FILE_ATTRIBUTE_STANDARD_SIZE);
+        if (!info->has_attribute(G_FILE_ATTRIBUTE_TIME_MODIFIED)) {
+            return {};
+        }
+        FileStamp stamp;
+        stamp.mtime = static_cast<std::int64_t>(info->get_attribute_uint64(G_FILE_ATTRIBUTE_TIME_MODIFIED)) * 1000000 +
+                      info->get_attribute_uint32(G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+        stamp.size = info->get_size();
+        return stamp;
+    } catch (Glib::Error const &) {
+        return {};
+    }
+}
+
+} // namespace IO
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Reading and writing the binary cache files kept between runs, such as those of the extension
+ * registry and the font catalogue.
+ */
+#ifndef INKSCAPE_IO_CACHE_FILE_H
+#define INKSCAPE_IO_CACHE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Inkscape {
+namespace IO {
+
+/// Builds the content of a cache file from little-endian numbers and length-prefixed strings.
+class CacheWriter
+{
+public:
+    void u8(std::uint8_t value) { _data.push_back(static_cast<char>(value)); }
+    void u32(std::uint32_t value);
+    void i64(std::int64_t value);
+    void str(char const *value);
+    void str(std::string const &value);
+
+    std::string &data() { return _data; }
+
+private:
+    std::string _data;
+};
+
+/// Reads what CacheWriter wrote. Once anything is out of bounds, returns zeroes and is no longer ok().
+class CacheReader
+{
+public:
+    explicit CacheReader(std::string const &data) : _data(data) {}
+
+    bool ok() const { return _ok; }
+    bool done() const { return _pos == _data.size(); }
+
+    std::uint8_t u8();
+    std::uint32_t u32();
+    std::int64_t i64();
+    std::string str();
+
+private:
+    std::string const &_data;
+    std::size_t _pos = 0;
+    bool _ok = true;
+
+    bool _need(std::size_t bytes);
+};
+
+/**
+ * Replace the file at \a path with \a data, creating its directory if needed. Readers see either
+ * the old or the new content, never part of it. On failure, warns about the \a what that could
+ * not be written and returns false.
+ */
+bool write_cache_file(std::string const &path, std::string const &data, char const *what);
+
+/// What tells whether a file has changed: its modification time in microseconds and its size.
+struct FileStamp
+{
+    std::int64_t mtime = 0;
+    std::int64_t size = 0;
+
+    bool operator==(FileStamp const &other) const { return mtime == other.mtime && size == other.size; }
+    bool operator!=(FileStamp const &other) const { return !(*this == other); }
+};
+
+/// The stamp of the file at \a path, or nothing if there is no such file.
+std::optional<FileStamp> get_file_stamp(std::string const &path);
+
+} // namespace IO
+} // namespace Inkscape
+
+#endif // INKSCAPE_IO_CACHE_FILE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
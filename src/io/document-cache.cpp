@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Keep recently opened documents parsed, for processes that open the same files again and again.
+ */
+#include "io/document-cache.h"
+
+#include <algorithm>
+#include <giomm/file.h>
+
+#include "document.h"
+
+#include "io/cache-file.h"
+#include "io/file.h"
+#include "object/sp-root.h"
+#include "xml/simple-document.h"
+
+namespace Inkscape {
+namespace IO {
+
+namespace {
+
+XML::Document *duplicate(XML::Document const *rdoc)
+{
+    auto copy = new XML::SimpleDocument();
+    for (auto child = rdoc->firstChild(); child; child = child->next()) {
+        auto new_child = child->duplicate(copy);
+        copy->appendChild(new_child);
+        GC::release(new_child);
+    }
+    return copy;
+}
+
+char const *c_str_or_null(std::string const &s)
+{
+    return s.empty() ? nullptr : s.c_str();
+}
+
+} // namespace
+
+DocumentCache::DocumentCache(std::size_t capacity)
+    : _capacity(capacity)
+{
+}
+
+DocumentCache::~DocumentCache()
+{
+    clear();
+}
+
+void DocumentCache::clear()
+{
+    for (auto &entry : _lru) {
+        GC::release(entry.rdoc);
+    }
+    _lru.clear();
+}
+
+std::unique_ptr<SPDocument> DocumentCache::open(Glib::RefPtr<Gio::File> const &file, bool *cancelled, bool *hit)
+{
+    if (hit) {
+        *hit = false;
+    }
+
+    auto const path = file->get_path();
+    auto const stamp = path.empty() ? std::nullopt : get_file_stamp(path);
+    if (!stamp) {
+        // Not a local file, or not there: nothing to check a cached copy against.
+        return std::unique_ptr<SPDocument>(ink_file_open(file, cancelled));
+    }
+
+    auto it = std::find_if(_lru.begin(), _lru.end(), [&] (Entry const &entry) { return entry.path == path; });
+    if (it != _lru.end() && it->stamp != *stamp) {
+        GC::release(it->rdoc);
+        _lru.erase(it);
+        it = _lru.end();
+    }
+
+    if (it != _lru.end()) {
+        _lru.splice(_lru.begin(), _lru, it);
+        auto doc = std::unique_ptr<SPDocument>(SPDocument::createDoc(duplicate(it->rdoc), c_str_or_null(it->filename),
+                                                                     c_str_or_null(it->base), c_str_or_null(it->name),
+                                                                     true, nullptr));
+        // As in ink_file_open().
+        auto root = doc->getRoot();
+        root->original.inkscape = root->version.inkscape;
+        root->original.svg      = root->version.svg;
+        if (cancelled) {
+            *cancelled = false;
+        }
+        if (hit) {
+            *hit = true;
+        }
+        return doc;
+    }
+
+    auto doc = std::unique_ptr<SPDocument>(ink_file_open(file, cancelled));
+    if (!doc || _capacity == 0) {
+        return doc;
+    }
+
+    // Copy the XML before the caller gets to change it.
+    auto filename = doc->getDocumentFilename();
+    auto base = doc->getDocumentBase();
+    auto name = doc->getDocumentName();
+    _lru.push_front({ path, *stamp, duplicate(doc->getReprDoc()), filename ? filename : "", base ? base : "", name ? name : "" });
+
+    while (_lru.size() > _capacity) {
+        GC::release(_lru.back().rdoc);
+        _lru.pop_back();
+    }
+
+    return doc;
+}
+
+} // namespace IO
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Keep recently opened documents parsed, for processes that open the same files again and again.
+ */
+#ifndef INKSCAPE_IO_DOCUMENT_CACHE_H
+#define INKSCAPE_IO_DOCUMENT_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "io/cache-file.h"
+
+namespace Gio {
+class File;
+} // namespace Gio
+
+namespace Glib {
+template <class T>
+class RefPtr;
+} // namespace Glib
+
+class SPDocument;
+
+namespace Inkscape {
+
+namespace XML {
+class Document;
+} // namespace XML
+
+namespace IO {
+
+/**
+ * A least-recently-used cache of the XML of opened files, keyed by path and invalidated when the
+ * file's modification time or size changes. Every document handed out is built from its own copy
+ * of the XML, so it can be modified freely.
+ */
+class DocumentCache
+{
+public:
+    explicit DocumentCache(std::size_t capacity);
+    DocumentCache(DocumentCache const &) = delete;
+    DocumentCache &operator=(DocumentCache const &) = delete;
+    ~DocumentCache();
+
+    /**
+     * Open \a file, reusing its XML if it was opened before and has not changed since, and
+     * parsing it otherwise. Returns null if the file could not be opened; as ink_file_open(),
+     * sets \a cancelled, if given, to whether the user cancelled. Sets \a hit, if given, to
+     * whether the cache was used.
+     */
+    std::unique_ptr<SPDocument> open(Glib::RefPtr<Gio::File> const &file, bool *cancelled = nullptr,
+                                     bool *hit = nullptr);
+
+    std::size_t size() const { return _lru.size(); }
+    void clear();
+
+private:
+    struct Entry
+    {
+        std::string path;
+        FileStamp stamp;
+        XML::Document *rdoc; ///< Owned.
+        std::string filename, base, name; ///< Empty for none.
+    };
+
+    std::size_t _capacity;
+    std::list<Entry> _lru; ///< Most recently used first.
+};
+
+} // namespace IO
+} // namespace Inkscape
+
+#endif // INKSCAPE_IO_DOCUMENT_CACHE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Open large SVG documents in stages.
+ */
+#include "io/progressive-open.h"
+
+#include <cstring>
+#include <unordered_set>
+#include <giomm/file.h>
+#include <glib.h>
+
+#include "async/progress.h"
+#include "document.h"
+#include "document-undo.h"
+#include "preferences.h"
+#include "version.h"
+
+#include "object/sp-root.h"
+#include "xml/node.h"
+#include "xml/repr.h"
+
+namespace Inkscape {
+namespace IO {
+
+namespace {
+
+/**
+ * Whether an element below the root must be present from the start. These are cheap to build and
+ * may be needed to interpret the rest: resources, document settings, metadata.
+ */
+bool is_structural(XML::Node const *node)
+{
+    static auto const names = std::unordered_set<std::string>{
+        "svg:defs", "svg:style", "svg:script", "svg:metadata", "svg:title", "svg:desc"
+    };
+
+    char const *name = node->name();
+    // Everything outside the SVG namespace, such as sodipodi:namedview, is kept too.
+    return std::strncmp(name, "svg:", 4) != 0 || names.count(name);
+}
+
+/**
+ * Whether a document written by this Inkscape version is fixed up on load by SPDocument::createDoc().
+ * The fixups only see the content that is present at the time, so such documents are opened in one go.
+ */
+bool needs_fixups(XML::Node const *rroot)
+{
+    auto version = Inkscape::Version();
+    sp_version_from_string(rroot->attribute("inkscape:version"), &version);
+    return SPDocument::needsVersionFixups(version);
+}
+
+std::size_t count_elements(XML::Node const *node)
+{
+    if (node->type() != XML::NodeType::ELEMENT_NODE) {
+        return 0;
+    }
+    std::size_t count = 1;
+    for (auto child = node->firstChild(); child; child = child->next()) {
+        count += count_elements(child);
+    }
+    return count;
+}
+
+} // namespace
+
+bool ProgressiveOpen::wanted(Glib::RefPtr<Gio::File> const &file)
+{
+    auto prefs = Inkscape::Preferences::get();
+    if (!file || !prefs->getBool("/options/progressiveopen/enable", true)) {
+        return false;
+    }
+
+    auto const path = file->get_path();
+    if (path.empty() || !(g_str_has_suffix(path.c_str(), ".svg") || g_str_has_suffix(path.c_str(), ".svgz"))) {
+        return false;
+    }
+
+    try {
+        auto info = file->query_info(G_FILE_ATTRIBUTE_STANDARD_SIZE);
+        auto const threshold = prefs->getIntLimited("/options/progressiveopen/threshold", 50, 0, 100000); // MiB
+        return info->get_size() >= static_cast<goffset>(threshold) * 1024 * 1024;
+    } catch (Glib::Error const &) {
+        return false;
+    }
+}
+
+std::unique_ptr<ProgressiveOpen> ProgressiveOpen::create(std::string const &path)
+{
+    auto rdoc = sp_repr_read_file(path.c_str(), SP_SVG_NS_URI);
+    if (!rdoc) {
+        return nullptr;
+    }
+
+    auto rroot = rdoc->root();
+    if (std::strcmp(rroot->name(), "svg:svg") != 0) {
+        Inkscape::GC::release(rdoc);
+        return nullptr;
+    }
+
+    auto self = std::unique_ptr<ProgressiveOpen>(new ProgressiveOpen());
+    self->_batch_size = Inkscape::Preferences::get()->getIntLimited("/options/progressiveopen/batchsize", 20000, 1, 10000000);
+
+    // Hold back the drawing content before any objects are built for it.
+    if (!needs_fixups(rroot)) {
+        XML::Node *prev = nullptr;
+        for (auto child = rroot->firstChild(); child; ) {
+            auto next = child->next();
+            if (child->type() == XML::NodeType::ELEMENT_NODE && !is_structural(child)) {
+                self->defer(rroot, child, prev);
+            }
+            prev = child;
+            child = next;
+        }
+    }
+
+    auto document_base = g_path_get_dirname(path.c_str());
+    auto document_name = g_path_get_basename(path.c_str());
+    bool const no_base = std::strcmp(document_base, ".") == 0;
+
+    self->_document = SPDocument::createDoc(rdoc, path.c_str(), no_base ? nullptr : document_base, document_name, true, nullptr);
+
+    g_free(document_base);
+    g_free(document_name);
+
+    // This is the only other place original values should be set (see ink_file_open).
+    auto root = self->_document->getRoot();
+    root->original.inkscape = root->version.inkscape;
+    root->original.svg      = root->version.svg;
+
+    if (self->pending()) {
+        self->_document->setLoading([ptr = self.get()] { ptr->finish(); });
+    }
+
+    return self;
+}
+
+ProgressiveOpen::~ProgressiveOpen()
+{
+    for (auto const &entry : _pending) {
+        release(entry);
+    }
+    if (_document) {
+        _document->setLoading(nullptr);
+    }
+}
+
+/**
+ * Detach \a node from \a parent and queue it to be added back later. Groups with more elements
+ * than fit in one batch are split up, so that each batch stays small.
+ */
+void ProgressiveOpen::defer(XML::Node *parent, XML::Node *node, XML::Node *after)
+{
+    auto const weight = count_elements(node);
+
+    Inkscape::GC::anchor(parent);
+    Inkscape::GC::anchor(node);
+    if (after) {
+        Inkscape::GC::anchor(after);
+    }
+    parent->removeChild(node);
+
+    if (weight <= _batch_size || std::strcmp(node->name(), "svg:g") != 0) {
+        _pending.push_back({ parent, node, after, weight });
+        _total += weight;
+        return;
+    }
+
+    // Add the group itself first, then its children in order.
+    _pending.push_back({ parent, node, after, 1 });
+    _total += 1;
+
+    XML::Node *prev = nullptr;
+    for (auto child = node->firstChild(); child; ) {
+        auto next = child->next();
+        defer(node, child, prev);
+        prev = child;
+        child = next;
+    }
+}
+
+void ProgressiveOpen::add(Entry const &entry)
+{
+    // The previous sibling may have been deleted or moved elsewhere by now.
+    if (!entry.after || entry.after->parent() == entry.parent) {
+        entry.parent->addChild(entry.node, entry.after);
+    } else {
+        entry.parent->appendChild(entry.node);
+    }
+    release(entry);
+    _done += entry.weight;
+}
+
+void ProgressiveOpen::release(Entry const &entry)
+{
+    Inkscape::GC::release(entry.parent);
+    Inkscape::GC::release(entry.node);
+    if (entry.after) {
+        Inkscape::GC::release(entry.after);
+    }
+}
+
+bool ProgressiveOpen::step(Async::Progress<double> &progress)
+{
+    {
+        DocumentUndo::ScopedInsensitive no_undo(_document);
+
+        std::size_t added = 0;
+        while (!_pending.empty() && added < _batch_size) {
+            progress.throw_if_cancelled();
+            auto const entry = _pending.front();
+            _pending.pop_front();
+            add(entry);
+            added += entry.weight;
+        }
+    }
+
+    _document->ensureUpToDate();
+
+    if (_pending.empty()) {
+        _document->setLoading(nullptr);
+    }
+
+    progress.report_or_throw(_total ? static_cast<double>(_done) / _total : 1.0);
+
+    return !_pending.empty();
+}
+
+void ProgressiveOpen::finish()
+{
+    {
+        DocumentUndo::ScopedInsensitive no_undo(_document);
+
+        while (!_pending.empty()) {
+            auto const entry = _pending.front();
+            _pending.pop_front();
+            add(entry);
+        }
+    }
+
+    _document->setLoading(nullptr);
+    _document->ensureUpToDate();
+}
+
+} // namespace IO
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4 :
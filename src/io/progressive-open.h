@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Open large SVG documents in stages.
+ *
+ * The XML of the file is parsed up front, but the drawing content is held back and only added to
+ * the document batch by batch, so that the document can be shown and the parts that are ready
+ * rendered while the rest is still being built.
+ */
+#ifndef INKSCAPE_IO_PROGRESSIVE_OPEN_H
+#define INKSCAPE_IO_PROGRESSIVE_OPEN_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace Gio {
+class File;
+} // namespace Gio
+
+namespace Glib {
+template <class T>
+class RefPtr;
+} // namespace Glib
+
+class SPDocument;
+
+namespace Inkscape {
+
+namespace Async {
+template <typename... T>
+class Progress;
+} // namespace Async
+
+namespace XML {
+class Node;
+} // namespace XML
+
+namespace IO {
+
+class ProgressiveOpen
+{
+public:
+    /// Whether \a file should be opened progressively, judging by its type, size and the preferences.
+    static bool wanted(Glib::RefPtr<Gio::File> const &file);
+
+    /**
+     * Read the file at \a path and create a document holding everything but its drawing content.
+     * Returns null if the file could not be read as SVG.
+     */
+    static std::unique_ptr<ProgressiveOpen> create(std::string const &path);
+
+    ProgressiveOpen(ProgressiveOpen const &) = delete;
+    ProgressiveOpen &operator=(ProgressiveOpen const &) = delete;
+
+    /// Drops any content that has not been added yet. The document must still exist.
+    ~ProgressiveOpen();
+
+    SPDocument *document() const { return _document; }
+
+    /// Whether there is content that has not been added yet.
+    bool pending() const { return !_pending.empty(); }
+
+    /**
+     * Add the next batch of content and bring the document up to date.
+     * Returns false once all content has been added.
+     * Throws Async::CancelledException if \a progress is cancelled; the remaining content may
+     * still be added later.
+     */
+    bool step(Async::Progress<double> &progress);
+
+    /// Add all remaining content at once.
+    void finish();
+
+private:
+    ProgressiveOpen() = default;
+
+    /// Nodes are anchored until the entry has been added, since the document may be edited meanwhile.
+    struct Entry
+    {
+        XML::Node *parent;
+        XML::Node *node;
+        XML::Node *after; ///< original previous sibling; either never removed or added back before
+        std::size_t weight;
+    };
+
+    SPDocument *_document = nullptr;
+    std::deque<Entry> _pending;
+    std::size_t _batch_size = 0;
+    std::size_t _total = 0;
+    std::size_t _done = 0;
+
+    void defer(XML::Node *parent, XML::Node *node, XML::Node *after);
+    void add(Entry const &entry);
+    static void release(Entry const &entry);
+};
+
+} // namespace IO
+} // namespace Inkscape
+
+#endif // INKSCAPE_IO_PROGRESSIVE_OPEN_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
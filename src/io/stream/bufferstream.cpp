@@ -23,6 +23,9 @@
 
 #include "bufferstream.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Inkscape
 {
 namespace IO
@@ -83,6 +86,19 @@ int BufferInputStream::get()
     return ch;
 }
 
+/**
+ * Reads up to size bytes from the input stream.  0 if EOF
+ */
+std::size_t BufferInputStream::read(char *buf, std::size_t size)
+{
+    if (closed || position >= (long)buffer.size())
+        return 0;
+    std::size_t len = std::min(size, buffer.size() - (std::size_t)position);
+    memcpy(buf, buffer.data() + position, len);
+    position += len;
+    return len;
+}
+
 
 
 
@@ -133,6 +149,16 @@ int BufferOutputStream::put(char ch)
     return 1;
 }
 
+/**
+ * Writes the specified bytes to this output stream.
+ */
+void BufferOutputStream::write(char const *data, std::size_t size)
+{
+    if (closed)
+        return;
+    buffer.insert(buffer.end(), data, data + size);
+}
+
 
 
 
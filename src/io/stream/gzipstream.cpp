@@ -17,10 +17,15 @@
  */
 
 #include "gzipstream.h"
-#include <cstdio>
-#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <deque>
+#include <future>
 #include <string>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <glib.h>
 
 namespace Inkscape
 {
@@ -31,24 +36,29 @@ namespace IO
 //# G Z I P    I N P U T    S T R E A M
 //#########################################################################
 
-#define OUT_SIZE 4000
+#define IN_SIZE (64 * 1024)
+#define OUT_SIZE (256 * 1024)
 
 /**
  *
  */ 
 GzipInputStream::GzipInputStream(InputStream &sourceStream)
                     : BasicInputStream(sourceStream),
-                      loaded(false),
-                      outputBuf(nullptr),
-                      srcBuf(nullptr),
-                      crc(0),
-                      srcCrc(0),
-                      srcSiz(0),
-                      srcLen(0),
+                      finished(false),
+                      inputBuf(IN_SIZE),
+                      outputBuf(OUT_SIZE),
                       outputBufPos(0),
                       outputBufLen(0)
 {
     memset( &d_stream, 0, sizeof(d_stream) );
+
+    // Let zlib parse the gzip header and check the trailer.
+    int zerr = inflateInit2(&d_stream, 16 + MAX_WBITS);
+    if (zerr != Z_OK) {
+        g_warning("inflateInit2: %d", zerr);
+        finished = true;
+        closed = true;
+    }
 }
 
 /**
@@ -57,14 +67,6 @@ GzipInputStream::GzipInputStream(InputStream &sourceStream)
 GzipInputStream::~GzipInputStream()
 {
     close();
-    if ( srcBuf ) {
-      delete[] srcBuf;
-      srcBuf = nullptr;
-    }
-    if ( outputBuf ) {
-        delete[] outputBuf;
-        outputBuf = nullptr;
-    }
 }
 
 /**
@@ -74,9 +76,9 @@ GzipInputStream::~GzipInputStream()
  */ 
 int GzipInputStream::available()
 {
-    if (closed || !outputBuf)
+    if (closed)
         return 0;
-    return outputBufLen - outputBufPos;
+    return static_cast<int>(outputBufLen - outputBufPos);
 }
 
     
@@ -89,19 +91,10 @@ void GzipInputStream::close()
     if (closed)
         return;
 
-    int zerr = inflateEnd(&d_stream);
-    if (zerr != Z_OK) {
-        printf("inflateEnd: Some kind of problem: %d\n", zerr);
-    }
-
-    if ( srcBuf ) {
-      delete[] srcBuf;
-      srcBuf = nullptr;
-    }
-    if ( outputBuf ) {
-        delete[] outputBuf;
-        outputBuf = nullptr;
-    }
+    inflateEnd(&d_stream);
+    inputBuf = {};
+    outputBuf = {};
+    outputBufPos = outputBufLen = 0;
     closed = true;
 }
     
@@ -110,199 +103,174 @@ void GzipInputStream::close()
  */ 
 int GzipInputStream::get()
 {
-    int ch = -1;
-    if (closed) {
-        // leave return value -1
+    if (closed || (outputBufPos >= outputBufLen && !fetchMore())) {
+        return -1;
     }
-    else if (!loaded && !load()) {
-        closed=true;
-    } else {
-        loaded = true;
-
-        if ( outputBufPos >= outputBufLen ) {
-            // time to read more, if we can
-            fetchMore();
-        }
+    return outputBuf[outputBufPos++];
+}
 
-        if ( outputBufPos < outputBufLen ) {
-            ch = (int)outputBuf[outputBufPos++];
+std::size_t GzipInputStream::read(char *buffer, std::size_t size)
+{
+    std::size_t done = 0;
+    while (!closed && done < size) {
+        if (outputBufPos >= outputBufLen && !fetchMore()) {
+            break;
         }
+        auto const n = std::min(size - done, outputBufLen - outputBufPos);
+        memcpy(buffer + done, outputBuf.data() + outputBufPos, n);
+        outputBufPos += n;
+        done += n;
     }
-
-    return ch;
+    return done;
 }
 
-#define FTEXT 0x01
-#define FHCRC 0x02
-#define FEXTRA 0x04
-#define FNAME 0x08
-#define FCOMMENT 0x10
+/**
+ * Read the next chunk of compressed data from the source.
+ * Returns false at its end.
+ */
+bool GzipInputStream::fillInput()
+{
+    std::size_t len = source.read(reinterpret_cast<char *>(inputBuf.data()), IN_SIZE);
+    d_stream.next_in   = inputBuf.data();
+    d_stream.avail_in  = len;
+    return len > 0;
+}
 
-bool GzipInputStream::load()
+/**
+ * Inflate the next chunk of data into the output buffer.
+ * Returns false at the end of the data.
+ */
+bool GzipInputStream::fetchMore()
 {
-    crc = crc32(0L, Z_NULL, 0);
-    
-    std::vector<Byte> inputBuf;
-    while (true)
-        {
-        int ch = source.get();
-        if (ch<0)
+    outputBufPos = 0;
+    outputBufLen = 0;
+
+    while (!finished && outputBufLen == 0) {
+        if (d_stream.avail_in == 0 && !fillInput()) {
+            if (d_stream.total_in > 0) {
+                g_warning("Gzip data is truncated");
+            }
+            finished = true;
             break;
-        inputBuf.push_back(static_cast<Byte>(ch & 0xff));
-        }
-    long inputBufLen = inputBuf.size();
-    
-    if (inputBufLen < 19) //header + tail + 1
-        {
-        return false;
         }
 
-    srcLen = inputBuf.size();
-    srcBuf = new (std::nothrow) Byte [srcLen];
-    if (!srcBuf) {
-        return false;
-    }
+        d_stream.next_out  = outputBuf.data();
+        d_stream.avail_out = OUT_SIZE;
+        int zerr = inflate(&d_stream, Z_NO_FLUSH);
+        outputBufLen = OUT_SIZE - d_stream.avail_out;
 
-    outputBuf = new (std::nothrow) unsigned char [OUT_SIZE];
-    if ( !outputBuf ) {
-        delete[] srcBuf;
-        srcBuf = nullptr;
-        return false;
+        if (zerr == Z_STREAM_END) {
+            // Concatenated gzip files are one gzip file; see if another member follows.
+            if (d_stream.avail_in == 0 && !fillInput()) {
+                finished = true;
+            } else if (d_stream.next_in[0] != 0x1f) {
+                finished = true; // ignore trailing garbage
+            } else {
+                inflateReset(&d_stream);
+            }
+        } else if (zerr != Z_OK && zerr != Z_BUF_ERROR) {
+            g_warning("Gzip data is damaged: %s", d_stream.msg ? d_stream.msg : "unknown error");
+            finished = true;
+        }
     }
-    outputBufLen = 0; // Not filled in yet
-
-    std::vector<unsigned char>::iterator iter;
-    Bytef *p = srcBuf;
-    for (iter=inputBuf.begin() ; iter != inputBuf.end() ; ++iter)
-	{
-        *p++ = *iter;
-	}
 
-    size_t headerLen = 10;
-
-    int flags = static_cast<int>(srcBuf[3]);
-
-    constexpr size_t size_XLEN = 2;
-    constexpr size_t size_CRC16 = 2;
-    constexpr size_t size_CRC32 = 4;
-    constexpr size_t size_ISIZE = 4;
+    return outputBufLen > 0;
+}
 
-    auto const check_not_truncated = [&] { return headerLen + size_CRC32 + size_ISIZE <= srcLen; };
+//#########################################################################
+//# G Z I P   O U T P U T    S T R E A M
+//#########################################################################
 
-    auto const skip_n = [&](size_t n) {
-        headerLen += n;
-        return check_not_truncated();
-    };
+// Same as pigz: independent blocks of 128 KiB, each primed with the 32 KiB
+// of input before it so that splitting costs hardly any compression.
+#define BLOCK_SIZE (128 * 1024)
+#define DICT_SIZE (32 * 1024)
 
-    auto const skip_zero_terminated = [&] {
-        while (headerLen < srcLen && srcBuf[headerLen++]) {
-        }
-        return check_not_truncated();
-    };
+namespace {
 
-    if (flags & FEXTRA) {
-        if (!skip_n(size_XLEN)) {
-            return false;
-        }
-        auto const xlen = size_t(srcBuf[headerLen - 2]) | //
-                          size_t(srcBuf[headerLen - 1] << 8);
-        if (!skip_n(xlen)) {
-            return false;
-        }
-    }
+struct Block
+{
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> dictionary;
+    std::vector<unsigned char> output;
+    unsigned long crc = 0;
+    bool last = false;
+    std::promise<void> promise;
+};
 
-    if ((flags & FNAME) && !skip_zero_terminated()) {
-        return false;
-    }
+/**
+ * Deflate a block on its own.  All blocks but the last end on a byte
+ * boundary with an empty stored block, so they can simply be concatenated.
+ */
+void compressBlock(Block &block)
+{
+    block.crc = crc32(crc32(0L, Z_NULL, 0), block.input.data(), block.input.size());
 
-    if ((flags & FCOMMENT) && !skip_zero_terminated()) {
-        return false;
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    int zerr = deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    if (zerr != Z_OK) {
+        g_warning("deflateInit2: %d", zerr);
+        return;
     }
-
-    if ((flags & FHCRC) && !skip_n(size_CRC16)) {
-        return false;
+    if (!block.dictionary.empty()) {
+        deflateSetDictionary(&z, block.dictionary.data(), block.dictionary.size());
     }
 
-    if (!check_not_truncated()) {
-        return false;
+    z.next_in  = block.input.data();
+    z.avail_in = block.input.size();
+
+    int const mode = block.last ? Z_FINISH : Z_SYNC_FLUSH;
+    std::size_t len = 0;
+    std::size_t more = deflateBound(&z, block.input.size()) + 16;
+    while (true) {
+        block.output.resize(len + more);
+        z.next_out  = block.output.data() + len;
+        z.avail_out = more;
+        zerr = deflate(&z, mode);
+        len = block.output.size() - z.avail_out;
+        bool const done = block.last ? zerr == Z_STREAM_END : z.avail_out > 0;
+        if (done || (zerr != Z_OK && zerr != Z_BUF_ERROR)) {
+            break;
+        }
+        more = 64 * 1024;
     }
+    block.output.resize(len);
 
-    srcCrc = ((0x0ff & srcBuf[srcLen - 5]) << 24)
-           | ((0x0ff & srcBuf[srcLen - 6]) << 16)
-           | ((0x0ff & srcBuf[srcLen - 7]) <<  8)
-           | ((0x0ff & srcBuf[srcLen - 8]) <<  0);
-    //printf("srcCrc:%lx\n", srcCrc);
-    
-    srcSiz = ((0x0ff & srcBuf[srcLen - 1]) << 24)
-           | ((0x0ff & srcBuf[srcLen - 2]) << 16)
-           | ((0x0ff & srcBuf[srcLen - 3]) <<  8)
-           | ((0x0ff & srcBuf[srcLen - 4]) <<  0);
-    //printf("srcSiz:%lx/%ld\n", srcSiz, srcSiz);
-    
-    //outputBufLen = srcSiz + srcSiz/100 + 14;
-    
-    unsigned char *data = srcBuf + headerLen;
-    unsigned long dataLen = srcLen - (headerLen + 8);
-    //printf("%x %x\n", data[0], data[dataLen-1]);
-    
-    d_stream.zalloc    = (alloc_func)nullptr;
-    d_stream.zfree     = (free_func)nullptr;
-    d_stream.opaque    = (voidpf)nullptr;
-    d_stream.next_in   = data;
-    d_stream.avail_in  = dataLen;
-    d_stream.next_out  = outputBuf;
-    d_stream.avail_out = OUT_SIZE;
-    
-    int zerr = inflateInit2(&d_stream, -MAX_WBITS);
-    if ( zerr == Z_OK )
-    {
-        zerr = fetchMore();
-    } else {
-        printf("inflateInit2: Some kind of problem: %d\n", zerr);
+    if (zerr != Z_OK && zerr != Z_STREAM_END) {
+        g_warning("deflate: %d", zerr);
     }
-
-        
-    return (zerr == Z_OK) || (zerr == Z_STREAM_END);
+    deflateEnd(&z);
 }
 
+} // namespace
 
-int GzipInputStream::fetchMore()
+/**
+ * The blocks being compressed, oldest first, and the threads doing it.
+ */
+struct GzipOutputStream::Pipeline
 {
-    // TODO assumes we aren't called till the buffer is empty
-    d_stream.next_out  = outputBuf;
-    d_stream.avail_out = OUT_SIZE;
-    outputBufLen = 0;
-    outputBufPos = 0;
-
-    int zerr = inflate( &d_stream, Z_SYNC_FLUSH );
-    if ( zerr == Z_OK || zerr == Z_STREAM_END ) {
-        outputBufLen = OUT_SIZE - d_stream.avail_out;
-        if ( outputBufLen ) {
-            crc = crc32(crc, const_cast<const Bytef *>(outputBuf), outputBufLen);
-        }
-        //printf("crc:%lx\n", crc);
-//     } else if ( zerr != Z_STREAM_END ) {
-//         // TODO check to be sure this won't happen for partial end reads
-//         printf("inflate: Some kind of problem: %d\n", zerr);
-    }
-
-    return zerr;
-}
-
-//#########################################################################
-//# G Z I P   O U T P U T    S T R E A M
-//#########################################################################
+    std::deque<std::pair<std::shared_ptr<Block>, std::future<void>>> blocks;
+    std::unique_ptr<boost::asio::thread_pool> pool;
+    std::size_t maxBlocks = 1;
+};
 
 /**
  *
  */ 
-GzipOutputStream::GzipOutputStream(OutputStream &destinationStream)
-                     : BasicOutputStream(destinationStream)
+GzipOutputStream::GzipOutputStream(OutputStream &destinationStream, int threads)
+                     : BasicOutputStream(destinationStream),
+                       pipeline(std::make_unique<Pipeline>()),
+                       totalIn(0),
+                       crc(crc32(0L, Z_NULL, 0))
 {
+    inputBuf.reserve(BLOCK_SIZE);
 
-    totalIn         = 0;
-    totalOut        = 0;
-    crc             = crc32(0L, Z_NULL, 0);
+    if (threads > 1) {
+        pipeline->pool = std::make_unique<boost::asio::thread_pool>(threads);
+        // Enough to keep all threads busy while the oldest one is written.
+        pipeline->maxBlocks = 2 * threads;
+    }
 
     //Gzip header
     destination.put(0x1f);
@@ -347,7 +315,9 @@ void GzipOutputStream::close()
     if (closed)
         return;
 
-    flush();
+    submit(true);
+    writeBlocks(true);
+    pipeline->pool.reset();
 
     //# Send the CRC
     uLong outlong = crc;
@@ -374,54 +344,75 @@ void GzipOutputStream::close()
  */ 
 void GzipOutputStream::flush()
 {
-    if (closed || inputBuf.empty())
+    if (closed)
 	{
         return;
     }
-	
-    uLong srclen = inputBuf.size();
-    Bytef *srcbuf = new (std::nothrow) Bytef [srclen];
-    if (!srcbuf)
-        {
-        return;
-        }
-        
-    uLong destlen = srclen;
-    Bytef *destbuf = new (std::nothrow) Bytef [(destlen + (srclen/100) + 13)];
-    if (!destbuf)
-        {
-        delete[] srcbuf;
-        return;
-        }
-        
-    std::vector<unsigned char>::iterator iter;
-    Bytef *p = srcbuf;
-    for (iter=inputBuf.begin() ; iter != inputBuf.end() ; ++iter)
-        *p++ = *iter;
-        
-    crc = crc32(crc, const_cast<const Bytef *>(srcbuf), srclen);
-    
-    int zerr = compress(destbuf, static_cast<uLongf *>(&destlen), srcbuf, srclen);
-    if (zerr != Z_OK)
-        {
-        printf("Some kind of problem\n");
-        }
 
-    totalOut += destlen;
-    //skip the redundant zlib header and checksum
-    for (uLong i=2; i<destlen-4 ; i++)
-        {
-        destination.put((int)destbuf[i]);
-        }
-        
+    if (!inputBuf.empty()) {
+        submit(false);
+    }
+    writeBlocks(true);
     destination.flush();
+}
+
+/**
+ * Hand the buffered input over for compression as the next block.
+ */
+void GzipOutputStream::submit(bool last)
+{
+    auto block = std::make_shared<Block>();
+    block->input.swap(inputBuf);
+    block->dictionary = dictionary;
+    block->last = last;
+    inputBuf.reserve(BLOCK_SIZE);
+
+    // The next block is primed with the end of this one.
+    auto const &input = block->input;
+    if (input.size() >= DICT_SIZE) {
+        dictionary.assign(input.end() - DICT_SIZE, input.end());
+    } else {
+        dictionary.insert(dictionary.end(), input.begin(), input.end());
+        if (dictionary.size() > DICT_SIZE) {
+            dictionary.erase(dictionary.begin(), dictionary.end() - DICT_SIZE);
+        }
+    }
+
+    auto future = block->promise.get_future();
+    if (pipeline->pool) {
+        boost::asio::post(*pipeline->pool, [block] {
+            compressBlock(*block);
+            block->promise.set_value();
+        });
+    } else {
+        compressBlock(*block);
+        block->promise.set_value();
+    }
+    pipeline->blocks.emplace_back(std::move(block), std::move(future));
 
-    inputBuf.clear();
-    delete[] srcbuf;
-    delete[] destbuf;
+    writeBlocks(false);
 }
 
+/**
+ * Write out the compressed blocks in order: all of them, or just the
+ * finished ones unless too many are waiting.
+ */
+void GzipOutputStream::writeBlocks(bool all)
+{
+    auto &blocks = pipeline->blocks;
+    while (!blocks.empty()) {
+        auto &[block, future] = blocks.front();
+        bool const ready = future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if (!all && !ready && blocks.size() <= pipeline->maxBlocks) {
+            break;
+        }
+        future.wait();
 
+        destination.write(reinterpret_cast<char const *>(block->output.data()), block->output.size());
+        crc = crc32_combine(crc, block->crc, block->input.size());
+        blocks.pop_front();
+    }
+}
 
 /**
  * Writes the specified byte to this output stream.
@@ -434,13 +425,29 @@ int GzipOutputStream::put(char ch)
         return -1;
         }
 
-
     //Add char to buffer
     inputBuf.push_back(ch);
     totalIn++;
+    if (inputBuf.size() >= BLOCK_SIZE) {
+        submit(false);
+    }
     return 1;
 }
 
+void GzipOutputStream::write(char const *data, std::size_t size)
+{
+    while (!closed && size > 0) {
+        auto const n = std::min(size, BLOCK_SIZE - inputBuf.size());
+        inputBuf.insert(inputBuf.end(), data, data + n);
+        totalIn += n;
+        data += n;
+        size -= n;
+        if (inputBuf.size() >= BLOCK_SIZE) {
+            submit(false);
+        }
+    }
+}
+
 
 
 } // namespace IO
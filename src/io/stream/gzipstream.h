@@ -18,6 +18,9 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include "inkscapestream.h"
 #include <zlib.h>
@@ -49,23 +52,20 @@ public:
     void close() override;
     
     int get() override;
+
+    std::size_t read(char *buffer, std::size_t size) override;
     
 private:
 
-    bool load();
-    int fetchMore();
+    bool fillInput();
+    bool fetchMore();
 
-    bool loaded;
-    
-    unsigned char *outputBuf;
-    unsigned char *srcBuf;
+    bool finished;
 
-    unsigned long crc;
-    unsigned long srcCrc;
-    unsigned long srcSiz;
-    unsigned long srcLen;
-    long outputBufPos;
-    long outputBufLen;
+    std::vector<unsigned char> inputBuf;
+    std::vector<unsigned char> outputBuf;
+    std::size_t outputBufPos;
+    std::size_t outputBufLen;
 
     z_stream d_stream;
 }; // class GzipInputStream
@@ -81,13 +81,19 @@ private:
  * This class is for gzip-compressing data going to the
  * destination OutputStream
  *
+ * The data is cut into blocks which are compressed independently, the
+ * way pigz does it, so that several of them can be compressed at once.
+ * The result is a single ordinary gzip member either way.
  */
 class GzipOutputStream : public BasicOutputStream
 {
 
 public:
 
-    GzipOutputStream(OutputStream &destinationStream);
+    /**
+     * Compress to \a destinationStream, using up to \a threads threads.
+     */
+    GzipOutputStream(OutputStream &destinationStream, int threads = 1);
     
     ~GzipOutputStream() override;
     
@@ -97,12 +103,20 @@ public:
     
     int put(char ch) override;
 
+    void write(char const *data, std::size_t size) override;
+
 private:
 
+    struct Pipeline;
+
+    void submit(bool last);
+    void writeBlocks(bool all);
+
     std::vector<unsigned char> inputBuf;
+    std::vector<unsigned char> dictionary;
+    std::unique_ptr<Pipeline> pipeline;
 
-    long totalIn;
-    long totalOut;
+    std::uint64_t totalIn;
     unsigned long crc;
 
 }; // class GzipOutputStream
@@ -13,6 +13,7 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include "inkscapestream.h"
 
 namespace Inkscape
@@ -26,16 +27,39 @@ namespace IO
 
 void pipeStream(InputStream &source, OutputStream &dest)
 {
+    char buf[65536];
     for (;;)
         {
-        int ch = source.get();
-        if (ch<0)
+        std::size_t len = source.read(buf, sizeof(buf));
+        if (len == 0)
             break;
-        dest.put(ch);
+        dest.write(buf, len);
         }
     dest.flush();
 }
 
+//#########################################################################
+//# I N P U T    S T R E A M
+//#########################################################################
+
+std::size_t InputStream::read(char *buffer, std::size_t size)
+{
+    std::size_t len = 0;
+    for (int ch; len < size && (ch = get()) >= 0; )
+        buffer[len++] = static_cast<char>(ch);
+    return len;
+}
+
+//#########################################################################
+//# O U T P U T    S T R E A M
+//#########################################################################
+
+void OutputStream::write(char const *data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++)
+        put(data[i]);
+}
+
 //#########################################################################
 //# B A S I C    I N P U T    S T R E A M
 //#########################################################################
@@ -428,6 +452,18 @@ char StdReader::get()
 
 
 
+//#########################################################################
+//# W R I T E R
+//#########################################################################
+
+void Writer::write(char const *data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; i++)
+        put(data[i]);
+}
+
+
+
 //#########################################################################
 //# B A S I C    W R I T E R
 //#########################################################################
@@ -508,9 +544,7 @@ Writer &BasicWriter::writeUString(const Glib::ustring &str)
  */ 
 Writer &BasicWriter::writeStdString(const std::string &str)
 {
-    for (char it : str) {
-        put(it);
-    }
+    write(str.data(), str.size());
     return *this;
 }
 
@@ -519,12 +553,9 @@ Writer &BasicWriter::writeStdString(const std::string &str)
  */ 
 Writer &BasicWriter::writeString(const char *str)
 {
-    std::string tmp;
-    if (str)
-        tmp = str;
-    else
-        tmp = "null";
-    writeStdString(tmp);
+    if (!str)
+        str = "null";
+    write(str, strlen(str));
     return *this;
 }
 
@@ -740,6 +771,11 @@ void OutputStreamWriter::put(char ch)
     outputStream.put(ch);
 }
 
+void OutputStreamWriter::write(char const *data, std::size_t size)
+{
+    outputStream.write(data, size);
+}
+
 //#########################################################################
 //# S T D    W R I T E R
 //#########################################################################
@@ -790,6 +826,11 @@ void StdWriter::put(char ch)
     outputStream->put(ch);
 }
 
+void StdWriter::write(char const *data, std::size_t size)
+{
+    outputStream->write(data, size);
+}
+
 
 } // namespace IO
 } // namespace Inkscape
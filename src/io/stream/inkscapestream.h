@@ -10,6 +10,7 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <cstddef>
 #include <cstdio>
 #include <glibmm/ustring.h>
 
@@ -87,6 +88,14 @@ public:
      * This call returns -1 on end-of-file.
      */
     virtual int get() = 0;
+
+    /**
+     * Read up to size bytes into buffer.  Returns the number of bytes
+     * read, which is less than size only at the end of the stream.
+     * Streams that can hand out more than a byte at a time should
+     * override this; the default calls get() for every byte.
+     */
+    virtual std::size_t read(char *buffer, std::size_t size);
     
 }; // class InputStream
 
@@ -194,6 +203,13 @@ public:
      */
     virtual int put(char ch) = 0;
 
+    /**
+     * Send size bytes to the destination stream.  Streams that can take
+     * more than a byte at a time should override this; the default calls
+     * put() for every byte.
+     */
+    virtual void write(char const *data, std::size_t size);
+
 
 }; // class OutputStream
 
@@ -244,6 +260,9 @@ public:
     int put(char ch) override
         {return  putchar(ch); }
 
+    void write(char const *data, std::size_t size) override
+        { fwrite(data, 1, size, stdout); }
+
 };
 
 
@@ -474,6 +493,11 @@ public:
     virtual void flush() = 0;
     
     virtual void put(char ch) = 0;
+
+    /**
+     * Write size bytes at once.  The default calls put() for every byte.
+     */
+    virtual void write(char const *data, std::size_t size);
     
     /* Formatted output */
     virtual Writer& printf(char const *fmt, ...) G_GNUC_PRINTF(2,3) = 0;
@@ -620,6 +644,8 @@ public:
     
     void put(char ch) override;
 
+    void write(char const *data, std::size_t size) override;
+
 
 private:
 
@@ -648,6 +674,8 @@ public:
     
     void put(char ch) override;
 
+    void write(char const *data, std::size_t size) override;
+
 
 private:
 
@@ -78,6 +78,8 @@ public:
     
     int put(char ch) override;
 
+    void write(char const *data, std::size_t size) override;
+
     virtual Glib::ustring &getString()
         { return buffer; }
 
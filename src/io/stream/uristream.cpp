@@ -88,6 +88,16 @@ int FileInputStream::get()
     return retVal;
 }
 
+/**
+ * Reads up to size bytes from the input stream.  0 if EOF
+ */
+std::size_t FileInputStream::read(char *buffer, std::size_t size)
+{
+    if (!inf)
+        return 0;
+    return fread(buffer, 1, size, inf);
+}
+
 
 
 
@@ -156,6 +166,19 @@ int FileOutputStream::put(char ch)
     return 1;
 }
 
+/**
+ * Writes the specified bytes to this output stream.
+ */
+void FileOutputStream::write(char const *data, std::size_t size)
+{
+    if (!outf)
+        return;
+    if (fwrite(data, 1, size, outf) != size) {
+        Glib::ustring err = "ERROR writing to file ";
+        throw StreamException(err);
+    }
+}
+
 
 
 
@@ -50,6 +50,8 @@ public:
 
     int get() override;
 
+    std::size_t read(char *buffer, std::size_t size) override;
+
 private:
     FILE *inf;           //for file: uris
 
@@ -80,6 +82,8 @@ public:
 
     int put(char ch) override;
 
+    void write(char const *data, std::size_t size) override;
+
 private:
 
     bool ownsFile;
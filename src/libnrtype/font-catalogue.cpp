@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Persistent catalogue of the styles of the installed font families.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "libnrtype/font-catalogue.h"
+
+#include <cstdint>
+#include <glibmm/fileutils.h>
+
+#include "io/cache-file.h"
+#include "io/resource.h"
+
+namespace {
+
+// Bump the version when the format changes.
+constexpr char const *MAGIC = "inkscape-font-catalogue";
+constexpr std::uint32_t FORMAT_VERSION = 2;
+
+} // namespace
+
+FontCatalogue::FontCatalogue(std::string path, std::string stamp)
+    : _path(std::move(path))
+    , _stamp(std::move(stamp))
+{
+    std::string data;
+    try {
+        data = Glib::file_get_contents(_path);
+    } catch (Glib::FileError const &) {
+        return;
+    }
+
+    auto in = Inkscape::IO::CacheReader(data);
+    if (in.str() != MAGIC || in.u32() != FORMAT_VERSION || in.str() != _stamp) {
+        return; // Another format, or fonts were added or removed since; start over.
+    }
+
+    for (auto families = in.u32(); families > 0 && in.ok(); families--) {
+        auto family = in.str();
+        auto &styles = _styles[family];
+        for (auto n = in.u32(); n > 0 && in.ok(); n--) {
+            auto css_name = in.str();
+            styles.emplace_back(std::move(css_name), in.str());
+        }
+    }
+
+    if (!in.ok() || !in.done()) {
+        g_warning("Ignoring damaged font catalogue '%s'.", _path.c_str());
+        _styles.clear();
+    }
+}
+
+std::string FontCatalogue::default_path()
+{
+    using namespace Inkscape::IO::Resource;
+    return get_path_string(CACHE, NONE, "fonts.cache");
+}
+
+std::vector<StyleNames> const *FontCatalogue::get_styles(std::string const &family) const
+{
+    auto it = _styles.find(family);
+    return it != _styles.end() ? &it->second : nullptr;
+}
+
+void FontCatalogue::set_styles(std::string const &family, std::vector<StyleNames> styles)
+{
+    _styles[family] = std::move(styles);
+    _dirty = true;
+}
+
+void FontCatalogue::save()
+{
+    if (!_dirty) {
+        return;
+    }
+
+    Inkscape::IO::CacheWriter out;
+    out.str(MAGIC);
+    out.u32(FORMAT_VERSION);
+    out.str(_stamp);
+    out.u32(_styles.size());
+    for (auto const &[family, styles] : _styles) {
+        out.str(family);
+        out.u32(styles.size());
+        for (auto const &style : styles) {
+            out.str(style.CssName.raw());
+            out.str(style.DisplayName.raw());
+        }
+    }
+
+    if (Inkscape::IO::write_cache_file(_path, out.data(), "font catalogue")) {
+        _dirty = false;
+    }
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8 :
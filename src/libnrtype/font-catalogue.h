@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Persistent catalogue of the styles of the installed font families.
+ *
+ * Listing the faces of every family through Pango means a fontconfig query per family, which
+ * adds up on systems with thousands of fonts. What FontFactory::GetUIStyles() finds is kept in
+ * the user's cache directory instead, together with a stamp describing the font configuration it
+ * was made for. A catalogue with a different stamp is dropped as a whole.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#ifndef LIBNRTYPE_FONT_CATALOGUE_H
+#define LIBNRTYPE_FONT_CATALOGUE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "libnrtype/font-factory.h"
+
+class FontCatalogue
+{
+public:
+    /// Load the catalogue from \a path if it was written for the same \a stamp.
+    FontCatalogue(std::string path, std::string stamp);
+    FontCatalogue(FontCatalogue const &) = delete;
+    FontCatalogue &operator=(FontCatalogue const &) = delete;
+
+    /// The sorted styles of \a family, or null if they are not known.
+    std::vector<StyleNames> const *get_styles(std::string const &family) const;
+    void set_styles(std::string const &family, std::vector<StyleNames> styles);
+
+    /// Write the catalogue back if anything was added.
+    void save();
+
+    /// The default location of the catalogue.
+    static std::string default_path();
+
+private:
+    std::string _path;
+    std::string _stamp;
+    std::unordered_map<std::string, std::vector<StyleNames>> _styles;
+    bool _dirty = false;
+};
+
+#endif // LIBNRTYPE_FONT_CATALOGUE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8 :
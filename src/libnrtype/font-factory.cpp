@@ -20,6 +20,7 @@
 
 #include <unordered_map>
 
+#include <glib/gstdio.h>
 #include <glibmm/i18n.h>
 
 #include <fontconfig/fontconfig.h>
@@ -28,9 +29,12 @@
 #include <pango/pangoft2.h>
 #include <pango/pango-ot.h>
 
+#include "inkscape-version.h"
+
 #include "io/sys.h"
 #include "io/resource.h"
 
+#include "libnrtype/font-catalogue.h"
 #include "libnrtype/font-factory.h"
 #include "libnrtype/font-instance.h"
 #include "libnrtype/OpenTypeUtil.h"
@@ -218,6 +222,9 @@ FontFactory::FontFactory()
 
 FontFactory::~FontFactory()
 {
+    if (catalogue) {
+        catalogue->save();
+    }
     loaded.clear();
     g_object_unref(fontContext);
     g_object_unref(fontServer);
@@ -363,6 +370,60 @@ static gint StyleNameCompareInternalGlib(gconstpointer a, gconstpointer b)
            StyleNameValue(((StyleNames*)b)->CssName) ? -1 : 1;
 }
 
+/*
+ * Describes the fonts fontconfig sees: its cache files are rewritten, and so its cache
+ * directories touched, when fonts are installed or removed, as are the font directories.
+ */
+static std::string GetFontconfigStamp(FcConfig *conf)
+{
+    std::string stamp = Inkscape::version_string;
+    stamp += '\n';
+    stamp += pango_version_string();
+
+    auto add_dirs = [&] (FcStrList *dirs) {
+        if (!dirs) {
+            return;
+        }
+        while (auto dir = reinterpret_cast<char const *>(FcStrListNext(dirs))) {
+            GStatBuf st;
+            if (g_stat(dir, &st) == 0) {
+                stamp += '\n';
+                stamp += dir;
+                stamp += ' ';
+                stamp += std::to_string(st.st_mtime);
+            }
+        }
+        FcStrListDone(dirs);
+    };
+    add_dirs(FcConfigGetCacheDirs(conf));
+    add_dirs(FcConfigGetFontDirs(conf));
+
+    // Fonts added with AddFontFile().
+    if (auto fonts = FcConfigGetFonts(conf, FcSetApplication)) {
+        for (int i = 0; i < fonts->nfont; ++i) {
+            FcChar8 *file = nullptr;
+            if (FcPatternGetString(fonts->fonts[i], FC_FILE, 0, &file) == FcResultMatch) {
+                stamp += '\n';
+                stamp += reinterpret_cast<char const *>(file);
+            }
+        }
+    }
+
+    return stamp;
+}
+
+FontCatalogue &FontFactory::getCatalogue()
+{
+    if (!catalogue) {
+        FcConfig *conf = pango_fc_font_map_get_config(PANGO_FC_FONT_MAP(fontServer));
+        if (!conf) {
+            conf = FcConfigGetCurrent();
+        }
+        catalogue = std::make_unique<FontCatalogue>(FontCatalogue::default_path(), GetFontconfigStamp(conf));
+    }
+    return *catalogue;
+}
+
 /**
  * Returns a list of all font names available in this font config
  */
@@ -427,6 +488,16 @@ GList *FontFactory::GetUIStyles(PangoFontFamily *in)
         return ret;
     }
 
+    char const *familyName = pango_font_family_get_name(in);
+    if (familyName) {
+        if (auto cached = getCatalogue().get_styles(familyName)) {
+            for (auto const &style : *cached) {
+                ret = g_list_append(ret, new StyleNames(style));
+            }
+            return ret;
+        }
+    }
+
     pango_font_family_list_faces(in, &faces, &numFaces);
 
     for (int currentFace = 0; currentFace < numFaces; currentFace++) {
@@ -509,6 +580,14 @@ GList *FontFactory::GetUIStyles(PangoFontFamily *in)
 
     // Sort the style lists
     ret = g_list_sort( ret, StyleNameCompareInternalGlib );
+
+    if (familyName) {
+        std::vector<StyleNames> styles;
+        for (GList *l = ret; l; l = l->next) {
+            styles.push_back(*(StyleNames *)l->data);
+        }
+        getCatalogue().set_styles(familyName, std::move(styles));
+    }
     return ret;
 }
 
@@ -686,6 +765,7 @@ void FontFactory::AddFontsDir(char const *utf8dir)
     if (res == FcTrue) {
         g_info("Fonts dir '%s' added successfully.", utf8dir);
         pango_fc_font_map_config_changed(PANGO_FC_FONT_MAP(fontServer));
+        catalogue.reset();
     } else {
         g_warning("Could not add fonts dir '%s'.", utf8dir);
     }
@@ -713,6 +793,7 @@ void FontFactory::AddFontFile(char const *utf8file)
     if (res == FcTrue) {
         g_info("Font file '%s' added successfully.", utf8file);
         pango_fc_font_map_config_changed(PANGO_FC_FONT_MAP(fontServer));
+        catalogue.reset();
     } else {
         g_warning("Could not add font file '%s'.", utf8file);
     }
@@ -24,6 +24,7 @@
 
 #include "util/cached_map.h"
 
+class FontCatalogue;
 class FontInstance;
 
 // Constructs a PangoFontDescription from SPStyle. Font size is not included.
@@ -73,6 +74,7 @@ public:
     // Helpfully inserts all font families into the provided map.
     std::map <std::string, PangoFontFamily*> GetUIFamilies();
     // Retrieves style information about a family in a newly allocated GList.
+    // Looked up in the font catalogue first, see font-catalogue.h.
     GList *GetUIStyles(PangoFontFamily *in);
 
     /// Retrieve a FontInstance from a style object, first trying to use the font-specification, the CSS information
@@ -113,6 +115,11 @@ private:
     };
     Inkscape::Util::cached_map<PangoFontDescription*, FontInstance, Hash, Compare> loaded;
 
+    // The styles of the installed families, kept between sessions. Created on first use, and
+    // again after fonts were added.
+    std::unique_ptr<FontCatalogue> catalogue;
+    FontCatalogue &getCatalogue();
+
     // The following two commented out maps were an attempt to allow Inkscape to use font faces
     // that could not be distinguished by CSS values alone. In practice, they never were that
     // useful as PangoFontDescription, which is used throughout our code, cannot distinguish
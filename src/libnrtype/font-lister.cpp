@@ -8,6 +8,7 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <glibmm/main.h>
 #include <glibmm/markup.h>
 #include <glibmm/regex.h>
 
@@ -66,7 +67,13 @@ FontLister::FontLister()
     default_styles = g_list_append(default_styles, new StyleNames("Bold Italic"));
 
     pango_family_map = FontFactory::get().GetUIFamilies();
-    init_font_families();
+
+    // With thousands of fonts, filling the list takes a while. Start with the first group and
+    // add the rest when idle.
+    init_font_families(0, FONT_FAMILIES_GROUP_SIZE);
+    fill_group = 1;
+    fill_connection = Glib::signal_idle().connect(sigc::mem_fun(*this, &FontLister::fill_font_families),
+                                                  Glib::PRIORITY_LOW);
 
     style_list_store = Gtk::ListStore::create(FontStyleList);
     init_default_styles();
@@ -74,6 +81,8 @@ FontLister::FontLister()
 
 FontLister::~FontLister()
 {
+    fill_connection.disconnect();
+
     // Delete default_styles
     for (GList *l = default_styles; l; l = l->next) {
         delete ((StyleNames *)l->data);
@@ -89,6 +98,14 @@ FontLister::~FontLister()
         }
         ++iter;
     }
+
+    // Delete styles looked up for families that were never listed
+    for (auto const &[family, styles] : pending_styles) {
+        for (GList *l = styles; l; l = l->next) {
+            delete ((StyleNames *)l->data);
+        }
+        g_list_free(styles);
+    }
 }
 
 int FontLister::get_font_families_size() {
@@ -112,22 +129,37 @@ void FontLister::init_font_families(int group_offset, int group_size)
 
     if (group_offset <= 0) {
         font_list_store->clear();
-        if (group_offset == 0)
-            insert_font_family("sans-serif");
+        fill_group = -1;
+    }
+
+    // Either all families, or the given group of them.
+    auto begin = pango_family_map.begin();
+    auto end = pango_family_map.end();
+    if (group_offset >= 0 && group_size > 0) {
+        auto const size = pango_family_map.size();
+        auto const offset = std::min<std::size_t>(group_offset * group_size, size);
+        begin = std::next(begin, offset);
+        end = std::next(begin, std::min<std::size_t>(group_size, size - offset));
     }
 
     font_list_store->freeze_notify();
 
     // Traverse through the family names and set up the list store
-    for(auto const &key_val: pango_family_map) {
-        if(!key_val.first.empty()) {
+    for (auto key_val = begin; key_val != end; ++key_val) {
+        if(!key_val->first.empty()) {
             Gtk::TreeModel::iterator treeModelIter = font_list_store->append();
-            (*treeModelIter)[FontList.family] = key_val.first;
+            (*treeModelIter)[FontList.family] = key_val->first;
             // we don't set this now (too slow) but the style will be cached if the user
             // ever decides to use this font
-            (*treeModelIter)[FontList.styles] = nullptr;
+            GList *styles = nullptr;
+            auto pending = pending_styles.find(key_val->first);
+            if (pending != pending_styles.end()) {
+                styles = pending->second;
+                pending_styles.erase(pending);
+            }
+            (*treeModelIter)[FontList.styles] = styles;
             // store the pango representation for generating the style
-            (*treeModelIter)[FontList.pango_family] = key_val.second;
+            (*treeModelIter)[FontList.pango_family] = key_val->second;
             (*treeModelIter)[FontList.onSystem] = true;
         }
     }
@@ -135,6 +167,67 @@ void FontLister::init_font_families(int group_offset, int group_size)
     font_list_store->thaw_notify();
 }
 
+void FontLister::fill_next_group()
+{
+    init_font_families(fill_group++, FONT_FAMILIES_GROUP_SIZE);
+    if (fill_group * FONT_FAMILIES_GROUP_SIZE >= static_cast<int>(pango_family_map.size())) {
+        fill_group = -1;
+    }
+}
+
+bool FontLister::fill_font_families()
+{
+    if (fill_group >= 0) {
+        fill_next_group();
+        return true;
+    }
+
+    // Then look up the styles, so that they are at hand, and in the font catalogue next time.
+    int const rows = font_list_store->children().size();
+    for (int count = 0; count < FONT_STYLES_GROUP_SIZE && fill_style_row < rows; ++fill_style_row) {
+        Gtk::TreePath path;
+        path.push_back(fill_style_row);
+        Gtk::TreeModel::Row row = *font_list_store->get_iter(path);
+        if (row[FontList.onSystem] && row[FontList.pango_family] && !row[FontList.styles]) {
+            row[FontList.styles] = FontFactory::get().GetUIStyles(row[FontList.pango_family]);
+            ++count;
+        }
+    }
+    return fill_style_row < rows;
+}
+
+void FontLister::ensure_font_families()
+{
+    if (fill_group < 0) {
+        return;
+    }
+
+    font_list_store->freeze_notify();
+    while (fill_group >= 0) {
+        fill_next_group();
+    }
+    font_list_store->thaw_notify();
+}
+
+GList *FontLister::get_pending_styles(Glib::ustring const &family)
+{
+    if (fill_group < 0) {
+        return nullptr;
+    }
+
+    auto it = pango_family_map.find(family.raw());
+    if (it == pango_family_map.end() ||
+        std::distance(pango_family_map.begin(), it) < fill_group * FONT_FAMILIES_GROUP_SIZE) {
+        return nullptr; // Not on system, or already in the list.
+    }
+
+    auto &styles = pending_styles[it->first];
+    if (!styles) {
+        styles = FontFactory::get().GetUIStyles(it->second);
+    }
+    return styles;
+}
+
 void FontLister::init_default_styles()
 {
     // Initialize style store with defaults
@@ -151,6 +244,8 @@ void FontLister::init_default_styles()
 
 std::string FontLister::get_font_count_label()
 {
+    ensure_font_families();
+
     std::string label;
 
     int size = font_list_store->children().size();
@@ -199,6 +294,7 @@ void FontLister::show_results(const Glib::ustring& search_text)
     }
 
     // Clear the list store.
+    fill_group = -1;
     font_list_store->freeze_notify();
     font_list_store->clear();
 
@@ -260,6 +356,7 @@ void FontLister::apply_collections(std::set <Glib::ustring>& selected_collection
     }
 
     // Freeze the font list.
+    fill_group = -1;
     font_list_store->freeze_notify();
     font_list_store->clear();
 
@@ -398,6 +495,12 @@ void FontLister::insert_font_family(Glib::ustring new_family)
             }
             ++iter2;
         }
+
+        if (styles == default_styles) {
+            if (auto pending = get_pending_styles(tokens[0])) {
+                styles = pending;
+            }
+        }
     }
 
     Gtk::TreeModel::iterator treeModelIter = font_list_store->prepend();
@@ -453,6 +556,26 @@ int FontLister::add_document_fonts_at_top(SPDocument *document)
 
         GList *styles = default_styles;
 
+        // Add new styles (from 'font-variation-settings', these are not include in GetUIStyles()).
+        auto add_variation_styles = [&] (GList *list) {
+            for (auto j: i.second) {
+                // std::cout << "  Inserting: " << j << std::endl;
+
+                bool exists = false;
+                for(GList *temp = list; temp; temp = temp->next) {
+                    if( ((StyleNames*)temp->data)->CssName.compare( j ) == 0 ) {
+                        exists = true;
+                        break;
+                    }
+                }
+
+                if (!exists) {
+                    list = g_list_append(list, new StyleNames(j,j));
+                }
+            }
+            return list;
+        };
+
         /* See if font-family (or first in fallback list) is on system. If so, get styles. */
         std::vector<Glib::ustring> tokens = Glib::Regex::split_simple(",", i.first);
         if (!tokens.empty() && !tokens[0].empty()) {
@@ -466,28 +589,19 @@ int FontLister::add_document_fonts_at_top(SPDocument *document)
                         row[FontList.styles] = FontFactory::get().GetUIStyles(row[FontList.pango_family]);
                     }
 
-                    // Add new styles (from 'font-variation-settings', these are not include in GetUIStyles()).
-                    for (auto j: i.second) {
-                        // std::cout << "  Inserting: " << j << std::endl;
-
-                        bool exists = false;
-                        for(GList *temp = row[FontList.styles]; temp; temp = temp->next) {
-                            if( ((StyleNames*)temp->data)->CssName.compare( j ) == 0 ) {
-                                exists = true;
-                                break;
-                            }
-                        }
-
-                        if (!exists) {
-                            row[FontList.styles] = g_list_append(row[FontList.styles], new StyleNames(j,j));
-                        }
-                    }
-
+                    row[FontList.styles] = add_variation_styles(row[FontList.styles]);
                     styles = row[FontList.styles];
                     break;
                 }
                 ++iter2;
             }
+
+            // Appending keeps the head of a non-empty list, so it stays the pending one.
+            if (styles == default_styles) {
+                if (auto pending = get_pending_styles(tokens[0])) {
+                    styles = add_variation_styles(pending);
+                }
+            }
         }
 
         Gtk::TreeModel::iterator treeModelIter = font_list_store->prepend();
@@ -822,6 +936,11 @@ std::pair<Glib::ustring, Glib::ustring> FontLister::new_font_family(Glib::ustrin
         ++iter;
     }
 
+    // System font-family that is still to be added to the list.
+    if (styles == nullptr) {
+        styles = get_pending_styles(new_family);
+    }
+
     // Newly typed in font-family may not yet be in list... use default list.
     // TODO: if font-family is list, check if first family in list is on system
     // and set style accordingly.
@@ -1118,6 +1237,12 @@ Gtk::TreeModel::Row FontLister::get_row_for_font(Glib::ustring family)
         ++iter;
     }
 
+    // It may be among the families not listed yet.
+    if (fill_group >= 0) {
+        ensure_font_families();
+        return get_row_for_font(family);
+    }
+
     throw FAMILY_NOT_FOUND;
 }
 
@@ -1222,15 +1347,25 @@ Glib::ustring FontLister::get_best_style_match(Glib::ustring family, Glib::ustri
 
     Glib::ustring fontspec = family + ", " + target_style;
 
-    Gtk::TreeModel::Row row;
-    try
-    {
-        row = get_row_for_font(family);
-    }
-    catch (...)
-    {
-        std::cerr << "FontLister::get_best_style_match(): can't find family: " << family.raw() << std::endl;
-        return (target_style);
+    // Don't wait for the whole list if the family is still to be added.
+    GList *styles = get_pending_styles(family);
+    if (!styles) {
+        Gtk::TreeModel::Row row;
+        try
+        {
+            row = get_row_for_font(family);
+        }
+        catch (...)
+        {
+            std::cerr << "FontLister::get_best_style_match(): can't find family: " << family.raw() << std::endl;
+            return (target_style);
+        }
+
+        styles = default_styles;
+        if (row[FontList.onSystem] && !row[FontList.styles]) {
+            row[FontList.styles] = FontFactory::get().GetUIStyles(row[FontList.pango_family]);
+            styles = row[FontList.styles];
+        }
     }
 
     PangoFontDescription *target = pango_font_description_from_string(fontspec.c_str());
@@ -1238,12 +1373,6 @@ Glib::ustring FontLister::get_best_style_match(Glib::ustring family, Glib::ustri
 
     //font_description_dump( target );
 
-    GList *styles = default_styles;
-    if (row[FontList.onSystem] && !row[FontList.styles]) {
-        row[FontList.styles] = FontFactory::get().GetUIStyles(row[FontList.pango_family]);
-        styles = row[FontList.styles];
-    }
-
     for (GList *l = styles; l; l = l->next) {
         Glib::ustring fontspec = family + ", " + ((StyleNames *)l->data)->CssName;
         PangoFontDescription *candidate = pango_font_description_from_string(fontspec.c_str());
@@ -28,6 +28,7 @@
 #include <gtkmm/treepath.h>
 
 #define FONT_FAMILIES_GROUP_SIZE 30
+#define FONT_STYLES_GROUP_SIZE 10
 
 class SPObject;
 class SPDocument;
@@ -336,6 +337,27 @@ private:
 
 	void font_family_row_update(int start=0);
 
+    /**
+     * The system font families are added to the list a group at a time when idle, followed by
+     * looking up their styles. fill_group is the next group to add, or -1 once all are listed.
+     */
+    int fill_group = -1;
+    int fill_style_row = 0;
+    sigc::connection fill_connection;
+    void fill_next_group();
+    bool fill_font_families();
+
+    /**
+     * Adds the families not listed yet, for when the whole list is needed.
+     */
+    void ensure_font_families();
+
+    /**
+     * Styles of a system family that is not listed yet, or null. They are kept for its row.
+     */
+    GList *get_pending_styles(Glib::ustring const &family);
+    std::map<std::string, GList *> pending_styles;
+
     Glib::RefPtr<Gtk::ListStore> font_list_store;
     Glib::RefPtr<Gtk::ListStore> style_list_store;
 
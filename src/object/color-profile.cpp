@@ -667,6 +667,16 @@ void Inkscape::CMSSystem::doTransform(cmsHTRANSFORM transform, void *inBuf, void
     cmsDoTransform(transform, inBuf, outBuf, size);
 }
 
+Inkscape::CMSTransform::~CMSTransform()
+{
+    cmsDeleteTransform(_handle);
+}
+
+void Inkscape::CMSTransform::apply(void *inBuf, void *outBuf, unsigned int size) const
+{
+    cmsDoTransform(_handle, inBuf, outBuf, size);
+}
+
 bool Inkscape::CMSSystem::isPrintColorSpace(ColorProfile const *profile)
 {
     bool isPrint = false;
@@ -936,7 +946,13 @@ static Gdk::RGBA lastGamutColor("#808080");
 static bool lastBPC = false;
 static int lastIntent = INTENT_PERCEPTUAL;
 static int lastProofIntent = INTENT_PERCEPTUAL;
-static cmsHTRANSFORM transf = nullptr;
+// Renders that are still using a transform keep it alive after it is dropped here.
+static std::shared_ptr<Inkscape::CMSTransform const> transf;
+
+static std::shared_ptr<Inkscape::CMSTransform const> wrap_transform(cmsHTRANSFORM handle)
+{
+    return handle ? std::make_shared<Inkscape::CMSTransform>(handle) : nullptr;
+}
 
 namespace {
 cmsHPROFILE getSystemProfileHandle()
@@ -955,10 +971,7 @@ cmsHPROFILE getSystemProfileHandle()
             if ( theOne ) {
                 cmsCloseProfile( theOne );
             }
-            if ( transf ) {
-                cmsDeleteTransform( transf );
-                transf = nullptr;
-            }
+            transf.reset();
             theOne = cmsOpenProfileFromFile( uri.data(), "r" );
             if ( theOne ) {
                 // a display profile must have the proper stuff
@@ -982,10 +995,7 @@ cmsHPROFILE getSystemProfileHandle()
         cmsCloseProfile( theOne );
         theOne = nullptr;
         lastURI.clear();
-        if ( transf ) {
-            cmsDeleteTransform( transf );
-            transf = nullptr;
-        }
+        transf.reset();
     }
 
     return theOne;
@@ -1009,10 +1019,7 @@ cmsHPROFILE getProofProfileHandle()
             if ( theOne ) {
                 cmsCloseProfile( theOne );
             }
-            if ( transf ) {
-                cmsDeleteTransform( transf );
-                transf = nullptr;
-            }
+            transf.reset();
             theOne = cmsOpenProfileFromFile( uri.data(), "r" );
             if ( theOne ) {
                 // a display profile must have the proper stuff
@@ -1042,10 +1049,7 @@ cmsHPROFILE getProofProfileHandle()
         cmsCloseProfile( theOne );
         theOne = nullptr;
         lastURI.clear();
-        if ( transf ) {
-            cmsDeleteTransform( transf );
-            transf = nullptr;
-        }
+        transf.reset();
     }
 
     return theOne;
@@ -1054,15 +1058,12 @@ cmsHPROFILE getProofProfileHandle()
 
 static void free_transforms();
 
-cmsHTRANSFORM Inkscape::CMSSystem::getDisplayTransform()
+std::shared_ptr<Inkscape::CMSTransform const> Inkscape::CMSSystem::getDisplayTransform()
 {
     Inkscape::Preferences *prefs = Inkscape::Preferences::get();
     bool fromDisplay = prefs->getBool( "/options/displayprofile/from_display");
     if ( fromDisplay ) {
-        if ( transf ) {
-            cmsDeleteTransform(transf);
-            transf = nullptr;
-        }
+        transf.reset();
         return nullptr;
     }
 
@@ -1111,9 +1112,9 @@ cmsHTRANSFORM Inkscape::CMSSystem::getDisplayTransform()
             if ( bpc ) {
                 dwFlags |= cmsFLAGS_BLACKPOINTCOMPENSATION;
             }
-            transf = cmsCreateProofingTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, hprof, TYPE_BGRA_8, proofProf, intent, proofIntent, dwFlags );
+            transf = wrap_transform(cmsCreateProofingTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, hprof, TYPE_BGRA_8, proofProf, intent, proofIntent, dwFlags ));
         } else if ( hprof ) {
-            transf = cmsCreateTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, hprof, TYPE_BGRA_8, intent, 0 );
+            transf = wrap_transform(cmsCreateTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, hprof, TYPE_BGRA_8, intent, 0 ));
         }
     }
 
@@ -1128,13 +1129,12 @@ public:
 
     std::string id;
     cmsHPROFILE hprof;
-    cmsHTRANSFORM transf;
+    std::shared_ptr<Inkscape::CMSTransform const> transf;
 };
 
 MemProfile::MemProfile() :
     id(),
-    hprof(nullptr),
-    transf(nullptr)
+    hprof(nullptr)
 {
 }
 
@@ -1145,16 +1145,10 @@ static std::vector<MemProfile> perMonitorProfiles;
 
 void free_transforms()
 {
-    if ( transf ) {
-        cmsDeleteTransform(transf);
-        transf = nullptr;
-    }
+    transf.reset();
 
-    for ( auto profile : perMonitorProfiles ) {
-        if ( profile.transf ) {
-            cmsDeleteTransform(profile.transf);
-            profile.transf = nullptr;
-        }
+    for ( auto &profile : perMonitorProfiles ) {
+        profile.transf.reset();
     }
 }
 
@@ -1198,9 +1192,9 @@ Glib::ustring Inkscape::CMSSystem::setDisplayPer( gpointer buf, guint bufLen, in
     return id;
 }
 
-cmsHTRANSFORM Inkscape::CMSSystem::getDisplayPer(std::string const &id)
+std::shared_ptr<Inkscape::CMSTransform const> Inkscape::CMSSystem::getDisplayPer(std::string const &id)
 {
-    cmsHTRANSFORM result = nullptr;
+    std::shared_ptr<Inkscape::CMSTransform const> result;
     if ( id.empty() ) {
         return nullptr;
     }
@@ -1255,9 +1249,9 @@ cmsHTRANSFORM Inkscape::CMSSystem::getDisplayPer(std::string const &id)
                     if ( bpc ) {
                         dwFlags |= cmsFLAGS_BLACKPOINTCOMPENSATION;
                     }
-                    item.transf = cmsCreateProofingTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, item.hprof, TYPE_BGRA_8, proofProf, intent, proofIntent, dwFlags );
+                    item.transf = wrap_transform(cmsCreateProofingTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, item.hprof, TYPE_BGRA_8, proofProf, intent, proofIntent, dwFlags ));
                 } else if ( item.hprof ) {
-                    item.transf = cmsCreateTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, item.hprof, TYPE_BGRA_8, intent, 0 );
+                    item.transf = wrap_transform(cmsCreateTransform( ColorProfileImpl::getSRGBProfile(), TYPE_BGRA_8, item.hprof, TYPE_BGRA_8, intent, 0 ));
                 }
             }
 
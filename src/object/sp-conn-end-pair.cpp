@@ -68,13 +68,22 @@ void SPConnEndPair::release()
     const bool routerInstanceExists = (_path->document->getRouter() != nullptr);
 
     if (_connRef && routerInstanceExists) {
-        _connRef->router()->deleteConnector(_connRef);
+        _deleteConnRef();
     }
     _connRef = nullptr;
 
     _transformed_connection.disconnect();
 }
 
+void SPConnEndPair::_deleteConnRef()
+{
+    if (auto rerouter = _path->document->getConnectorRerouter()) {
+        rerouter->removeConnector(_path);
+    }
+    _connRef->router()->deleteConnector(_connRef);
+    _connRef = nullptr;
+}
+
 void sp_conn_end_pair_build(SPObject *object)
 {
     object->readAttr(SPAttr::CONNECTOR_TYPE);
@@ -119,8 +128,7 @@ void SPConnEndPair::setAttr(const SPAttr key, gchar const *const value)
             _connType = SP_CONNECTOR_NOAVOID;
 
             if (_connRef) {
-                _connRef->router()->deleteConnector(_connRef);
-                _connRef = nullptr;
+                _deleteConnRef();
                 _transformed_connection.disconnect();
             }
         }
@@ -275,6 +283,9 @@ void SPConnEndPair::update()
         if (!_connRef->isInitialised()) {
             _updateEndPoints();
             _connRef->setCallback(&redrawConnectorCallback, _path);
+            if (auto rerouter = _path->document->getConnectorRerouter()) {
+                rerouter->addConnector(_path);
+            }
         }
     }
 }
@@ -309,11 +320,18 @@ SPCurve SPConnEndPair::createCurve(Avoid::ConnRef *connRef, const gdouble curvat
 {
     g_assert(connRef != nullptr);
 
+    auto curve = createCurve(connRef->displayRoute(), curvature);
+    connRef->calcRouteDist();
+
+    return curve;
+}
+
+// Same, along a route worked out elsewhere
+SPCurve SPConnEndPair::createCurve(Avoid::PolyLine route, const gdouble curvature)
+{
     bool straight = curvature<1e-3;
 
-    Avoid::PolyLine route = connRef->displayRoute();
     if (!straight) route = route.curvedPolyline(curvature);
-    connRef->calcRouteDist();
 
     SPCurve curve;
 
@@ -353,20 +371,27 @@ void SPConnEndPair::tellLibavoidNewEndpoints(bool const processTransaction)
     makePathInvalid();
 
     _updateEndPoints();
+
+    auto rerouter = _path->document->getConnectorRerouter();
     if (processTransaction) {
         _connRef->router()->processTransaction();
+        if (rerouter) {
+            rerouter->routed();
+        }
+    } else if (rerouter) {
+        rerouter->invalidate();
     }
     return;
 }
 
-bool SPConnEndPair::reroutePathFromLibavoid()
+bool SPConnEndPair::reroutePathFromLibavoid(Avoid::PolyLine const *route)
 {
     if (!_connRef || !isAutoRoutingConn()) {
         // Do nothing
         return false;
     }
 
-    auto curve = createCurve(_connRef, _connCurvature);
+    auto curve = route ? createCurve(*route, _connCurvature) : createCurve(_connRef, _connCurvature);
 
     auto doc2item = _path->i2doc_affine().inverse();
     curve.transform(doc2item);
@@ -46,8 +46,9 @@ public:
     SPConnEnd **getConnEnds();
     bool isOrthogonal() const;
     static SPCurve createCurve(Avoid::ConnRef *connRef, double curvature);
+    static SPCurve createCurve(Avoid::PolyLine route, double curvature);
     void tellLibavoidNewEndpoints(bool const processTransaction = false);
-    bool reroutePathFromLibavoid();
+    bool reroutePathFromLibavoid(Avoid::PolyLine const *route = nullptr);
     void makePathInvalid();
     void update();
     bool isAutoRoutingConn() const;
@@ -55,6 +56,7 @@ public:
 
 private:
     void _updateEndPoints();
+    void _deleteConnRef();
 
     SPConnEnd *_connEnd[2];
 
@@ -131,10 +131,11 @@ static bool try_get_intersect_point_with_item(SPPath* conn, SPItem* item,
 }
 
 
-static void sp_conn_get_route_and_redraw(SPPath *const path, const bool updatePathRepr = true)
+static void sp_conn_get_route_and_redraw(SPPath *const path, const bool updatePathRepr = true,
+                                         Avoid::PolyLine const *route = nullptr)
 {
     // Get the new route around obstacles.
-    bool rerouted = path->connEndPair.reroutePathFromLibavoid();
+    bool rerouted = path->connEndPair.reroutePathFromLibavoid(route);
     if (!rerouted) {
         return;
     }
@@ -191,9 +192,13 @@ void sp_conn_reroute_path_immediate(SPPath *const path)
     sp_conn_get_route_and_redraw(path, false);
 }
 
-void sp_conn_redraw_path(SPPath *const path)
+/**
+ * Redraw a connector along its route, or along \a route if given, which was worked out elsewhere
+ * for the connector's current endpoints.
+ */
+void sp_conn_redraw_path(SPPath *const path, Avoid::PolyLine const *route)
 {
-    sp_conn_get_route_and_redraw(path);
+    sp_conn_get_route_and_redraw(path, true, route);
 }
 
 
@@ -18,6 +18,11 @@
 
 class SPPath;
 
+namespace Avoid {
+class Polygon;
+using PolyLine = Polygon;
+} // namespace Avoid
+
 class SPConnEnd {
 public:
     SPConnEnd(SPObject *owner);
@@ -54,7 +59,7 @@ void sp_conn_end_href_changed(SPObject *old_ref, SPObject *ref,
                               SPConnEnd *connEnd, SPPath *path, unsigned const handle_ix);
 void sp_conn_reroute_path(SPPath *const path);
 void sp_conn_reroute_path_immediate(SPPath *const path);
-void sp_conn_redraw_path(SPPath *const path);
+void sp_conn_redraw_path(SPPath *const path, Avoid::PolyLine const *route = nullptr);
 void sp_conn_end_detach(SPObject *const owner, unsigned const handle_ix);
 
 #endif /* !SEEN_SP_CONN_END */
@@ -42,7 +42,7 @@ void SPDefs::update(SPCtx *ctx, guint flags) {
     }
 
     flags &= SP_OBJECT_MODIFIED_CASCADE;
-    std::vector<SPObject*> l(this->childList(true));
+    std::vector<SPObject*> l(flags ? childList(true) : updateDirtyChildList());
     for(auto child : l){
         if (flags || (child->uflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG))) {
             child->updateDisplay(ctx, flags);
@@ -57,12 +57,7 @@ void SPDefs::modified(unsigned int flags) {
     }
 
     flags &= SP_OBJECT_MODIFIED_CASCADE;
-    std::vector<SPObject *> l;
-    for (auto& child: children) {
-        sp_object_ref(&child);
-        l.push_back(&child);
-    }
-
+    std::vector<SPObject *> l(flags ? childList(true) : modifiedDirtyChildList());
     for (auto child:l) {
         if (flags || (child->mflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG))) {
             child->emitModified(flags);
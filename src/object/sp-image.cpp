@@ -20,7 +20,12 @@
 
 #include <cstring>
 #include <algorithm>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <glibmm.h>
 #include <glib/gstdio.h>
 #include <2geom/rect.h>
@@ -32,6 +37,10 @@
 #include "snap-preferences.h"
 #include "preferences.h"
 
+#include "async/async.h"
+#include "async/channel.h"
+#include "display/control/canvas-item-drawing.h"
+#include "display/drawing.h"
 #include "display/drawing-image.h"
 #include "display/cairo-utils.h"
 #include "display/curve.h"
@@ -45,6 +54,7 @@
 #include "xml/href-attribute-helper.h"
 #include "preferences.h"
 #include "io/sys.h"
+#include "ui/widget/canvas.h"
 
 #include "cms-system.h"
 #include "color-profile.h"
@@ -70,8 +80,98 @@
 // TODO: also check if it is correct to be using two different epsilon values
 
 static void sp_image_set_curve(SPImage *image);
-static void sp_image_update_arenaitem (SPImage *img, Inkscape::DrawingImage *ai);
-static void sp_image_update_canvas_image (SPImage *image);
+
+namespace {
+
+/**
+ * Runs image decoding jobs on a few background threads.
+ */
+class DecodeQueue
+{
+public:
+    void push(std::function<void()> job)
+    {
+        auto const max_workers = Inkscape::Preferences::get()->getIntLimited("/options/threading/numthreads", std::thread::hardware_concurrency(), 1, 256);
+
+        auto lock = std::lock_guard(_mutex);
+        _jobs.push_back(std::move(job));
+        if (_workers < max_workers) {
+            _workers++;
+            Inkscape::Async::fire_and_forget([this] { _run(); });
+        }
+    }
+
+private:
+    std::mutex _mutex;
+    std::deque<std::function<void()>> _jobs;
+    int _workers = 0;
+
+    void _run()
+    {
+        while (true) {
+            std::function<void()> job;
+            {
+                auto lock = std::lock_guard(_mutex);
+                if (_jobs.empty()) {
+                    _workers--;
+                    return;
+                }
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+DecodeQueue &decode_queue()
+{
+    // Never destroyed, since workers can still be running during static destruction.
+    static auto queue = new DecodeQueue();
+    return *queue;
+}
+
+/// Lazily decoded images currently holding pixels, most recently used first.
+std::list<SPImage *> decoded_images;
+std::size_t decoded_bytes = 0;
+
+} // namespace
+
+/**
+ * State of an image that is decoded from its href when needed, rather than when it is loaded.
+ * The href stays the source of truth, so the decoded pixels can be dropped at any time.
+ */
+struct SPImage::LazyDecode
+{
+    std::string path; ///< local file to decode; empty for data URIs
+    Inkscape::Async::Channel::Dest dest; ///< closing it drops the results of decodes in flight
+    std::shared_ptr<Inkscape::Async::Channel::Source const> source;
+    bool in_flight = false;
+    time_t mtime = 0; ///< of the file at path when its size was read
+
+    std::optional<std::list<SPImage *>::iterator> tracked; ///< position in decoded_images
+    std::size_t bytes = 0;
+
+    ~LazyDecode() { untrack(); }
+
+    void track(SPImage *image, std::size_t size)
+    {
+        untrack();
+        decoded_images.push_front(image);
+        tracked = decoded_images.begin();
+        bytes = size;
+        decoded_bytes += bytes;
+    }
+
+    void untrack()
+    {
+        if (tracked) {
+            decoded_images.erase(*tracked);
+            decoded_bytes -= bytes;
+            tracked.reset();
+        }
+    }
+};
 
 #ifdef DEBUG_LCMS
 extern guint update_in_progress;
@@ -151,7 +251,7 @@ void SPImage::release() {
         this->href = nullptr;
     }
 
-    pixbuf.reset();
+    _resetImage();
 
     if (this->color_profile) {
         g_free (this->color_profile);
@@ -315,7 +415,7 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
     SPItem::update(ctx, flags);
 
     if (flags & SP_IMAGE_HREF_MODIFIED_FLAG) {
-        pixbuf.reset();
+        _resetImage();
         if (href) {
             Inkscape::Pixbuf *pb = nullptr;
             double svgdpi = 96;
@@ -323,24 +423,29 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
                 svgdpi = g_ascii_strtod(getRepr()->attribute("inkscape:svg-dpi"), nullptr);
             }
             dpi = svgdpi;
-            pb = readImage(Inkscape::getHrefAttribute(*getRepr()).second,
-                           getRepr()->attribute("sodipodi:absref"),
-                           document->getDocumentBase(), svgdpi);
-            if (!pb) {
-                missing = true;
-                // Passing in our previous size allows us to preserve the image's expected size.
-                auto broken_width = width._set ? width.computed : 640;
-                auto broken_height = height._set ? height.computed : 640;
-                pb = getBrokenImage(broken_width, broken_height);
-            }
-            else {
+            if (_prepareLazy()) {
                 missing = false;
-            }
+            } else {
+                pb = readImage(Inkscape::getHrefAttribute(*getRepr()).second,
+                               getRepr()->attribute("sodipodi:absref"),
+                               document->getDocumentBase(), svgdpi);
+                if (!pb) {
+                    missing = true;
+                    // Passing in our previous size allows us to preserve the image's expected size.
+                    auto broken_width = width._set ? width.computed : 640;
+                    auto broken_height = height._set ? height.computed : 640;
+                    pb = getBrokenImage(broken_width, broken_height);
+                }
+                else {
+                    missing = false;
+                }
 
-            if (pb) {
-                if (color_profile) apply_profile(pb);
-                pb->ensurePixelFormat(Inkscape::Pixbuf::PF_CAIRO); // Expected by rendering code, so convert now before making immutable.
-                pixbuf = std::shared_ptr<Inkscape::Pixbuf>(pb);
+                if (pb) {
+                    if (color_profile) apply_profile(pb);
+                    pb->ensurePixelFormat(Inkscape::Pixbuf::PF_CAIRO); // Expected by rendering code, so convert now before making immutable.
+                    _pixbuf = std::shared_ptr<Inkscape::Pixbuf>(pb);
+                    _pixel_size = Geom::IntPoint(pb->width(), pb->height());
+                }
             }
         }
     }
@@ -349,7 +454,8 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
 
     // Why continue without a pixbuf? So we can display "Missing Image" png.
     // Eventually, we should properly support SVG image type (i.e. render it ourselves).
-    if (this->pixbuf) {
+    bool const has_image = _pixbuf || _lazy;
+    if (has_image) {
         if (!this->x._set) {
             this->x.unit = SVGLength::PX;
             this->x.computed = 0;
@@ -362,12 +468,12 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
 
         if (!this->width._set) {
             this->width.unit = SVGLength::PX;
-            this->width.computed = this->pixbuf->width();
+            this->width.computed = _pixel_size.x();
         }
 
         if (!this->height._set) {
             this->height.unit = SVGLength::PX;
-            this->height.computed = this->pixbuf->height();
+            this->height.computed = _pixel_size.y();
         }
     }
 
@@ -383,10 +489,10 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
     this->ox = this->x.computed;
     this->oy = this->y.computed;
 
-    if (this->pixbuf) {
+    if (has_image) {
 
         // Viewbox is either from SVG (not supported) or dimensions of pixbuf (PNG, JPG)
-        this->viewBox = Geom::Rect::from_xywh(0, 0, this->pixbuf->width(), this->pixbuf->height()); 
+        this->viewBox = Geom::Rect::from_xywh(0, 0, _pixel_size.x(), _pixel_size.y());
         this->viewBox_set = true;
 
         // SPItemCtx rctx =
@@ -400,19 +506,19 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
 
     // TODO: eliminate ox, oy, sx, sy
 
-    sp_image_update_canvas_image ((SPImage *) this);
+    _updateCanvasImage();
 
     // don't crash with missing xlink:href attribute
-    if (!this->pixbuf) {
+    if (!has_image) {
         return;
     }
 
-    double proportion_pixbuf = this->pixbuf->height() / (double)this->pixbuf->width();
+    double proportion_pixbuf = _pixel_size.y() / (double)_pixel_size.x();
     double proportion_image = this->height.computed / (double)this->width.computed;
     if (this->prev_width &&
-        (this->prev_width != this->pixbuf->width() || this->prev_height != this->pixbuf->height())) {
-        if (std::abs(this->prev_width - this->pixbuf->width()) > std::abs(this->prev_height - this->pixbuf->height())) {
-            proportion_pixbuf = this->pixbuf->width() / (double)this->pixbuf->height();
+        (this->prev_width != _pixel_size.x() || this->prev_height != _pixel_size.y())) {
+        if (std::abs(this->prev_width - _pixel_size.x()) > std::abs(this->prev_height - _pixel_size.y())) {
+            proportion_pixbuf = _pixel_size.x() / (double)_pixel_size.y();
             proportion_image = this->width.computed / (double)this->height.computed;
             if (proportion_pixbuf != proportion_image) {
                 double new_height = this->height.computed * proportion_pixbuf;
@@ -426,8 +532,8 @@ void SPImage::update(SPCtx *ctx, unsigned int flags) {
             }
         }
     }
-    this->prev_width = this->pixbuf->width();
-    this->prev_height = this->pixbuf->height();
+    this->prev_width = _pixel_size.x();
+    this->prev_height = _pixel_size.y();
 }
 
 void SPImage::modified(unsigned int flags) {
@@ -489,6 +595,7 @@ Geom::OptRect SPImage::bbox(Geom::Affine const &transform, SPItem::BBoxType /*ty
 }
 
 void SPImage::print(SPPrintContext *ctx) {
+    auto pixbuf = getPixbuf();
     if (pixbuf && width.computed > 0.0 && height.computed > 0.0) {
         auto pb = *pixbuf;
         pb.ensurePixelFormat(Inkscape::Pixbuf::PF_GDK);
@@ -529,14 +636,15 @@ gchar* SPImage::description() const {
         href_desc = g_strdup("(null_pointer)"); // we call g_free() on href_desc
     }
 
-    char *ret = ( !pixbuf
+    bool const has_image = _pixbuf || _lazy;
+    char *ret = ( !has_image
                   ? g_strdup_printf(_("[bad reference]: %s"), href_desc)
                   : g_strdup_printf(_("%d &#215; %d: %s"),
-                                    pixbuf->width(),
-                                    pixbuf->height(),
+                                    _pixel_size.x(),
+                                    _pixel_size.y(),
                                     href_desc) );
 
-    if (!pixbuf && document)
+    if (!has_image && document)
     {
         Inkscape::Pixbuf * pb = nullptr;
         double svgdpi = 96;
@@ -563,13 +671,213 @@ gchar* SPImage::description() const {
 }
 
 Inkscape::DrawingItem* SPImage::show(Inkscape::Drawing &drawing, unsigned int /*key*/, unsigned int /*flags*/) {
+    // Drawings that are not shown on a canvas, such as for export, need the pixels right away.
+    if (!drawing.getCanvasItemDrawing()) {
+        getPixbuf();
+    }
+
     Inkscape::DrawingImage *ai = new Inkscape::DrawingImage(drawing);
 
-    sp_image_update_arenaitem(this, ai);
+    _updateArenaItem(ai);
 
     return ai;
 }
 
+std::shared_ptr<Inkscape::Pixbuf const> SPImage::getPixbuf() const
+{
+    if (_lazy) {
+        // Decoding changes what is at hand, not what the image is.
+        auto self = const_cast<SPImage *>(this);
+        if (_pixbuf) {
+            self->_lazy->track(self, _lazy->bytes);
+        } else {
+            // Pixels handed out here must stay alive while the caller uses them, so this does not
+            // evict other images; only decodes in the background do.
+            self->_setDecoded(std::shared_ptr<Inkscape::Pixbuf const>(_decodeJob()()));
+        }
+    }
+    return _pixbuf;
+}
+
+/**
+ * Set up lazy decoding if the image is a raster image whose size can be read from its header.
+ * Returns false if it has to be read right away instead.
+ */
+bool SPImage::_prepareLazy()
+{
+    // Images with a color profile are converted using the document's profiles on the main thread.
+    if (color_profile || !Inkscape::Preferences::get()->getBool("/options/images/lazydecode", true)) {
+        return false;
+    }
+
+    auto const link = Inkscape::getHrefAttribute(*getRepr()).second;
+    if (!link) {
+        return false;
+    }
+
+    std::optional<Geom::IntPoint> size;
+    std::string path;
+    time_t mtime = 0;
+    if (g_ascii_strncasecmp(link, "data:", 5) == 0) {
+        size = Inkscape::Pixbuf::probe_data_uri(link + 5);
+    } else {
+        auto url = Inkscape::URI::from_href_and_basedir(link, document->getDocumentBase());
+        if (url.hasScheme("file")) {
+            path = url.toNativeFilename();
+            size = Inkscape::Pixbuf::probe_file(path);
+            GStatBuf st;
+            if (size && g_stat(path.c_str(), &st) == 0) {
+                mtime = st.st_mtime;
+            }
+        }
+    }
+
+    if (!size) {
+        return false;
+    }
+
+    auto [src, dst] = Inkscape::Async::Channel::create();
+    _lazy = std::make_unique<LazyDecode>();
+    _lazy->path = std::move(path);
+    _lazy->mtime = mtime;
+    _lazy->dest = std::move(dst);
+    _lazy->source = std::make_shared<Inkscape::Async::Channel::Source const>(std::move(src));
+    _pixel_size = *size;
+    return true;
+}
+
+/**
+ * Return a function that decodes the image and can be run on any thread.
+ */
+std::function<Inkscape::Pixbuf *()> SPImage::_decodeJob() const
+{
+    auto finish = [] (Inkscape::Pixbuf *pb) {
+        if (pb) {
+            pb->ensurePixelFormat(Inkscape::Pixbuf::PF_CAIRO);
+        }
+        return pb;
+    };
+
+    if (!_lazy->path.empty()) {
+        return [finish, path = _lazy->path, svgdpi = dpi] {
+            return finish(Inkscape::Pixbuf::create_from_file(path, svgdpi));
+        };
+    }
+
+    auto const link = Inkscape::getHrefAttribute(*getRepr()).second;
+    if (!link || g_ascii_strncasecmp(link, "data:", 5) != 0) {
+        return [] () -> Inkscape::Pixbuf * { return nullptr; };
+    }
+
+    // Copy the data, since the attribute can change while it is being decoded.
+    return [finish, uri = std::string(link + 5), svgdpi = dpi] {
+        return finish(Inkscape::Pixbuf::create_from_data_uri(uri.c_str(), svgdpi));
+    };
+}
+
+void SPImage::_decodeInBackground()
+{
+    if (!_lazy || _pixbuf || _lazy->in_flight) {
+        return;
+    }
+    _lazy->in_flight = true;
+
+    decode_queue().push([this, job = _decodeJob(), source = _lazy->source] {
+        if (!*source) {
+            return; // The image was changed or released in the meantime.
+        }
+
+        auto pb = std::shared_ptr<Inkscape::Pixbuf const>(job());
+
+        source->run([this, pb = std::move(pb)] {
+            _lazy->in_flight = false;
+            if (_pixbuf) {
+                return; // Decoded on demand in the meantime.
+            }
+            _setDecoded(pb);
+
+            // Keep the pixels of the images used last within budget. Images on screen keep theirs,
+            // since they would only be decoded again right away.
+            auto const budget = std::size_t(Inkscape::Preferences::get()->getIntLimited("/options/images/decodedbudget", 1024, 16, 1 << 20)) * 1024 * 1024; // MiB
+            for (auto it = decoded_images.end(); it != decoded_images.begin() && decoded_bytes > budget; ) {
+                auto image = *--it;
+                if (image != this && !image->_isShown()) {
+                    auto next = std::next(it);
+                    image->_evict();
+                    it = next;
+                }
+            }
+        });
+    });
+}
+
+void SPImage::_setDecoded(std::shared_ptr<Inkscape::Pixbuf const> pb)
+{
+    if (!pb) {
+        missing = true;
+        auto broken_width = width._set ? width.computed : 640;
+        auto broken_height = height._set ? height.computed : 640;
+        pb.reset(getBrokenImage(broken_width, broken_height));
+    }
+
+    _pixbuf = std::move(pb);
+    _lazy->track(this, static_cast<std::size_t>(_pixbuf->rowstride()) * _pixbuf->height());
+
+    auto const size = Geom::IntPoint(_pixbuf->width(), _pixbuf->height());
+    if (size != _pixel_size) {
+        // The header did not tell the whole story, e.g. because of an orientation tag, or the image
+        // turned out broken. Take the new size without adjusting the element's attributes.
+        _pixel_size = size;
+        prev_width = size.x();
+        prev_height = size.y();
+        requestDisplayUpdate(SP_OBJECT_MODIFIED_FLAG);
+    }
+
+    _updateCanvasImage();
+}
+
+/**
+ * Drop the decoded pixels of a lazily decoded image. They are decoded again when next needed.
+ */
+void SPImage::_evict()
+{
+    _lazy->untrack();
+    _pixbuf.reset();
+    _updateCanvasImage();
+}
+
+/**
+ * Mark a lazily decoded image as used last, since it was rendered.
+ */
+void SPImage::_touch()
+{
+    if (_lazy && _pixbuf) {
+        _lazy->track(this, _lazy->bytes);
+    }
+}
+
+/**
+ * Whether the image is in the visible area of a canvas.
+ */
+bool SPImage::_isShown() const
+{
+    for (auto const &v : views) {
+        auto item = v.drawingitem.get();
+        auto canvas_item = item->drawing().getCanvasItemDrawing();
+        if (canvas_item && item->bbox() && item->visible() && item->bbox()->intersects(canvas_item->get_canvas()->get_area_world())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SPImage::_resetImage()
+{
+    _lazy.reset();
+    _pixbuf.reset();
+    _pixel_size = {};
+}
+
 
 Inkscape::Pixbuf *SPImage::readImage(gchar const *href, gchar const *absref, gchar const *base, double svgdpi)
 {
@@ -664,21 +972,29 @@ Inkscape::Pixbuf *SPImage::getBrokenImage(double width, double height)
     return inkpb;
 }
 
-/* We assert that realpixbuf is either NULL or identical size to pixbuf */
-static void
-sp_image_update_arenaitem (SPImage *image, Inkscape::DrawingImage *ai)
+void SPImage::_updateArenaItem(Inkscape::DrawingImage *ai)
 {
-    ai->setStyle(image->style);
-    ai->setPixbuf(image->pixbuf);
-    ai->setOrigin(Geom::Point(image->ox, image->oy));
-    ai->setScale(image->sx, image->sy);
-    ai->setClipbox(image->clipbox);
+    ai->setStyle(style);
+    if (!_lazy) {
+        ai->setPixbuf(_pixbuf);
+    } else if (_pixbuf) {
+        ai->setPixbuf(_pixbuf, [this, source = _lazy->source] {
+            source->run([this] { _touch(); });
+        });
+    } else {
+        ai->setPlaceholder(_pixel_size, [this, source = _lazy->source] {
+            source->run([this] { _decodeInBackground(); });
+        });
+    }
+    ai->setOrigin(Geom::Point(ox, oy));
+    ai->setScale(sx, sy);
+    ai->setClipbox(clipbox);
 }
 
-static void sp_image_update_canvas_image(SPImage *image)
+void SPImage::_updateCanvasImage()
 {
-    for (auto &v : image->views) {
-        sp_image_update_arenaitem(image, cast<Inkscape::DrawingImage>(v.drawingitem.get()));
+    for (auto &v : views) {
+        _updateArenaItem(cast<Inkscape::DrawingImage>(v.drawingitem.get()));
     }
 }
 
@@ -872,18 +1188,24 @@ void sp_embed_svg(Inkscape::XML::Node *image_node, std::string const &fn)
 
 void SPImage::refresh_if_outdated()
 {
-    if ( href && pixbuf && pixbuf->modificationTime()) {
+    if (href && _lazy && !_pixbuf && _lazy->mtime) {
+        // Not decoded yet, but its size was read from a file that may have changed since.
+        GStatBuf st;
+        if (g_stat(_lazy->path.c_str(), &st) == 0 && st.st_mtime != _lazy->mtime) {
+            requestDisplayUpdate(SP_OBJECT_MODIFIED_FLAG | SP_IMAGE_HREF_MODIFIED_FLAG);
+        }
+    } else if ( href && _pixbuf && _pixbuf->modificationTime()) {
         // It *might* change
 
         GStatBuf st;
         memset(&st, 0, sizeof(st));
         int val = 0;
-        if (g_file_test (pixbuf->originalPath().c_str(), G_FILE_TEST_EXISTS)){ 
-            val = g_stat(pixbuf->originalPath().c_str(), &st);
+        if (g_file_test (_pixbuf->originalPath().c_str(), G_FILE_TEST_EXISTS)){ 
+            val = g_stat(_pixbuf->originalPath().c_str(), &st);
         }
         if ( !val ) {
             // stat call worked. Check time now
-            if ( st.st_mtime != pixbuf->modificationTime() ) {
+            if ( st.st_mtime != _pixbuf->modificationTime() ) {
                 requestDisplayUpdate(SP_OBJECT_MODIFIED_FLAG | SP_IMAGE_HREF_MODIFIED_FLAG);
             }
         }
@@ -904,7 +1226,7 @@ bool SPImage::cropToArea(Geom::Rect area)
 
     // Apply the image's viewbox and scal to get us image pixels
     area *= Geom::Translate(-x.computed, -y.computed);
-    area *= Geom::Scale(pixbuf->width() / width.computed, pixbuf->height() / height.computed);
+    area *= Geom::Scale(_pixel_size.x() / width.computed, _pixel_size.y() / height.computed);
 
     // Any precision problems and we choose to retain more pixels (roundOut)
     return cropToArea(area.roundOutwards());
@@ -920,6 +1242,10 @@ bool SPImage::cropToArea(Geom::Rect area)
  */
 bool SPImage::cropToArea(const Geom::IntRect &area)
 {
+    auto pixbuf = getPixbuf();
+    if (!pixbuf)
+        return false;
+
     // Contrain requested area to the available pixels.
     auto px = Geom::IntRect::from_xywh(0.0, 0.0, pixbuf->width(), pixbuf->height());
     auto px_area = area & px;
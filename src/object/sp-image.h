@@ -26,11 +26,16 @@
 #include "sp-dimensions.h"
 #include "display/curve.h"
 
+#include <functional>
 #include <memory>
 
 #define SP_IMAGE_HREF_MODIFIED_FLAG SP_OBJECT_USER_MODIFIED_FLAG_A
 
-namespace Inkscape { class Pixbuf; }
+namespace Inkscape {
+class DrawingImage;
+class Pixbuf;
+} // namespace Inkscape
+
 class SPImage final : public SPItem, public SPViewBox, public SPDimensions {
 public:
     SPImage();
@@ -48,7 +53,6 @@ public:
     char *href;
     char *color_profile;
 
-    std::shared_ptr<Inkscape::Pixbuf const> pixbuf;
     bool missing = true;
 
     void build(SPDocument *document, Inkscape::XML::Node *repr) override;
@@ -69,11 +73,36 @@ public:
 
     void apply_profile(Inkscape::Pixbuf *pixbuf);
 
+    /**
+     * The decoded image, or null if there is none. Raster images are decoded lazily in the
+     * background once they are first rendered; this decodes the image now if it is not yet.
+     */
+    std::shared_ptr<Inkscape::Pixbuf const> getPixbuf() const;
+    /// The size of the image in pixels, known without decoding it. Zero if there is no image.
+    Geom::IntPoint pixelSize() const { return _pixel_size; }
+
     SPCurve const *get_curve() const;
     void refresh_if_outdated();
     bool cropToArea(Geom::Rect area);
     bool cropToArea(const Geom::IntRect &area);
 private:
+    struct LazyDecode;
+
+    std::shared_ptr<Inkscape::Pixbuf const> _pixbuf;
+    Geom::IntPoint _pixel_size;
+    std::unique_ptr<LazyDecode> _lazy; ///< set if the image can be decoded from its href when needed
+
+    bool _prepareLazy();
+    std::function<Inkscape::Pixbuf *()> _decodeJob() const;
+    void _decodeInBackground();
+    void _setDecoded(std::shared_ptr<Inkscape::Pixbuf const> pb);
+    void _evict();
+    void _touch();
+    bool _isShown() const;
+    void _resetImage();
+    void _updateArenaItem(Inkscape::DrawingImage *ai);
+    void _updateCanvasImage();
+
     static Inkscape::Pixbuf *readImage(gchar const *href, gchar const *absref, gchar const *base, double svgdpi = 0);
     static Inkscape::Pixbuf *getBrokenImage(double width, double height);
 };
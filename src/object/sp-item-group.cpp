@@ -150,7 +150,8 @@ void SPGroup::update(SPCtx *ctx, unsigned int flags) {
       childflags |= SP_OBJECT_PARENT_MODIFIED_FLAG;
     }
     childflags &= SP_OBJECT_MODIFIED_CASCADE;
-    std::vector<SPObject*> l=this->childList(true, SPObject::ActionUpdate);
+    // Unless the change cascades to all children, only visit those that asked for an update.
+    std::vector<SPObject*> l = childflags ? childList(true, SPObject::ActionUpdate) : updateDirtyChildList();
     for(auto child : l){
         if (childflags || (child->uflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG))) {
             auto item = cast<SPItem>(child);
@@ -199,7 +200,7 @@ void SPGroup::modified(guint flags) {
         }
     }
 
-    std::vector<SPObject*> l=this->childList(true);
+    std::vector<SPObject*> l = flags ? childList(true) : modifiedDirtyChildList();
     for(auto child : l){
         if (flags || (child->mflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG))) {
             child->emitModified(flags);
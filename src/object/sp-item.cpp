@@ -15,6 +15,7 @@
 
 #include "sp-item.h"
 
+#include <cmath>
 #include <glibmm/i18n.h>
 
 #include "bad-uri-exception.h"
@@ -705,6 +706,8 @@ void SPItem::update(SPCtx *ctx, unsigned flags)
     // Any of the modifications defined in sp-object.h might change bbox,
     // so we invalidate it unconditionally
     bbox_valid = false;
+    _geometric_bounds_cache.valid = false;
+    _visual_bounds_cache.valid = false;
 
     viewport = ictx->viewport; // Cache viewport
 
@@ -838,12 +841,83 @@ Geom::OptRect SPItem::bbox(Geom::Affine const & /*transform*/, SPItem::BBoxType
     return Geom::OptRect();
 }
 
+SPItem::BoundsCacheStats &SPItem::boundsCacheStats()
+{
+    static BoundsCacheStats stats;
+    return stats;
+}
+
+void SPItem::invalidateBounds() const
+{
+    for (auto item = this; item; item = cast<SPItem>(item->parent)) {
+        item->bbox_valid = false;
+        item->_geometric_bounds_cache.valid = false;
+        item->_visual_bounds_cache.valid = false;
+    }
+}
+
+/**
+ * Whether bounds computed under one transform are mapped exactly onto those under another by
+ * their difference \a delta. This holds for any axis-aligned scale of the geometry, but stroke
+ * widths (think non-scaling strokes) only survive translations and flips.
+ */
+static bool bounds_follow_transform(Geom::Affine const &delta, bool allow_scale)
+{
+    double constexpr eps = 1e-12;
+    if (!Geom::are_near(delta[1], 0.0, eps) || !Geom::are_near(delta[2], 0.0, eps)) {
+        return false;
+    }
+    if (allow_scale) {
+        return delta[0] != 0.0 && delta[3] != 0.0;
+    }
+    return Geom::are_near(std::abs(delta[0]), 1.0, eps) && Geom::are_near(std::abs(delta[3]), 1.0, eps);
+}
+
+template <typename F>
+Geom::OptRect SPItem::_cachedBounds(BoundsCache &cache, Geom::Affine const &transform, bool allow_scale, F const &compute) const
+{
+    // Pending changes anywhere below show up in our own flags, see requestDisplayUpdate().
+    bool const clean = !uflags && !mflags;
+
+    if (clean && cache.valid) {
+        auto const delta = cache.transform.inverse() * transform;
+        if (bounds_follow_transform(delta, allow_scale)) {
+            boundsCacheStats().hits++;
+            return cache.bounds ? *cache.bounds * delta : Geom::OptRect();
+        }
+    }
+
+    boundsCacheStats().misses++;
+    auto result = compute();
+    if (clean) {
+        cache.valid = true;
+        cache.transform = transform;
+        cache.bounds = result;
+    }
+    return result;
+}
+
 Geom::OptRect SPItem::geometricBounds(Geom::Affine const &transform) const
 {
-    return bbox(transform, SPItem::GEOMETRIC_BBOX);
+    if (!transform.isInvertible()) {
+        return bbox(transform, SPItem::GEOMETRIC_BBOX);
+    }
+    return _cachedBounds(_geometric_bounds_cache, transform, true, [&, this] {
+        return bbox(transform, SPItem::GEOMETRIC_BBOX);
+    });
 }
 
 Geom::OptRect SPItem::visualBounds(Geom::Affine const &transform, bool wfilter, bool wclip, bool wmask) const
+{
+    if (!wfilter || !wclip || !wmask || !transform.isInvertible()) {
+        return _visualBounds(transform, wfilter, wclip, wmask);
+    }
+    return _cachedBounds(_visual_bounds_cache, transform, false, [&, this] {
+        return _visualBounds(transform, true, true, true);
+    });
+}
+
+Geom::OptRect SPItem::_visualBounds(Geom::Affine const &transform, bool wfilter, bool wclip, bool wmask) const
 {
     Geom::OptRect bbox;
 
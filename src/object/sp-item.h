@@ -21,6 +21,7 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <cstddef>
 #include <2geom/forward.h>
 #include <2geom/affine.h>
 #include <2geom/rect.h>
@@ -279,6 +280,20 @@ public:
 
     Geom::OptRect bounds(BBoxType type, Geom::Affine const &transform = Geom::identity()) const;
 
+    /**
+     * Forget the cached bounds of this item and its ancestors. Only needed after changing the
+     * geometry without requesting a display update.
+     */
+    void invalidateBounds() const;
+
+    /// Counters for the bounds cache, for profiling.
+    struct BoundsCacheStats
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+    static BoundsCacheStats &boundsCacheStats();
+
     /**
      * Get item's geometric bbox in document coordinate system.
      * Document coordinates are the default coordinates of the root element:
@@ -447,6 +462,24 @@ private:
     mutable bool _is_evaluated;
     mutable EvaluatedStatus _evaluated_status;
 
+    /**
+     * The result of geometricBounds() or visualBounds() with the default flags for the last
+     * transform asked for. Only trusted while neither the item nor anything in it has a pending
+     * update or modified notification.
+     */
+    struct BoundsCache
+    {
+        bool valid = false;
+        Geom::Affine transform;
+        Geom::OptRect bounds;
+    };
+    mutable BoundsCache _geometric_bounds_cache;
+    mutable BoundsCache _visual_bounds_cache;
+
+    template <typename F>
+    Geom::OptRect _cachedBounds(BoundsCache &cache, Geom::Affine const &transform, bool allow_scale, F const &compute) const;
+    Geom::OptRect _visualBounds(Geom::Affine const &transform, bool wfilter, bool wclip, bool wmask) const;
+
     void clip_ref_changed(SPObject *old_clip, SPObject *clip);
     void mask_ref_changed(SPObject *old_mask, SPObject *mask);
     void fill_ps_ref_changed(SPObject *old_ps, SPObject *ps);
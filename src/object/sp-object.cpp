@@ -415,6 +415,42 @@ std::vector<SPObject*> SPObject::childList(bool add_ref, Action) {
     return l;
 }
 
+std::vector<SPObject*> SPObject::updateDirtyChildList()
+{
+    std::vector<SPObject*> l;
+    for (auto &child : _update_dirty) {
+        sp_object_ref(&child);
+        l.push_back(&child);
+    }
+    return l;
+}
+
+std::vector<SPObject*> SPObject::modifiedDirtyChildList()
+{
+    std::vector<SPObject*> l;
+    for (auto &child : _modified_dirty) {
+        sp_object_ref(&child);
+        l.push_back(&child);
+    }
+    return l;
+}
+
+/// Add this object to its parent's list of children with pending updates, if not already there.
+void SPObject::_markUpdateDirty()
+{
+    if (parent && !_update_dirty_hook.is_linked()) {
+        parent->_update_dirty.push_back(*this);
+    }
+}
+
+/// Add this object to its parent's list of children with pending modified notifications.
+void SPObject::_markModifiedDirty()
+{
+    if (parent && !_modified_dirty_hook.is_linked()) {
+        parent->_modified_dirty.push_back(*this);
+    }
+}
+
 std::vector<SPObject*> SPObject::ancestorList(bool root_to_tip)
 {
     std::vector<SPObject *> ancestors;
@@ -618,6 +654,13 @@ void SPObject::attach(SPObject *object, SPObject *prev)
     }
     children.insert(it, *object);
 
+    if (object->uflags) {
+        object->_markUpdateDirty();
+    }
+    if (object->mflags) {
+        object->_markModifiedDirty();
+    }
+
     if (!object->xml_space.set)
         object->xml_space.value = this->xml_space.value;
 }
@@ -643,6 +686,8 @@ void SPObject::detach(SPObject *object)
     g_return_if_fail(object->parent == this);
 
     children.erase(children.iterator_to(*object));
+    object->_update_dirty_hook.unlink();
+    object->_modified_dirty_hook.unlink();
     object->releaseReferences();
 
     object->parent = nullptr;
@@ -1413,6 +1458,7 @@ void SPObject::requestDisplayUpdate(unsigned int flags)
     if ((this->uflags & flags) !=  flags ) {
         this->uflags |= flags;
     }
+    _markUpdateDirty();
     /* If requestModified has already been called on this object or one of its children, then we
      * don't need to set CHILD_MODIFIED on our ancestors because it's already been done.
      */
@@ -1450,8 +1496,12 @@ void SPObject::updateDisplay(SPCtx *ctx, unsigned int flags)
     flags |= this->uflags;
     /* Copy flags to modified cascade for later processing */
     this->mflags |= this->uflags;
+    if (this->mflags) {
+        _markModifiedDirty();
+    }
     /* We have to clear flags here to allow rescheduling update */
     this->uflags = 0;
+    _update_dirty_hook.unlink();
 
     // Merge style if we have good reasons to think that parent style is changed */
     /** \todo
@@ -1507,6 +1557,7 @@ void SPObject::requestModified(unsigned int flags)
     bool already_propagated = (!(this->mflags & (SP_OBJECT_MODIFIED_FLAG | SP_OBJECT_CHILD_MODIFIED_FLAG)));
 
     this->mflags |= flags;
+    _markModifiedDirty();
 
     /* If requestModified has already been called on this object or one of its children, then we
      * don't need to set CHILD_MODIFIED on our ancestors because it's already been done.
@@ -1541,6 +1592,7 @@ void SPObject::emitModified(unsigned int flags)
      * make changes and therefore queue new modification notifications
      * themselves. */
     this->mflags = 0;
+    _modified_dirty_hook.unlink();
 
     sp_object_ref(this);
 
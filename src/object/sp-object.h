@@ -298,6 +298,17 @@ public:
      */
     std::vector<SPObject*> childList(bool add_ref, Action action = ActionGeneral);
 
+    /**
+     * Retrieves the children that have a pending update, ref'ing them. Unlike childList(), the
+     * cost depends only on how many children changed, not on how many there are.
+     */
+    std::vector<SPObject*> updateDirtyChildList();
+
+    /**
+     * Retrieves the children that have a pending modified notification, ref'ing them.
+     */
+    std::vector<SPObject*> modifiedDirtyChildList();
+
 
     /**
      * Retrieves a list of ancestors of the object, as an easy to use vector
@@ -864,6 +875,23 @@ protected:
     typedef boost::intrusive::list_member_hook<> ListHook;
     ListHook _child_hook;
 
+    // Membership in the parent's lists of children with non-zero uflags and mflags respectively.
+    // Auto-unlinking, so that a destroyed child never stays behind in a list.
+    typedef boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>> DirtyHook;
+    DirtyHook _update_dirty_hook;
+    DirtyHook _modified_dirty_hook;
+
+    template <DirtyHook SPObject::*Hook>
+    using DirtyList = boost::intrusive::list<
+        SPObject,
+        boost::intrusive::member_hook<SPObject, DirtyHook, Hook>,
+        boost::intrusive::constant_time_size<false>>;
+    DirtyList<&SPObject::_update_dirty_hook> _update_dirty;
+    DirtyList<&SPObject::_modified_dirty_hook> _modified_dirty;
+
+    void _markUpdateDirty();
+    void _markModifiedDirty();
+
 public:
     using ChildrenList = boost::intrusive::list<
         SPObject,
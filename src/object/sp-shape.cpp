@@ -1153,6 +1153,7 @@ void SPShape::setCurveBeforeLPE(SPCurve const *new_curve)
 void SPShape::setCurveInsync(SPCurve new_curve)
 {
     _curve = std::make_shared<SPCurve>(std::move(new_curve));
+    invalidateBounds();
 }
 void SPShape::setCurveInsync(SPCurve const *new_curve)
 {
@@ -1160,6 +1161,7 @@ void SPShape::setCurveInsync(SPCurve const *new_curve)
         setCurveInsync(*new_curve);
     } else {
         _curve.reset();
+        invalidateBounds();
     }
 }
 
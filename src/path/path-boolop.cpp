@@ -377,6 +377,75 @@ sp_pathvector_boolop(Geom::PathVector const &pathva, Geom::PathVector const &pat
     return outres;
 }
 
+/**
+ * @brief Computes the difference of a path and the eraser stroke, both in the same coordinates.
+ *        Only the subpaths of either that are near each other, as told by their bounding boxes,
+ *        go into the boolean operation. The others are kept as they are: since they lie outside
+ *        the bounding boxes of the rest, no fill rule lets them interact with it.
+ * @param pathv - the path to be erased.
+ * @param eraser - the eraser stroke, filled with the nonzero rule.
+ * @param rule - the fill rule of the path.
+ * @return the erased path, or nothing if the eraser does not come near it.
+ */
+std::optional<Geom::PathVector> sp_pathvector_erase_near(Geom::PathVector const &pathv, Geom::PathVector const &eraser,
+                                                         FillRule rule)
+{
+    auto const bounds = pathv.boundsFast();
+    if (!bounds) {
+        return {};
+    }
+
+    std::vector<bool> near(pathv.size());
+    std::vector<bool> cutting(eraser.size());
+    Geom::OptRect region;
+
+    // Start with the parts of the stroke over the path, then take in whatever overlaps.
+    for (std::size_t i = 0; i < eraser.size(); i++) {
+        auto const box = eraser[i].boundsFast();
+        if (box && box->intersects(*bounds)) {
+            cutting[i] = true;
+            region.unionWith(box);
+        }
+    }
+    if (!region) {
+        return {};
+    }
+
+    auto grow = [&] (Geom::PathVector const &paths, std::vector<bool> &taken) {
+        bool grown = false;
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            if (taken[i]) {
+                continue;
+            }
+            auto const box = paths[i].boundsFast();
+            if (box && box->intersects(*region)) {
+                taken[i] = true;
+                region.unionWith(box);
+                grown = true;
+            }
+        }
+        return grown;
+    };
+    while (grow(pathv, near) | grow(eraser, cutting)) {}
+
+    Geom::PathVector operand, kept, cutter;
+    for (std::size_t i = 0; i < pathv.size(); i++) {
+        (near[i] ? operand : kept).push_back(pathv[i]);
+    }
+    if (operand.empty()) {
+        return {};
+    }
+    for (std::size_t i = 0; i < eraser.size(); i++) {
+        if (cutting[i]) {
+            cutter.push_back(eraser[i]);
+        }
+    }
+
+    auto result = sp_pathvector_boolop(cutter, operand, bool_op_diff, fill_nonZero, rule);
+    result.insert(result.end(), kept.begin(), kept.end());
+    return result;
+}
+
 /**
  * Workaround for buggy Path::Transform() which incorrectly transforms arc commands.
  *
@@ -10,6 +10,7 @@
 #ifndef PATH_BOOLOP_H
 #define PATH_BOOLOP_H
 
+#include <optional>
 #include <2geom/path.h>
 #include "livarot/Path.h"       // FillRule
 #include "object/object-set.h"  // bool_op
@@ -19,6 +20,8 @@ Geom::PathVector sp_pathvector_boolop(Geom::PathVector const &pathva, Geom::Path
                                       FillRule fra, FillRule frb, bool livarotonly, bool flattenbefore, int &error);
 Geom::PathVector sp_pathvector_boolop(Geom::PathVector const &pathva, Geom::PathVector const &pathvb, bool_op bop,
                                       FillRule fra, FillRule frb, bool livarotonly = false, bool flattenbefore = true);
+std::optional<Geom::PathVector> sp_pathvector_erase_near(Geom::PathVector const &pathv, Geom::PathVector const &eraser,
+                                                         FillRule rule);
 
 #endif // PATH_BOOLOP_H
 
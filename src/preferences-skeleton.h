@@ -362,7 +362,9 @@ static char const preferences_skeleton[] =
            allow_net_access="0"/>
     </group>
     <group id="forkgradientvectors" value="1"/>
-    <group id="autosave" enable="1" interval="10" path="" max="50"/>
+    <group id="autosave" enable="1" interval="10" path="" max="50" compress="0"/>
+    <group id="progressiveopen" enable="1" threshold="50" batchsize="20000"/>
+    <group id="images" lazydecode="1" decodedbudget="1024"/>
     <group id="grids"
       no_emphasize_when_zoomedout="0">
       <group id="xy"
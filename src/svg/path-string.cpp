@@ -12,6 +12,9 @@
  */
 
 #include "svg/path-string.h"
+
+#include <charconv>
+
 #include "svg/stringstream.h"
 #include "svg/svg.h"
 #include "preferences.h"
@@ -151,7 +154,13 @@ void Inkscape::SVG::PathString::State::appendNumber(double v, int precision, int
 void Inkscape::SVG::PathString::State::appendNumber(double v, double &rv, int precision, int minexp) {
     size_t const oldsize = str.size();
     appendNumber(v, precision, minexp);
-    char* begin_of_num = const_cast<char*>(str.data()+oldsize); // Slightly evil, I know (but std::string should be storing its data in one big block of memory, so...)
+    char const *begin_of_num = str.data() + oldsize;
+#if __cpp_lib_to_chars >= 201611L
+    // Locale independent and doesn't need a terminated string
+    if (std::from_chars(begin_of_num, str.data() + str.size(), rv).ec == std::errc()) {
+        return;
+    }
+#endif
     sp_svg_number_read_d(begin_of_num, &rv);
 }
 
@@ -8,6 +8,9 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 #include "svg/stringstream.h"
+
+#include <charconv>
+
 #include "svg/strip-trailing-zeros.h"
 #include "preferences.h"
 #include <2geom/point.h>
@@ -40,6 +43,17 @@ Inkscape::SVGOStringStream::operator<<(double d)
         }
     }
 
+#if __cpp_lib_to_chars >= 201611L
+    // Same result as "%.*g" in the C locale, which is what the stream fallback below produces
+    // after stripping trailing zeros, without the cost of a stream per number.
+    char buf[32];
+    auto const res = std::to_chars(buf, buf + sizeof(buf), d, std::chars_format::general, os.precision());
+    if (res.ec == std::errc()) {
+        ostr.write(buf, res.ptr - buf);
+        return os;
+    }
+#endif
+
     std::ostringstream s;
     s.imbue(std::locale::classic());
     s.flags(os.setf(std::ios::showpoint));
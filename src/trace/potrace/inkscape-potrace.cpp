@@ -14,15 +14,23 @@
  * is provided by the generosity of Peter Selinger, to whom we are grateful.
  *
  */
+#include <algorithm>
+#include <exception>
 #include <iomanip>
+#include <thread>
+#include <vector>
 #include <glibmm/i18n.h>
 #include <gtkmm/main.h>
 #include <potracelib.h>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
 
 #include "inkscape-potrace.h"
 #include "bitmap.h"
 
 #include "async/progress.h"
+#include "async/parallel-progress.h"
+#include "preferences.h"
 #include "trace/filterset.h"
 #include "trace/quantize.h"
 #include "trace/imagemap-gdk.h"
@@ -40,6 +48,66 @@ Glib::ustring twohex(int value)
     return Glib::ustring::format(std::hex, std::setfill(L'0'), std::setw(2), value);
 }
 
+/**
+ * Create a potrace bitmap of the given size, setting the pixels for which \a black returns true.
+ */
+template <typename F>
+potrace_bitmap_uniqptr make_bitmap(int width, int height, F &&black)
+{
+    auto bitmap = potrace_bitmap_uniqptr(bm_new(width, height));
+    if (!bitmap) {
+        return {};
+    }
+
+    bm_clear(bitmap.get(), 0);
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (black(x, y)) {
+                BM_UPUT(bitmap, x, y, 1);
+            }
+        }
+    }
+
+    return bitmap;
+}
+
+/**
+ * Run \a count independent jobs on up to \a nthreads threads, rethrowing the first exception thrown by any job.
+ */
+template <typename F>
+void run_parallel(int count, int nthreads, F &&job)
+{
+    nthreads = std::min(nthreads, count);
+
+    if (nthreads <= 1) {
+        for (int i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(count);
+
+    boost::asio::thread_pool pool(nthreads);
+    for (int i = 0; i < count; i++) {
+        boost::asio::post(pool, [&, i] {
+            try {
+                job(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    pool.join();
+
+    for (auto &e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
 } // namespace
 
 namespace Inkscape {
@@ -63,6 +131,7 @@ PotraceTracingEngine::PotraceTracingEngine(TraceType traceType, bool invert, int
 void PotraceTracingEngine::common_init()
 {
     potraceParams = potrace_param_default();
+    numThreads = Inkscape::Preferences::get()->getIntLimited("/options/threading/numthreads", std::thread::hardware_concurrency(), 1, 256);
 }
 
 PotraceTracingEngine::~PotraceTracingEngine()
@@ -201,7 +270,7 @@ IndexedMap PotraceTracingEngine::filterIndexed(Glib::RefPtr<Gdk::Pixbuf> const &
         map = rgbMapGaussian(map);
     }
 
-    auto imap = rgbMapQuantize(map, multiScanNrColors);
+    auto imap = rgbMapQuantize(map, multiScanNrColors, numThreads);
 
     auto tomono = [] (RGB c) -> RGB {
         unsigned char s = ((int)c.r + (int)c.g + (int)c.b) / 3;
@@ -239,25 +308,28 @@ Glib::RefPtr<Gdk::Pixbuf> PotraceTracingEngine::preview(Glib::RefPtr<Gdk::Pixbuf
     }
 }
 
+/**
+ * Trace a gray map, treating black pixels as foreground.
+ */
+Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Async::Progress<double> &progress) const
+{
+    auto potraceBitmap = make_bitmap(grayMap.width, grayMap.height, [&] (int x, int y) {
+        return grayMap.getPixel(x, y) == GrayMap::BLACK;
+    });
+
+    return bitmapToPath(potraceBitmap.get(), progress);
+}
+
 /**
  * This is the actual wrapper of the call to Potrace.
+ * It is safe to call concurrently, as each call uses its own copy of the parameters.
  */
-Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Async::Progress<double> &progress)
+Geom::PathVector PotraceTracingEngine::bitmapToPath(potrace_bitmap_t const *potraceBitmap, Async::Progress<double> &progress) const
 {
-    auto potraceBitmap = potrace_bitmap_uniqptr(bm_new(grayMap.width, grayMap.height));
     if (!potraceBitmap) {
         return {};
     }
 
-    bm_clear(potraceBitmap.get(), 0);
-
-    // Read the data out of the GrayMap
-    for (int y = 0; y < grayMap.height; y++) {
-        for (int x = 0; x < grayMap.width; x++) {
-            BM_UPUT(potraceBitmap, x, y, grayMap.getPixel(x, y) ? 0 : 1);
-        }
-    }
-
     progress.throw_if_cancelled();
 
     //##Debug
@@ -271,11 +343,10 @@ Geom::PathVector PotraceTracingEngine::grayMapToPath(GrayMap const &grayMap, Asy
 
     auto throttled = Async::ProgressStepThrottler(progress, 0.02);
 
-    potraceParams->progress.data = &throttled;
-    potraceParams->progress.callback = [] (double progress, void *data) { reinterpret_cast<decltype(throttled)*>(data)->report(progress); };
-    auto potraceState = potrace_state_uniqptr(potrace_trace(potraceParams, potraceBitmap.get()));
-
-    potraceBitmap.reset();
+    auto params = *potraceParams;
+    params.progress.data = &throttled;
+    params.progress.callback = [] (double progress, void *data) { reinterpret_cast<decltype(throttled)*>(data)->report(progress); };
+    auto potraceState = potrace_state_uniqptr(potrace_trace(&params, potraceBitmap));
 
     progress.throw_if_cancelled();
 
@@ -329,40 +400,76 @@ TraceResult PotraceTracingEngine::traceBrightnessMulti(Glib::RefPtr<Gdk::Pixbuf>
     double constexpr high  = 0.9; // top of range
     double const     delta = (high - low) / multiScanNrColors;
 
-    brightnessFloor = 0.0; // Set bottom to black
+    auto gm = gdkPixbufToGrayMap(pixbuf);
 
-    TraceResult results;
+    progress.report_or_throw(0.1);
 
-    for (int i = 0; i < multiScanNrColors; i++) {
-        auto subprogress = Async::SubProgress(progress, (double)i / multiScanNrColors, 1.0 / multiScanNrColors);
+    auto threshold = [&] (int i) {
+        return low + delta * i;
+    };
 
-        brightnessThreshold = low + delta * i;
-
-        auto grayMap = filter(pixbuf);
-        if (!grayMap) {
-            continue;
-        }
+    // Trace the scan with the given brightness range, as filter() would.
+    auto traceScan = [&, this] (double floor, double cutoff, Async::Progress<double> &subprogress) {
+        floor *= 3.0 * 256.0;
+        cutoff *= 3.0 * 256.0;
+        auto bitmap = make_bitmap(gm.width, gm.height, [&, this] (int x, int y) {
+            double brightness = gm.getPixel(x, y);
+            bool black = brightness >= floor && brightness < cutoff;
+            return black != invert;
+        });
 
         subprogress.report_or_throw(0.2);
 
         auto sub_gmtopath = Async::SubProgress(subprogress, 0.2, 0.8);
-        auto pv = grayMapToPath(*grayMap, sub_gmtopath);
-        if (pv.empty()) {
+        auto pv = bitmapToPath(bitmap.get(), sub_gmtopath);
+
+        subprogress.report_or_throw(1.0);
+
+        return pv;
+    };
+
+    // Unless stacking, each scan starts where the previous non-empty scan ended. Assume every scan is
+    // non-empty, so that all the scans can be traced independently, and fix up afterwards if not.
+    auto floorFor = [&, this] (int i) {
+        return multiScanStack || i == 0 ? 0.0 : threshold(i - 1);
+    };
+
+    auto pvs = std::vector<Geom::PathVector>(multiScanNrColors);
+
+    {
+        auto subprogress = Async::SubProgress(progress, 0.1, 0.9);
+        auto parallel = Async::ParallelProgress(subprogress, multiScanNrColors);
+        run_parallel(multiScanNrColors, numThreads, [&] (int i) {
+            pvs[i] = traceScan(floorFor(i), threshold(i), parallel[i]);
+        });
+    }
+
+    double floor = 0.0;
+    for (int i = 0; i < multiScanNrColors; i++) {
+        if (!multiScanStack && floor != floorFor(i)) {
+            // An earlier scan came out empty, so this one must cover its range too.
+            auto discard = Async::ProgressAlways<double>();
+            pvs[i] = traceScan(floor, threshold(i), discard);
+            progress.throw_if_cancelled();
+        }
+        if (!pvs[i].empty() && !multiScanStack) {
+            floor = threshold(i);
+        }
+    }
+
+    TraceResult results;
+
+    for (int i = 0; i < multiScanNrColors; i++) {
+        if (pvs[i].empty()) {
             continue;
         }
 
         // get style info
-        int grayVal = 256.0 * brightnessThreshold;
+        int grayVal = 256.0 * threshold(i);
         auto style = Glib::ustring::compose("fill-opacity:1.0;fill:#%1%2%3", twohex(grayVal), twohex(grayVal), twohex(grayVal));
 
         // g_message("### GOT '%s' \n", style.c_str());
-        results.emplace_back(style.raw(), std::move(pv));
-
-        if (!multiScanStack) {
-            brightnessFloor = brightnessThreshold;
-        }
-
-        subprogress.report_or_throw(1.0);
+        results.emplace_back(style.raw(), std::move(pvs[i]));
     }
 
     // Remove the bottom-most scan, if requested.
@@ -380,45 +487,42 @@ TraceResult PotraceTracingEngine::traceQuant(Glib::RefPtr<Gdk::Pixbuf> const &pi
 {
     auto imap = filterIndexed(pixbuf);
 
-    // Create and clear a gray map
-    auto gm = GrayMap(imap.width, imap.height);
-    for (int row = 0; row < gm.height; row++) {
-        for (int col = 0; col < gm.width; col++) {
-            gm.setPixel(col, row, GrayMap::WHITE);
-        }
-    }
+    progress.report_or_throw(0.1);
 
-    TraceResult results;
+    // The color layers are independent, so trace them concurrently.
+    auto pvs = std::vector<Geom::PathVector>(imap.nrColors);
 
-    for (int colorIndex = 0; colorIndex < imap.nrColors; colorIndex++) {
-        auto subprogress = Async::SubProgress(progress, (double)colorIndex / imap.nrColors, 1.0 / imap.nrColors);
-
-        // Update the graymap for the current color index
-        for (int row = 0; row < imap.height; row++) {
-            for (int col = 0; col < imap.width; col++) {
-                int index = imap.getPixel(col, row);
-                if (index == colorIndex) {
-                    gm.setPixel(col, row, GrayMap::BLACK);
-                } else if (!multiScanStack) {
-                    gm.setPixel(col, row, GrayMap::WHITE);
-                }
-            }
-        }
+    {
+        auto subprogress = Async::SubProgress(progress, 0.1, 0.9);
+        auto parallel = Async::ParallelProgress(subprogress, imap.nrColors);
+        run_parallel(imap.nrColors, numThreads, [&, this] (int colorIndex) {
+            auto &layerprogress = parallel[colorIndex];
 
-        subprogress.report_or_throw(0.2);
+            // Build a traceable bitmap for the current color index. When stacking, it includes
+            // all the lower color indices too.
+            auto bitmap = make_bitmap(imap.width, imap.height, [&, this] (int x, int y) {
+                int index = imap.getPixel(x, y);
+                return multiScanStack ? index <= colorIndex : index == colorIndex;
+            });
 
-        // Now we have a traceable graymap
-        auto sub_gmtopath = Async::SubProgress(subprogress, 0.2, 0.8);
-        auto pv = grayMapToPath(gm, sub_gmtopath);
+            layerprogress.report_or_throw(0.2);
+
+            auto sub_gmtopath = Async::SubProgress(layerprogress, 0.2, 0.8);
+            pvs[colorIndex] = bitmapToPath(bitmap.get(), sub_gmtopath);
+
+            layerprogress.report_or_throw(1.0);
+        });
+    }
 
-        if (!pv.empty()) {
+    TraceResult results;
+
+    for (int colorIndex = 0; colorIndex < imap.nrColors; colorIndex++) {
+        if (!pvs[colorIndex].empty()) {
             // get style info
             auto rgb = imap.clut[colorIndex];
             auto style = Glib::ustring::compose("fill:#%1%2%3", twohex(rgb.r), twohex(rgb.g), twohex(rgb.b));
-            results.emplace_back(style.raw(), std::move(pv));
+            results.emplace_back(style.raw(), std::move(pvs[colorIndex]));
         }
-
-        subprogress.report_or_throw(1.0);
     }
 
     // Remove the bottom-most scan, if requested.
@@ -26,6 +26,7 @@
 #include "trace/imagemap.h"
 using potrace_param_t = struct potrace_param_s;
 using potrace_path_t  = struct potrace_path_s;
+using potrace_bitmap_t = struct potrace_bitmap_s;
 
 namespace Inkscape {
 namespace Trace {
@@ -108,6 +109,9 @@ private:
     bool multiScanSmooth = false; // do we use gaussian filter?
     bool multiScanRemoveBackground = false; // do we remove the bottom trace?
 
+    // Maximum number of layers traced concurrently.
+    int numThreads = 1;
+
     void common_init();
 
     TraceResult traceQuant          (Glib::RefPtr<Gdk::Pixbuf> const &pixbuf, Async::Progress<double> &progress);
@@ -117,7 +121,8 @@ private:
     IndexedMap filterIndexed(Glib::RefPtr<Gdk::Pixbuf> const &pixbuf) const;
     std::optional<GrayMap> filter(Glib::RefPtr<Gdk::Pixbuf> const &pixbuf) const;
 
-    Geom::PathVector grayMapToPath(GrayMap const &gm, Async::Progress<double> &progress);
+    Geom::PathVector grayMapToPath(GrayMap const &gm, Async::Progress<double> &progress) const;
+    Geom::PathVector bitmapToPath(potrace_bitmap_t const *bitmap, Async::Progress<double> &progress) const;
 
     void writePaths(potrace_path_t *paths, Geom::PathBuilder &builder, std::unordered_set<Geom::Point, geom_point_hash> &points, Async::Progress<double> &progress) const;
 };
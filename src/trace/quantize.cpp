@@ -9,10 +9,14 @@
  *
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
+#include <algorithm>
 #include <memory>
 #include <cassert>
 #include <cstdio>
+#include <vector>
 #include <glib.h>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
 
 #include "pool.h"
 #include "imagemap.h"
@@ -144,6 +148,11 @@ struct Ocnode
 - pool allocation is used to allocate nodes (increased performance on large
   images).
 
+- since merging is insensitive to the order of the merges, the image can be
+  split in horizontal bands whose trees are built concurrently, each one with
+  its own pool, and merged afterwards. the result does not depend on the
+  number of bands.
+
 */
 
 RGB operator>>(RGB rgb, int s)
@@ -449,17 +458,43 @@ void octreeBuildArea(Pool<Ocnode> &pool, RgbMap const &rgbmap, Ocnode **ref, int
 /**
  * build an octree associated to the <rgbmap> color map,
  * pruned to <ncolor> colors.
+ *
+ * the tree is built from <pools.size()> horizontal bands of the map in
+ * parallel, and merged into the first pool. all pools must be kept alive
+ * until the tree is deleted, since merged nodes may come from any of them.
  */
-Ocnode *octreeBuild(Pool<Ocnode> &pool, RgbMap const &rgbmap, int ncolor)
+Ocnode *octreeBuild(std::vector<Pool<Ocnode>> &pools, RgbMap const &rgbmap, int ncolor)
 {
-    // create the octree
-    Ocnode *node = nullptr;
-    octreeBuildArea(pool,
-                    rgbmap, &node,
-                    0, 0, rgbmap.width, rgbmap.height, ncolor);
+    int const nbands = pools.size();
+    std::vector<Ocnode *> bands(nbands, nullptr);
+
+    auto build_band = [&] (int i) {
+        int y1 = rgbmap.height * i / nbands;
+        int y2 = rgbmap.height * (i + 1) / nbands;
+        octreeBuildArea(pools[i], rgbmap, &bands[i], 0, y1, rgbmap.width, y2, ncolor);
+    };
+
+    if (nbands == 1) {
+        build_band(0);
+    } else {
+        boost::asio::thread_pool threads(nbands);
+        for (int i = 0; i < nbands; i++) {
+            boost::asio::post(threads, [&, i] { build_band(i); });
+        }
+        threads.join();
+    }
+
+    // merge the octrees of the bands
+    Ocnode *node = bands[0];
+    for (int i = 1; i < nbands; i++) {
+        octreeMerge(pools[0], nullptr, &node, node, bands[i]);
+    }
+    if (node) {
+        node->ref = &node;
+    }
 
     // prune the octree
-    octreePrune(pool, &node, ncolor);
+    octreePrune(pools[0], &node, ncolor);
 
     return node;
 }
@@ -512,20 +547,23 @@ int findRGB(RGB const *rgbs, int ncolor, RGB rgb)
 /**
  * quantize an RGB image to a reduced number of colors.
  */
-IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int ncolor)
+IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int ncolor, int nthreads)
 {
     assert(ncolor > 0);
 
     auto imap = IndexedMap(rgbmap.width, rgbmap.height);
 
-    Pool<Ocnode> pool;
-    auto tree = octreeBuild(pool, rgbmap, ncolor);
+    // each band needs at least one row
+    nthreads = std::clamp(nthreads, 1, std::max(rgbmap.height, 1));
+
+    std::vector<Pool<Ocnode>> pools(nthreads);
+    auto tree = octreeBuild(pools, rgbmap, ncolor);
 
     auto rgbs = std::make_unique<RGB[]>(ncolor);
     int index = 0;
     octreeIndex(tree, rgbs.get(), index);
 
-    octreeDelete(pool, tree);
+    octreeDelete(pools[0], tree);
 
     // stacking with increasing contrasts
     std::sort(rgbs.get(), rgbs.get() + ncolor, [] (auto &ra, auto &rb) {
@@ -540,12 +578,24 @@ IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int ncolor)
     imap.nrColors = index;
 
     // fill in new map pixels
-    for (int y = 0; y < rgbmap.height; y++) {
-        for (int x = 0; x < rgbmap.width; x++) {
-            auto rgb = rgbmap.getPixel(x, y);
-            int index = findRGB(rgbs.get(), ncolor, rgb);
-            imap.setPixel(x, y, index);
+    auto fill_band = [&] (int y1, int y2) {
+        for (int y = y1; y < y2; y++) {
+            for (int x = 0; x < rgbmap.width; x++) {
+                auto rgb = rgbmap.getPixel(x, y);
+                int index = findRGB(rgbs.get(), ncolor, rgb);
+                imap.setPixel(x, y, index);
+            }
+        }
+    };
+
+    if (nthreads == 1) {
+        fill_band(0, rgbmap.height);
+    } else {
+        boost::asio::thread_pool threads(nthreads);
+        for (int i = 0; i < nthreads; i++) {
+            boost::asio::post(threads, [&, i] { fill_band(rgbmap.height * i / nthreads, rgbmap.height * (i + 1) / nthreads); });
         }
+        threads.join();
     }
 
     return imap;
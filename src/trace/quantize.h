@@ -19,8 +19,9 @@ namespace Trace {
 
 /**
  * Quantize an RGB image to a reduced number of colors.
+ * The work is split across up to \a nthreads threads; the result does not depend on it.
  */
-IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int nrColors);
+IndexedMap rgbMapQuantize(RgbMap const &rgbmap, int nrColors, int nthreads = 1);
 
 } // namespace Trace
 } // namespace Inkscape
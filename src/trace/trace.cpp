@@ -116,8 +116,8 @@ Geom::Affine getImageTransform(SPImage const *img)
     double w = img->width.computed;
     double h = img->height.computed;
 
-    int iw = img->pixbuf->width();
-    int ih = img->pixbuf->height();
+    int iw = img->pixelSize().x();
+    int ih = img->pixelSize().y();
 
     double wscale = w / iw;
     double hscale = h / ih;
@@ -353,7 +353,7 @@ TraceFuture TraceTask::launch(std::unique_ptr<TraceTask> self)
 
     auto image = imageanditems->first;
 
-    image_pixbuf = image->pixbuf; // Note: image->pixbuf is immutable, so can be shared thread-safely.
+    image_pixbuf = image->getPixbuf(); // Note: the pixbuf is immutable, so can be shared thread-safely.
     if (!image_pixbuf) {
         if (type == Type::Trace) msgStack->flash(Inkscape::ERROR_MESSAGE, _("Trace: Image has no bitmap data"));
         return {};
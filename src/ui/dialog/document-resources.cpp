@@ -43,6 +43,7 @@
 #include <string>
 #include <typeindex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "color.h"
 #include "display/cairo-utils.h"
@@ -80,6 +81,7 @@
 #include "ui/util.h"
 #include "ui/widget/shapeicon.h"
 #include "util/object-renderer.h"
+#include "util/preview-service.h"
 #include "util/trim.h"
 #include "xml/href-attribute-helper.h"
 
@@ -310,6 +312,8 @@ DocumentResources::DocumentResources()
     auto filtered_items = Gtk::TreeModelFilter::create(_item_store);
     auto model = Gtk::TreeModelSort::create(filtered_items);
     model->set_sort_column(g_item_columns.label.index(), Gtk::SORT_ASCENDING);
+    _filtered_items = filtered_items;
+    _sorted_items = model;
 
     add(get_widget<Gtk::Box>(_builder, "main"));
 
@@ -327,6 +331,11 @@ DocumentResources::DocumentResources()
 
     _iconview.pack_start(_image_renderer);
     _iconview.add_attribute(_image_renderer, "surface", g_item_columns.image);
+    // new items come into view by scrolling, resizing, searching or switching pages
+    if (auto adjustment = _iconview.get_vadjustment()) {
+        adjustment->signal_value_changed().connect([=](){ queue_visible_previews(); });
+    }
+    _iconview.signal_size_allocate().connect([=](Gtk::Allocation&){ queue_visible_previews(); });
 
     _treeview.set_model(filtered_info);
 
@@ -421,6 +430,8 @@ DocumentResources::DocumentResources()
         filtered_info->freeze_notify();
         filtered_info->refilter();
         filtered_info->thaw_notify();
+
+        queue_visible_previews();
     });
 
     // filter gridview
@@ -824,8 +835,8 @@ void add_colors(Glib::RefPtr<Gtk::ListStore> item_store, const std::map<std::str
     }
 }
 
-void _add_items_with_images(Glib::RefPtr<Gtk::ListStore> item_store, const std::vector<SPObject*>& items, double width, double height, int device_scale, bool use_title, object_renderer::options opt) {
-    object_renderer renderer;
+// previews are left out; they get rendered when their items are in view
+void _add_items_with_images(Glib::RefPtr<Gtk::ListStore> item_store, const std::vector<SPObject*>& items, bool use_title) {
     item_store->freeze_notify();
 
     for (auto item : items) {
@@ -843,7 +854,6 @@ void _add_items_with_images(Glib::RefPtr<Gtk::ListStore> item_store, const std::
             auto label = item->getAttribute("inkscape:label");
             row[g_item_columns.label] = label_fmt(label, id);
         }
-        row[g_item_columns.image] = renderer.render(*item, width, height, device_scale, opt);
         row[g_item_columns.object] = item;
     }
 
@@ -851,9 +861,9 @@ void _add_items_with_images(Glib::RefPtr<Gtk::ListStore> item_store, const std::
 }
 
 template<typename T>
-void add_items_with_images(Glib::RefPtr<Gtk::ListStore> item_store, const std::vector<T*>& items, double width, double height, int device_scale, bool use_title = false, object_renderer::options opt = {}) {
+void add_items_with_images(Glib::RefPtr<Gtk::ListStore> item_store, const std::vector<T*>& items, bool use_title = false) {
     static_assert(std::is_base_of<SPObject, T>::value);
-    _add_items_with_images(item_store, reinterpret_cast<const std::vector<SPObject*>&>(items), width, height, device_scale, use_title, opt);
+    _add_items_with_images(item_store, reinterpret_cast<const std::vector<SPObject*>&>(items), use_title);
 }
 
 void add_fonts(Glib::RefPtr<Gtk::ListStore> store, const std::set<std::string>& fontspecs) {
@@ -985,6 +995,8 @@ void DocumentResources::select_page(const Glib::ustring& id) {
 }
 
 void DocumentResources::clear_stores() {
+    _preview_requests.clear();
+
     _item_store->freeze_notify();
     _item_store->clear();
     _item_store->thaw_notify();
@@ -1004,6 +1016,7 @@ void DocumentResources::refresh_page(const Glib::ustring& id) {
     // GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID
 
     clear_stores();
+    set_previews(0, 0);
 
     auto root = _document ? _document->getRoot() : nullptr;
     auto defs = _document ? _document->getDefs() : nullptr;
@@ -1035,37 +1048,39 @@ void DocumentResources::refresh_page(const Glib::ustring& id) {
                 opt.solid_background(0xf0f0f0ff, 3, 3);
             }
             opt.symbol_style_from_use();
-            add_items_with_images(_item_store, collect_items<SPSymbol>(defs), 70, 60, device_scale, true, opt);
+            add_items_with_images(_item_store, collect_items<SPSymbol>(defs), true);
+            set_previews(70, 60, opt);
         }
         label_editable = true;
         can_delete = true;
         break;
 
     case Patterns:
-        add_items_with_images(_item_store, collect_items<SPPattern>(defs), 80, 70, device_scale);
+        add_items_with_images(_item_store, collect_items<SPPattern>(defs));
+        set_previews(80, 70);
         label_editable = true;
         can_delete = true;
         break;
 
     case Markers:
-        add_items_with_images(_item_store, collect_items<SPMarker>(defs), 70, 60, device_scale, false,
-            object_renderer::options().foreground(color));
+        add_items_with_images(_item_store, collect_items<SPMarker>(defs));
+        set_previews(70, 60, object_renderer::options().foreground(color));
         label_editable = true;
         can_delete = true;
         break;
 
     case Gradients:
         add_items_with_images(_item_store,
-            collect_items<SPGradient>(defs, [](auto& g){ return filter_element(g) && !g.isSwatch(); }),
-            180, 22, device_scale);
+            collect_items<SPGradient>(defs, [](auto& g){ return filter_element(g) && !g.isSwatch(); }));
+        set_previews(180, 22);
         label_editable = true;
         can_delete = true;
         break;
 
     case Swatches:
         add_items_with_images(_item_store,
-            collect_items<SPGradient>(defs, [](auto& g){ return filter_element(g) && g.isSwatch(); }),
-            100, 22, device_scale);
+            collect_items<SPGradient>(defs, [](auto& g){ return filter_element(g) && g.isSwatch(); }));
+        set_previews(100, 22);
         label_editable = true;
         can_delete = true;
         break;
@@ -1091,7 +1106,8 @@ void DocumentResources::refresh_page(const Glib::ustring& id) {
         break;
 
     case Images:
-        add_items_with_images(_item_store, collect_items<SPImage>(root), 110, 110, device_scale);
+        add_items_with_images(_item_store, collect_items<SPImage>(root));
+        set_previews(110, 110);
         label_editable = true;
         can_extract = true;
         can_delete = true;
@@ -1128,6 +1144,70 @@ void DocumentResources::refresh_page(const Glib::ustring& id) {
     _iconview.set_item_width(item_width);
     get_widget<Gtk::Stack>(_builder, "stack").set_visible_child(tab);
     update_buttons();
+    queue_visible_previews();
+}
+
+void DocumentResources::set_previews(double width, double height, object_renderer::options options) {
+    _preview_width = width;
+    _preview_height = height;
+    _preview_options = options;
+}
+
+// look for items in view once the icon view has laid them out
+void DocumentResources::queue_visible_previews() {
+    if (_preview_idle) return;
+
+    _preview_idle = Glib::signal_idle().connect([=](){
+        request_visible_previews();
+        return false;
+    }); // runs after GTK has relaid out and redrawn the view
+}
+
+// render previews of the items in view, and stop waiting for those that went out of view
+void DocumentResources::request_visible_previews() {
+    Gtk::TreeModel::Path start, end;
+    if (_preview_width <= 0 || !_document || !_iconview.get_visible_range(start, end)) return;
+
+    auto& service = PreviewService::get();
+    auto device_scale = get_scale_factor();
+    auto params = std::to_string(_preview_width) + 'x' + std::to_string(_preview_height) + '@' +
+        std::to_string(device_scale) + ';' + _preview_options.cache_key();
+    auto const context = PreviewService::context_key(*_document);
+
+    std::unordered_set<SPObject*> visible;
+    for (auto path = start; path <= end; path.next()) {
+        auto it = _sorted_items->get_iter(path);
+        if (!it) break;
+
+        SPObject* object = (*it)[g_item_columns.object];
+        if (!object) continue;
+
+        visible.insert(object);
+        if (_preview_requests.count(object)) continue; // pending or done
+
+        auto row = _filtered_items->convert_iter_to_child_iter(_sorted_items->convert_iter_to_child_iter(it));
+        auto& request = _preview_requests[object];
+        request.release = object->connectRelease([=](SPObject*){ _preview_requests.erase(object); });
+        request.done = service.request(PreviewService::content_key(*object, context) + ';' + params,
+            [=, width = _preview_width, height = _preview_height, options = _preview_options](){
+                return _renderer.render(*object, width, height, device_scale, options);
+            },
+            [=](const Cairo::RefPtr<Cairo::Surface>& surface){
+                if (surface) {
+                    (*row)[g_item_columns.image] = surface;
+                }
+            });
+    }
+
+    // cancel requests that are still pending for items out of view
+    for (auto it = _preview_requests.begin(); it != _preview_requests.end(); ) {
+        if (it->second.done && !visible.count(it->first)) {
+            it = _preview_requests.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
 }
 
 void DocumentResources::start_editing(Gtk::CellEditable* cell, const Glib::ustring& path) {
@@ -13,6 +13,7 @@
 #include "ui/dialog/dialog-base.h"
 #include "ui/widget/entity-entry.h"
 #include "ui/widget/registry.h"
+#include "util/object-renderer.h"
 #include <cstddef>
 #include <glibmm/refptr.h>
 #include <glibmm/ustring.h>
@@ -23,9 +24,12 @@
 #include <gtkmm/iconview.h>
 #include <gtkmm/liststore.h>
 #include <gtkmm/searchentry.h>
+#include <gtkmm/treemodelfilter.h>
+#include <gtkmm/treemodelsort.h>
 #include <gtkmm/treeview.h>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <boost/ptr_container/ptr_vector.hpp>
 
 namespace Inkscape {
@@ -73,9 +77,14 @@ private:
     void update_buttons();
     Gtk::TreeModel::Row selected_item();
     void clear_stores();
+    void set_previews(double width, double height, object_renderer::options options = {});
+    void queue_visible_previews();
+    void request_visible_previews();
 
     Glib::RefPtr<Gtk::Builder> _builder;
     Glib::RefPtr<Gtk::ListStore> _item_store;
+    Glib::RefPtr<Gtk::TreeModelFilter> _filtered_items;
+    Glib::RefPtr<Gtk::TreeModelSort> _sorted_items;
     Glib::RefPtr<Gtk::TreeModelFilter> _categories;
     Glib::RefPtr<Gtk::ListStore> _info_store;
     Gtk::CellRendererPixbuf _image_renderer;
@@ -98,6 +107,18 @@ private:
     Gtk::CellRendererText* _label_renderer;
     auto_connection _document_modified;
     auto_connection _idle_refresh;
+
+    // previews of the items on the current page are rendered once they scroll into view
+    struct PreviewRequest {
+        auto_connection done;
+        auto_connection release;
+    };
+    object_renderer _renderer;
+    double _preview_width = 0; // zero when the page has no previews
+    double _preview_height = 0;
+    object_renderer::options _preview_options;
+    std::unordered_map<SPObject*, PreviewRequest> _preview_requests;
+    auto_connection _preview_idle;
 };
 
 } } } // namespaces
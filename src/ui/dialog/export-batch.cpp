@@ -547,7 +547,7 @@ void BatchExport::onCancel()
 void BatchExport::onExport()
 {
     interrupted = false;
-    if (!_desktop)
+    if (!_desktop || !_document)
         return;
 
     // If there are no selected button, simply flash message in status bar
@@ -557,6 +557,9 @@ void BatchExport::onExport()
         return;
     }
 
+    // Never export part of a document that is still being loaded, whether or not this is cancelled.
+    _document->finishLoading();
+
     setExporting(true);
 
     // Find and remove any extension from filename so that we can add suffix to it.
@@ -610,6 +610,9 @@ void SingleExport::onExport()
         return;
     }
 
+    // Never export part of a document that is still being loaded, whether or not this is cancelled.
+    _document->finishLoading();
+
     setExporting(true, _("Exporting"));
 
     bool selected_only = si_hide_all->get_active();
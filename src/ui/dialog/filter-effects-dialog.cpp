@@ -1469,7 +1469,7 @@ void FilterEffectsDialog::FilterModifier::update_selection(Selection *sel)
 
         if (style->filter.set && style->getFilter()) {
             //TODO: why is this needed?
-            obj->bbox_valid = FALSE;
+            obj->invalidateBounds();
             used.insert(style->getFilter());
         }
     }
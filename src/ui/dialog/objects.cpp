@@ -104,6 +104,10 @@ public:
 
     void initRowInfo();
     void updateRowInfo();
+    void invalidateRow();
+    void materializeRow();
+    void attachObserver();
+    void syncDummyChild();
     void updateRowHighlight();
     void updateRowAncestorState(bool invisible, bool locked);
     void updateRowBg(guint32 rgba = 0.0);
@@ -178,6 +182,10 @@ private:
     ObjectsPanel *panel;
     SelectionState selection_state;
     bool is_filtered;
+    // Set while the row content is stale; cleared once the row has been on screen
+    bool row_dirty = false;
+    // Set once this watcher listens to its node, see attachObserver()
+    bool observing = false;
 };
 
 class ObjectsPanel::ModelColumns : public Gtk::TreeModel::ColumnRecord
@@ -242,9 +250,11 @@ ObjectWatcher::ObjectWatcher(ObjectsPanel* panel, SPItem* obj, Gtk::TreeRow *row
         assert(row->children().empty());
         setRow(*row);
         initRowInfo();
-        updateRowInfo();
+        // The rest of the row is filled in when it scrolls into view
+        invalidateRow();
+    } else {
+        attachObserver();
     }
-    node->addObserver(*this);
 
     // Only show children for groups (and their subclasses like SPAnchor or SPRoot)
     if (!is<SPGroup>(obj)) {
@@ -257,7 +267,9 @@ ObjectWatcher::ObjectWatcher(ObjectsPanel* panel, SPItem* obj, Gtk::TreeRow *row
 }
 ObjectWatcher::~ObjectWatcher()
 {
-    node->removeObserver(*this);
+    if (observing) {
+        node->removeObserver(*this);
+    }
     Gtk::TreeModel::Path path;
     if (bool(row_ref) && (path = row_ref.get_path())) {
         if (auto iter = panel->_store->get_iter(path)) {
@@ -271,9 +283,68 @@ void ObjectWatcher::initRowInfo()
 {
     auto _model = panel->_model;
     auto row = *panel->_store->get_iter(row_ref.get_path());
+    row[_model->_colNode] = node;
     row[_model->_colHover] = false;
 }
 
+/**
+ * Mark the row content as stale. Stale rows are only refreshed once they are
+ * inside the visible part of the tree, see ObjectsPanel::_updateVisibleRows().
+ */
+void ObjectWatcher::invalidateRow()
+{
+    row_dirty = true;
+    panel->_queueRowsUpdate();
+}
+
+/**
+ * Bring a stale row up to date; called for rows in the visible range only.
+ */
+void ObjectWatcher::materializeRow()
+{
+    if (!row_dirty || !row_ref) {
+        return;
+    }
+    row_dirty = false;
+    if (!observing) {
+        // Changes made while nobody was listening are picked up here
+        attachObserver();
+        syncDummyChild();
+    }
+    updateRowInfo();
+}
+
+/**
+ * Start listening to changes of the XML node.
+ *
+ * Rows which have never been visible and have no real child rows do not need an
+ * observer, so for large groups this is deferred until the row is materialized
+ * or its children are added.
+ */
+void ObjectWatcher::attachObserver()
+{
+    if (!observing) {
+        node->addObserver(*this);
+        observing = true;
+    }
+}
+
+/**
+ * Make sure a collapsed group which was not observed still has a dummy child
+ * exactly when it has item children, so the expander is shown correctly.
+ */
+void ObjectWatcher::syncDummyChild()
+{
+    auto group = cast<SPGroup>(panel->getObject(node));
+    if (!group || is_filtered || !child_watchers.empty()) {
+        return;
+    }
+    if (auto row = getRow()) {
+        panel->removeDummyChildren(*row);
+        addChildren(group, true);
+    }
+}
+
 /**
  * Update the information in the row from the stored node
  */
@@ -485,6 +556,8 @@ bool ObjectWatcher::addChild(SPItem *child, bool dummy)
     auto &watcher = child_watchers[node];
     assert(!watcher);
     watcher.reset(new ObjectWatcher(panel, child, &row, is_filtered));
+    // A real child row exists now, so structural changes must be tracked
+    attachObserver();
 
     // Make sure new children have the right focus set.
     if ((selection_state & LAYER_FOCUSED) != 0) {
@@ -628,7 +701,7 @@ void ObjectWatcher::notifyAttributeChanged( Node &node, GQuark name, Util::ptr_s
         return;
     }
 
-    updateRowInfo();
+    invalidateRow();
 }
 
 
@@ -934,6 +1007,7 @@ ObjectsPanel::ObjectsPanel()
         if (auto item = getItem(*iter)) {
             item->setExpanded(true);
         }
+        _queueRowsUpdate();
     });
     _tree.signal_row_collapsed().connect([=](const Gtk::TreeModel::iterator &iter, const Gtk::TreeModel::Path &) {
         if (auto item = getItem(*iter)) {
@@ -955,6 +1029,9 @@ ObjectsPanel::ObjectsPanel()
     _scroller.add(_tree);
     _scroller.set_policy( Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC );
     _scroller.set_shadow_type(Gtk::SHADOW_IN);
+    // Rows are only filled in once they are visible, see _updateVisibleRows()
+    _scroller.get_vadjustment()->signal_value_changed().connect([this]() { _queueRowsUpdate(); });
+    _scroller.get_vadjustment()->signal_changed().connect([this]() { _queueRowsUpdate(); });
     Gtk::Requisition sreq;
     Gtk::Requisition sreq_natural;
     _scroller.get_preferred_size(sreq_natural, sreq);
@@ -1116,6 +1193,63 @@ void ObjectsPanel::selectionChanged(Selection *selected /* not used */)
     }
 }
 
+/**
+ * Schedule an update of the visible rows. Any number of row invalidations
+ * between two idle calls are handled in one pass over the visible range.
+ */
+void ObjectsPanel::_queueRowsUpdate()
+{
+    if (!_rows_update_connection.connected()) {
+        auto handler = sigc::mem_fun(*this, &ObjectsPanel::_updateVisibleRows);
+        int priority = SP_DOCUMENT_UPDATE_PRIORITY + 1;
+        _rows_update_connection = Glib::signal_idle().connect(handler, priority);
+    }
+}
+
+/**
+ * Materialize all stale rows which are currently visible in the tree view,
+ * plus a small margin so that scrolling doesn't uncover empty rows.
+ */
+bool ObjectsPanel::_updateVisibleRows()
+{
+    Gtk::TreeModel::Path start, end;
+    if (!root_watcher || !_tree.get_visible_range(start, end)) {
+        return false;
+    }
+
+    constexpr int margin = 32;
+    int extra = 0;
+    auto iter = _store->get_iter(start);
+    while (iter && extra <= margin) {
+        if (!isDummy(*iter)) {
+            if (auto watcher = getWatcher(getRepr(*iter))) {
+                watcher->materializeRow();
+            }
+        }
+        auto path = _store->get_path(iter);
+        if (extra || path == end) {
+            ++extra;
+        }
+
+        // Advance in display order, descending only into expanded rows
+        if (!iter->children().empty() && _tree.row_expanded(path)) {
+            iter = iter->children().begin();
+            continue;
+        }
+        while (iter) {
+            auto next = iter;
+            if (++next) {
+                iter = next;
+                break;
+            }
+            iter = iter->parent();
+        }
+    }
+
+    // Returning 'false' disconnects idle signal handler
+    return false;
+}
+
 bool ObjectsPanel::_selectionChanged()
 {
     Inkscape::Preferences *prefs = Inkscape::Preferences::get();
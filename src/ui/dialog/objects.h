@@ -182,6 +182,10 @@ private:
 
     bool _selectionChanged();
     auto_connection _idle_connection;
+
+    void _queueRowsUpdate();
+    bool _updateVisibleRows();
+    auto_connection _rows_update_connection;
 };
 
 
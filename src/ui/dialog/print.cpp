@@ -51,6 +51,9 @@ Print::Print(SPDocument *doc, SPItem *base) :
     g_assert (_doc);
     g_assert (_base);
 
+    // Pages and bounds must take in content that is still being loaded.
+    _doc->finishLoading();
+
     _printop = Gtk::PrintOperation::create();
 
     // set up dialog title, based on document name
@@ -31,6 +31,11 @@
 #include <string>
 #include <cstring>
 #include <numeric>
+#include <optional>
+#include <thread>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include <gtk/gtk.h>
 #include <gdk/gdkkeysyms.h>
@@ -69,6 +74,8 @@
 #include "object/sp-text.h"
 #include "object/sp-use.h"
 
+#include "path/path-boolop.h"
+
 #include "ui/icon-names.h"
 
 #include "svg/svg.h"
@@ -832,6 +839,95 @@ bool EraserTool::_booleanErase(EraseTarget target, bool store_survivers)
     return true;
 }
 
+/**
+ * @brief Erases from plain paths by computing the difference with the eraser stroke directly,
+ *        for all of them concurrently, and rewriting only their path data.
+ *        Clones, shapes other than paths and items with path effects are left for _cutErase().
+ * @param items_to_erase - the erase targets.
+ * @param others - receives the targets that were not handled.
+ * @param store_survivers - whether the surviving selected items and their remains should be stored.
+ * @return whether something was erased.
+ */
+bool EraserTool::_pathErase(std::vector<EraseTarget> const &items_to_erase, std::vector<EraseTarget> &others,
+                            bool store_survivers)
+{
+    auto const acid = cast<SPPath>(_acid);
+    if (nowidth || !acid || !acid->curve()) {
+        others = items_to_erase;
+        return false;
+    }
+    auto const eraser = acid->curve()->get_pathvector() * acid->i2doc_affine();
+
+    struct Job
+    {
+        EraseTarget target;
+        Geom::PathVector pathv;
+        Geom::PathVector eraser;
+        FillRule rule;
+        std::optional<Geom::PathVector> result;
+    };
+    std::vector<Job> jobs;
+
+    for (auto const &target : items_to_erase) {
+        auto const path = cast<SPPath>(target.item);
+        if (!path || !path->curve() || path->hasPathEffectRecursive()) {
+            others.push_back(target);
+            continue;
+        }
+        auto const rule = path->style && path->style->fill_rule.computed == SP_WIND_RULE_EVENODD ? fill_oddEven
+                                                                                                 : fill_nonZero;
+        jobs.push_back({target, path->curve()->get_pathvector(), eraser * path->i2doc_affine().inverse(), rule});
+    }
+
+    auto const run = [] (Job &job) {
+        job.result = sp_pathvector_erase_near(job.pathv, job.eraser, job.rule);
+    };
+    if (jobs.size() == 1) {
+        run(jobs[0]);
+    } else if (!jobs.empty()) {
+        std::size_t const numthreads = Preferences::get()->getIntLimited("/options/threading/numthreads",
+                                                                         std::thread::hardware_concurrency(), 1, 256);
+        auto pool = boost::asio::thread_pool(std::min(numthreads, jobs.size()));
+        for (auto &job : jobs) {
+            boost::asio::post(pool, [&] { run(job); });
+        }
+        pool.join();
+    }
+
+    bool erased_something = false;
+    for (auto &job : jobs) {
+        auto *path = job.target.item;
+        bool const keep_selected = store_survivers && job.target.was_selected;
+        if (!job.result) {
+            if (keep_selected) {
+                _survivers.push_back(path);
+            }
+            continue;
+        }
+
+        erased_something = true;
+        if (job.result->empty()) {
+            path->deleteObject(true);
+            continue;
+        }
+        path->setAttribute("d", sp_svg_write_path(*job.result));
+        // The node types no longer match the nodes of the new path data.
+        path->removeAttribute("sodipodi:nodetypes");
+
+        if (_break_apart) {
+            ObjectSet pieces(_desktop);
+            pieces.add(path);
+            pieces.breakApart(true, false, true);
+            if (keep_selected) {
+                _survivers.insert(_survivers.end(), pieces.items().begin(), pieces.items().end());
+            }
+        } else if (keep_selected) {
+            _survivers.push_back(path);
+        }
+    }
+    return erased_something;
+}
+
 /**
  * @brief Performs the actual erasing on a collection of erase targets.
  *        In CUT mode, the optional survivers vector will be populated with leftover pieces of
@@ -843,8 +939,9 @@ bool EraserTool::_booleanErase(EraseTarget target, bool store_survivers)
 bool EraserTool::_performEraseOperation(std::vector<EraseTarget> const &items_to_erase, bool store_survivers)
 {
     if (mode == EraserToolMode::CUT) {
-        bool erased_something = false;
-        for (auto const &target : items_to_erase) {
+        std::vector<EraseTarget> others;
+        bool erased_something = _pathErase(items_to_erase, others, store_survivers);
+        for (auto const &target : others) {
             erased_something = _cutErase(target, store_survivers) || erased_something;
         }
         return erased_something;
@@ -123,6 +123,8 @@ private:
     bool _handleKeypress(GdkEventKey const *key);
     void _handleStrokeStyle(SPItem *item) const;
     SPItem *_insertAcidIntoDocument(SPDocument *document);
+    bool _pathErase(std::vector<EraseTarget> const &items_to_erase, std::vector<EraseTarget> &others,
+                    bool store_survivers);
     bool _performEraseOperation(std::vector<EraseTarget> const &items_to_erase, bool store_survivers);
     void _reset(Geom::Point p);
     void _setStatusBarMessage(char *message);
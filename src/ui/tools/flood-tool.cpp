@@ -43,6 +43,7 @@
 #include "page-manager.h"
 
 #include "display/cairo-utils.h"
+#include "display/control/canvas-item-drawing.h"
 #include "display/drawing-context.h"
 #include "display/drawing-image.h"
 #include "display/drawing.h"
@@ -608,8 +609,6 @@ static ScanlineCheckResult perform_bitmap_scanline_check(std::deque<Geom::Point>
     bool can_paint_top = (top_ty > 0);
     bool can_paint_bottom = (bottom_ty < bci.height);
 
-    Geom::Point front_of_queue = fill_queue->empty() ? Geom::Point() : fill_queue->front();
-
     do {
         ok = false;
         if (bci.is_left) {
@@ -624,15 +623,6 @@ static ScanlineCheckResult perform_bitmap_scanline_check(std::deque<Geom::Point>
         if (keep_tracing) {
             if (check_if_pixel_is_paintable(px, current_trace_t, bci.x, bci.y, orig_color, bci)) {
                 paint_directions = paint_pixel(px, trace_px, orig_color, bci, current_trace_t);
-                if (bci.radius == 0) {
-                    mark_pixel_checked(current_trace_t);
-                    if ((!fill_queue->empty()) &&
-                        (front_of_queue[Geom::X] == bci.x) &&
-                        (front_of_queue[Geom::Y] == bci.y)) {
-                        fill_queue->pop_front();
-                        front_of_queue = fill_queue->empty() ? Geom::Point() : fill_queue->front();
-                    }
-                }
 
                 if (can_paint_top) {
                     if (paint_directions & PAINT_DIRECTION_UP) { 
@@ -701,17 +691,203 @@ static ScanlineCheckResult perform_bitmap_scanline_check(std::deque<Geom::Point>
 }
 
 /**
- * Sort the rendered pixel buffer check queue vertically.
+ * Whether the fill reaching the edge of the rendered area on the given side means that the area
+ * is not bounded, because the drawing does not extend beyond the screen on that side.
  */
-static bool sort_fill_queue_vertical(Geom::Point a, Geom::Point b) {
-    return a[Geom::Y] > b[Geom::Y];
+static bool edge_leaks_out(bitmap_coords_info const &bci, Geom::Dim2 dim, bool at_min)
+{
+    return at_min ? bci.bbox.min()[dim] > bci.screen.min()[dim]
+                  : bci.bbox.max()[dim] < bci.screen.max()[dim];
 }
 
 /**
- * Sort the rendered pixel buffer check queue horizontally.
+ * Which pixels of the rendered pixel buffer are paintable for a target color. Rows are worked out
+ * as a whole and only once the fill reaches them. Rendered drawings are mostly made of runs of the
+ * same color, so a comparison is only made when the pixel differs from the previous one.
+ */
+class PaintableRows
+{
+public:
+    PaintableRows(guchar *px, bitmap_coords_info const &bci)
+        : _px(px)
+        , _bci(bci)
+        , _rows(bci.height)
+    {}
+
+    /// Compare against \a orig_color from now on. Does nothing if it is the current target.
+    void setTarget(guint32 orig_color)
+    {
+        if (_has_target && orig_color == _orig_color) {
+            return;
+        }
+        _has_target = true;
+        _orig_color = orig_color;
+        _merged_orig_pixel = compose_onto(orig_color, _bci.dtc);
+        _has_last = false;
+        for (auto &row : _rows) {
+            row.clear();
+        }
+    }
+
+    /// One byte per pixel of row \a y, nonzero where the pixel is paintable.
+    unsigned char const *row(unsigned int y)
+    {
+        auto &mask = _rows[y];
+        if (mask.empty()) {
+            mask.resize(_bci.width);
+            auto const pixels = reinterpret_cast<guint32 const *>(_px + y * _bci.stride);
+            for (unsigned int x = 0; x < _bci.width; x++) {
+                if (!_has_last || pixels[x] != _last) {
+                    _last = pixels[x];
+                    _last_paintable = compare_pixels(_last, _orig_color, _merged_orig_pixel, _bci.dtc, _bci.threshold, _bci.method);
+                    _has_last = true;
+                }
+                mask[x] = _last_paintable;
+            }
+        }
+        return mask.data();
+    }
+
+private:
+    guchar *_px;
+    bitmap_coords_info const &_bci;
+    std::vector<std::vector<unsigned char>> _rows;
+
+    bool _has_target = false;
+    guint32 _orig_color = 0;
+    guint32 _merged_orig_pixel = 0;
+
+    bool _has_last = false;
+    guint32 _last = 0;
+    bool _last_paintable = false;
+};
+
+/**
+ * Fill the region containing a point on the trace pixel buffer, one horizontal run of pixels at a
+ * time. Only used without autogap, where every paintable neighbour is part of the region.
+ * @param paintable The paintable pixels for the current target color.
+ * @param trace_px The trace pixel buffer, where the filled pixels are marked as colored.
+ * @param bci The bitmap_coords_info structure.
+ * @param x The X coordinate to start from.
+ * @param y The Y coordinate to start from.
+ * @param aborted Set if the fill escapes the drawing.
+ * @param reached_screen_boundary Set if the fill reaches the edge of the rendered area.
  */
-static bool sort_fill_queue_horizontal(Geom::Point a, Geom::Point b) {
-    return a[Geom::X] > b[Geom::X];
+static void fill_spans(PaintableRows &paintable, guchar *trace_px, bitmap_coords_info const &bci,
+                       unsigned int x, unsigned int y, bool &aborted, bool &reached_screen_boundary,
+                       unsigned int &min_x, unsigned int &max_x, unsigned int &min_y, unsigned int &max_y)
+{
+    // Runs of pixels in a row to look for unfilled paintable pixels in.
+    struct Span
+    {
+        unsigned int left, right, y;
+    };
+
+    auto touch_edge = [&] (Geom::Dim2 dim, bool at_min) {
+        if (edge_leaks_out(bci, dim, at_min)) {
+            aborted = true;
+        } else {
+            reached_screen_boundary = true;
+        }
+    };
+
+    std::vector<Span> spans;
+    spans.push_back({ x, x, y });
+
+    while (!spans.empty() && !aborted) {
+        auto const span = spans.back();
+        spans.pop_back();
+
+        auto const mask = paintable.row(span.y);
+        auto const trace_row = get_trace_pixel(trace_px, 0, span.y, bci.width);
+        auto const fillable = [&] (unsigned int tx) { return mask[tx] && !is_pixel_colored(trace_row + tx); };
+
+        for (unsigned int tx = span.left; tx <= span.right; tx++) {
+            if (!fillable(tx)) {
+                continue;
+            }
+
+            unsigned int left = tx;
+            unsigned int right = tx;
+            while (left > 0 && fillable(left - 1)) {
+                left--;
+            }
+            while (right + 1 < bci.width && fillable(right + 1)) {
+                right++;
+            }
+            for (unsigned int i = left; i <= right; i++) {
+                mark_pixel_colored(trace_row + i);
+            }
+
+            min_x = MIN(min_x, left);
+            max_x = MAX(max_x, right);
+            min_y = MIN(min_y, span.y);
+            max_y = MAX(max_y, span.y);
+
+            if (left == 0) { touch_edge(Geom::X, true); }
+            if (right == bci.width - 1) { touch_edge(Geom::X, false); }
+            if (span.y == 0) { touch_edge(Geom::Y, true); }
+            if (span.y == bci.height - 1) { touch_edge(Geom::Y, false); }
+            if (aborted) {
+                return;
+            }
+
+            if (span.y > 0) {
+                spans.push_back({ left, right, span.y - 1 });
+            }
+            if (span.y + 1 < bci.height) {
+                spans.push_back({ left, right, span.y + 1 });
+            }
+
+            tx = right;
+        }
+    }
+}
+
+/**
+ * Render the drawing into a pixel buffer covering \a area in world coordinates, over \a bgcolor.
+ * The canvas drawing is reused when it shows the document as it is, unclipped, so that its caches
+ * are used and no display tree has to be built for the document; otherwise a temporary one is made.
+ */
+static void render_for_fill(SPDesktop *desktop, guchar *px, int stride, Geom::IntRect const &area, guint32 bgcolor)
+{
+    SPDocument *document = desktop->getDocument();
+
+    cairo_surface_t *s = cairo_image_surface_create_for_data(
+        px, CAIRO_FORMAT_ARGB32, area.width(), area.height(), stride);
+    Inkscape::DrawingContext dc(s, area.min());
+
+    dc.setSource(bgcolor);
+    dc.setOperator(CAIRO_OPERATOR_SOURCE);
+    dc.paint();
+    dc.setOperator(CAIRO_OPERATOR_OVER);
+
+    Inkscape::Drawing *canvas_drawing = desktop->getCanvasDrawing()->get_drawing();
+    if (canvas_drawing->renderMode() == RenderMode::NORMAL &&
+        canvas_drawing->colorMode() == ColorMode::NORMAL &&
+        !canvas_drawing->outlineOverlay() &&
+        !canvas_drawing->hasClip())
+    {
+        canvas_drawing->render(dc, area);
+    } else {
+        /* Create DrawingItems and set transform */
+        unsigned dkey = SPItem::display_key_new(1);
+        Inkscape::Drawing drawing;
+        Inkscape::DrawingItem *root = document->getRoot()->invoke_show( drawing, dkey, SP_ITEM_SHOW_DISPLAY);
+        root->setTransform(desktop->doc2dt() * desktop->d2w());
+        drawing.setRoot(root);
+
+        drawing.update(area);
+        drawing.render(dc, area);
+
+        // Hide items
+        document->getRoot()->invoke_hide(dkey);
+    }
+
+    //cairo_surface_write_to_png( s, "cairo.png" );
+
+    cairo_surface_flush(s);
+    cairo_surface_destroy(s);
 }
 
 /**
@@ -740,11 +916,12 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, GdkEvent *event,
     // fill areas off the screen can be included in the fill.
     double padding = 1.6;
 
-    // image space is world space with an offset
+    // image space is world space with an offset, kept whole so that canvas pixels line up
     Geom::Rect const screen_world = desktop->getCanvas()->get_area_world();
     Geom::Rect const screen = screen_world * desktop->w2d();
     Geom::IntPoint const img_dims = (screen_world.dimensions() * padding).ceil();
-    Geom::Affine const world2img = Geom::Translate((img_dims - screen_world.dimensions()) / 2.0 - screen_world.min());
+    Geom::IntPoint const img_origin = (screen_world.min() - (img_dims - screen_world.dimensions()) / 2.0).round();
+    Geom::Affine const world2img = Geom::Translate(-img_origin);
     Geom::Affine const doc2img = desktop->doc2dt() * desktop->d2w() * world2img;
 
     auto const width = img_dims.x();
@@ -752,45 +929,14 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, GdkEvent *event,
 
     int stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, width);
     guchar *px = g_new(guchar, stride * height);
-    guint32 bgcolor, dtc;
-
-    // Draw image into data block px
-    { // this block limits the lifetime of Drawing and DrawingContext
-        /* Create DrawingItems and set transform */
-        unsigned dkey = SPItem::display_key_new(1);
-        Inkscape::Drawing drawing;
-        Inkscape::DrawingItem *root = document->getRoot()->invoke_show( drawing, dkey, SP_ITEM_SHOW_DISPLAY);
-        root->setTransform(doc2img);
-        drawing.setRoot(root);
-
-        Geom::IntRect final_bbox = Geom::IntRect::from_xywh(0, 0, width, height);
-        drawing.update(final_bbox);
-
-        cairo_surface_t *s = cairo_image_surface_create_for_data(
-            px, CAIRO_FORMAT_ARGB32, width, height, stride);
-        Inkscape::DrawingContext dc(s, Geom::Point(0,0));
-        // cairo_translate not necessary here - surface origin is at 0,0
-
-        bgcolor = document->getPageManager().background_color;
-        bgcolor &= 0xffffff00; // make color transparent for 'alpha' flood mode to work
-        // bgcolor is 0xrrggbbaa, we need 0xaarrggbb
-        dtc = bgcolor >> 8; // keep color transparent; page color doesn't support transparency anymore
-
-        dc.setSource(bgcolor);
-        dc.setOperator(CAIRO_OPERATOR_SOURCE);
-        dc.paint();
-        dc.setOperator(CAIRO_OPERATOR_OVER);
-
-        drawing.render(dc, final_bbox);
 
-        //cairo_surface_write_to_png( s, "cairo.png" );
+    guint32 bgcolor = document->getPageManager().background_color;
+    bgcolor &= 0xffffff00; // make color transparent for 'alpha' flood mode to work
+    // bgcolor is 0xrrggbbaa, we need 0xaarrggbb
+    guint32 dtc = bgcolor >> 8; // keep color transparent; page color doesn't support transparency anymore
 
-        cairo_surface_flush(s);
-        cairo_surface_destroy(s);
-        
-        // Hide items
-        document->getRoot()->invoke_hide(dkey);
-    }
+    // Draw image into data block px
+    render_for_fill(desktop, px, stride, Geom::IntRect::from_xywh(img_origin, img_dims), bgcolor);
 
     // {
     //     // Dump data to png
@@ -803,9 +949,6 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, GdkEvent *event,
     guchar *trace_px = g_new(guchar, width * height);
     memset(trace_px, 0x00, width * height);
     
-    std::deque<Geom::Point> fill_queue;
-    std::queue<Geom::Point> color_queue;
-    
     std::vector<Geom::Point> fill_points;
     
     bool aborted = false;
@@ -853,182 +996,157 @@ static void sp_flood_do_flood_fill(SPDesktop *desktop, GdkEvent *event,
 
     auto const img_max_indices = Geom::Rect::from_xywh(0, 0, width - 1, height - 1);
 
-    for (unsigned int i = 0; i < fill_points.size(); i++) {
-        Geom::Point pw = fill_points[i] * world2img;
-
-        pw = img_max_indices.clamp(pw);
-
-        if (is_touch_fill) {
-            if (i == 0) {
-                color_queue.push(pw);
-            } else {
-                unsigned char *trace_t = get_trace_pixel(trace_px, (int)pw[Geom::X], (int)pw[Geom::Y], width);
-                push_point_onto_queue(&fill_queue, bci.max_queue_size, trace_t, (int)pw[Geom::X], (int)pw[Geom::Y]);
-            }
-        } else {
-            color_queue.push(pw);
-        }
+    std::vector<Geom::IntPoint> seeds;
+    for (auto const &point : fill_points) {
+        Geom::Point pw = img_max_indices.clamp(point * world2img);
+        seeds.emplace_back((int)pw[Geom::X], (int)pw[Geom::Y]);
     }
 
     bool reached_screen_boundary = false;
 
-    bool first_run = true;
-
-    unsigned long sort_size_threshold = 5;
-
     unsigned int min_y = height;
     unsigned int max_y = 0;
     unsigned int min_x = width;
     unsigned int max_x = 0;
 
-    while (!color_queue.empty() && !aborted) {
-        Geom::Point color_point = color_queue.front();
-        color_queue.pop();
-
-        int cx = (int)color_point[Geom::X];
-        int cy = (int)color_point[Geom::Y];
+    if (bci.radius == 0) {
+        auto paintable = PaintableRows(px, bci);
 
-        guint32 orig_color = get_pixel(px, cx, cy, stride);
-        bci.merged_orig_pixel = compose_onto(orig_color, dtc);
+        for (unsigned int i = 0; i < seeds.size() && !aborted; i++) {
+            auto const seed = seeds[i];
+            if (is_pixel_colored(get_trace_pixel(trace_px, seed.x(), seed.y(), width))) {
+                continue;
+            }
+            // A touch fill uses the color of the first point throughout.
+            if (i == 0 || !is_touch_fill) {
+                paintable.setTarget(get_pixel(px, seed.x(), seed.y(), stride));
+            }
+            fill_spans(paintable, trace_px, bci, seed.x(), seed.y(), aborted, reached_screen_boundary, min_x, max_x, min_y, max_y);
+        }
+    } else {
+        std::deque<Geom::Point> fill_queue;
+        std::queue<Geom::Point> color_queue;
 
-        unsigned char *trace_t = get_trace_pixel(trace_px, cx, cy, width);
-        if (!is_pixel_checked(trace_t) && !is_pixel_colored(trace_t)) {
-            if (check_if_pixel_is_paintable(px, trace_px, cx, cy, orig_color, bci)) {
-                shift_point_onto_queue(&fill_queue, bci.max_queue_size, trace_t, cx, cy);
+        for (unsigned int i = 0; i < seeds.size(); i++) {
+            Geom::Point pw = seeds[i];
 
-                if (!first_run) {
-                    for (unsigned int y = 0; y < height; y++) {
-                        trace_t = get_trace_pixel(trace_px, 0, y, width);
-                        for (unsigned int x = 0; x < width; x++) {
-                            clear_pixel_paintability(trace_t);
-                            trace_t++;
-                        }
-                    }
+            if (is_touch_fill) {
+                if (i == 0) {
+                    color_queue.push(pw);
+                } else {
+                    unsigned char *trace_t = get_trace_pixel(trace_px, (int)pw[Geom::X], (int)pw[Geom::Y], width);
+                    push_point_onto_queue(&fill_queue, bci.max_queue_size, trace_t, (int)pw[Geom::X], (int)pw[Geom::Y]);
                 }
-                first_run = false;
+            } else {
+                color_queue.push(pw);
             }
         }
 
-        unsigned long old_fill_queue_size = fill_queue.size();
-
-        while (!fill_queue.empty() && !aborted) {
-            Geom::Point cp = fill_queue.front();
-
-            if (bci.radius == 0) {
-                unsigned long new_fill_queue_size = fill_queue.size();
-
-                /*
-                 * To reduce the number of points in the fill queue, periodically
-                 * resort all of the points in the queue so that scanline checks
-                 * can complete more quickly.  A point cannot be checked twice
-                 * in a normal scanline checks, so forcing scanline checks to start
-                 * from one corner of the rendered area as often as possible
-                 * will reduce the number of points that need to be checked and queued.
-                 */
-                if (new_fill_queue_size > sort_size_threshold) {
-                    if (new_fill_queue_size > old_fill_queue_size) {
-                        std::sort(fill_queue.begin(), fill_queue.end(), sort_fill_queue_vertical);
-
-                        std::deque<Geom::Point>::iterator start_sort = fill_queue.begin();
-                        std::deque<Geom::Point>::iterator end_sort = fill_queue.begin();
-                        unsigned int sort_y = (unsigned int)cp[Geom::Y];
-                        unsigned int current_y;
-                        
-                        for (std::deque<Geom::Point>::iterator i = fill_queue.begin(); i != fill_queue.end(); ++i) {
-                            Geom::Point current = *i;
-                            current_y = (unsigned int)current[Geom::Y];
-                            if (current_y != sort_y) {
-                                if (start_sort != end_sort) {
-                                    std::sort(start_sort, end_sort, sort_fill_queue_horizontal);
-                                }
-                                sort_y = current_y;
-                                start_sort = i;
+        bool first_run = true;
+
+        while (!color_queue.empty() && !aborted) {
+            Geom::Point color_point = color_queue.front();
+            color_queue.pop();
+
+            int cx = (int)color_point[Geom::X];
+            int cy = (int)color_point[Geom::Y];
+
+            guint32 orig_color = get_pixel(px, cx, cy, stride);
+            bci.merged_orig_pixel = compose_onto(orig_color, dtc);
+
+            unsigned char *trace_t = get_trace_pixel(trace_px, cx, cy, width);
+            if (!is_pixel_checked(trace_t) && !is_pixel_colored(trace_t)) {
+                if (check_if_pixel_is_paintable(px, trace_px, cx, cy, orig_color, bci)) {
+                    shift_point_onto_queue(&fill_queue, bci.max_queue_size, trace_t, cx, cy);
+
+                    if (!first_run) {
+                        for (unsigned int y = 0; y < height; y++) {
+                            trace_t = get_trace_pixel(trace_px, 0, y, width);
+                            for (unsigned int x = 0; x < width; x++) {
+                                clear_pixel_paintability(trace_t);
+                                trace_t++;
                             }
-                            end_sort = i;
-                        }
-                        if (start_sort != end_sort) {
-                            std::sort(start_sort, end_sort, sort_fill_queue_horizontal);
                         }
-                        
-                        cp = fill_queue.front();
                     }
+                    first_run = false;
                 }
-
-                old_fill_queue_size = new_fill_queue_size;
             }
 
-            fill_queue.pop_front();
+            while (!fill_queue.empty() && !aborted) {
+                Geom::Point cp = fill_queue.front();
+                fill_queue.pop_front();
 
-            int x = (int)cp[Geom::X];
-            int y = (int)cp[Geom::Y];
+                int x = (int)cp[Geom::X];
+                int y = (int)cp[Geom::Y];
 
-            min_y = MIN((unsigned int)y, min_y);
-            max_y = MAX((unsigned int)y, max_y);
+                min_y = MIN((unsigned int)y, min_y);
+                max_y = MAX((unsigned int)y, max_y);
 
-            unsigned char *trace_t = get_trace_pixel(trace_px, x, y, width);
-            if (!is_pixel_checked(trace_t)) {
-                mark_pixel_checked(trace_t);
+                unsigned char *trace_t = get_trace_pixel(trace_px, x, y, width);
+                if (!is_pixel_checked(trace_t)) {
+                    mark_pixel_checked(trace_t);
 
-                if (y == 0) {
-                    if (bbox->min()[Geom::Y] > screen.min()[Geom::Y]) {
-                        aborted = true; break;
-                    } else {
-                        reached_screen_boundary = true;
+                    if (y == 0) {
+                        if (bbox->min()[Geom::Y] > screen.min()[Geom::Y]) {
+                            aborted = true; break;
+                        } else {
+                            reached_screen_boundary = true;
+                        }
                     }
-                }
 
-                if (y == y_limit) {
-                    if (bbox->max()[Geom::Y] < screen.max()[Geom::Y]) {
-                        aborted = true; break;
-                    } else {
-                        reached_screen_boundary = true;
+                    if (y == y_limit) {
+                        if (bbox->max()[Geom::Y] < screen.max()[Geom::Y]) {
+                            aborted = true; break;
+                        } else {
+                            reached_screen_boundary = true;
+                        }
                     }
-                }
 
-                bci.is_left = true;
-                bci.x = x;
-                bci.y = y;
-
-                ScanlineCheckResult result = perform_bitmap_scanline_check(&fill_queue, px, trace_px, orig_color, bci, &min_x, &max_x);
-
-                switch (result) {
-                    case SCANLINE_CHECK_ABORTED:
-                        aborted = true;
-                        break;
-                    case SCANLINE_CHECK_BOUNDARY:
-                        reached_screen_boundary = true;
-                        break;
-                    default:
-                        break;
-                }
+                    bci.is_left = true;
+                    bci.x = x;
+                    bci.y = y;
+
+                    ScanlineCheckResult result = perform_bitmap_scanline_check(&fill_queue, px, trace_px, orig_color, bci, &min_x, &max_x);
+
+                    switch (result) {
+                        case SCANLINE_CHECK_ABORTED:
+                            aborted = true;
+                            break;
+                        case SCANLINE_CHECK_BOUNDARY:
+                            reached_screen_boundary = true;
+                            break;
+                        default:
+                            break;
+                    }
 
-                if (bci.x < width) {
-                    trace_t++;
-                    if (!is_pixel_checked(trace_t) && !is_pixel_queued(trace_t)) {
-                        mark_pixel_checked(trace_t);
-                        bci.is_left = false;
-                        bci.x = x + 1;
-
-                        result = perform_bitmap_scanline_check(&fill_queue, px, trace_px, orig_color, bci, &min_x, &max_x);
-
-                        switch (result) {
-                            case SCANLINE_CHECK_ABORTED:
-                                aborted = true;
-                                break;
-                            case SCANLINE_CHECK_BOUNDARY:
-                                reached_screen_boundary = true;
-                                break;
-                            default:
-                                break;
+                    if (bci.x < width) {
+                        trace_t++;
+                        if (!is_pixel_checked(trace_t) && !is_pixel_queued(trace_t)) {
+                            mark_pixel_checked(trace_t);
+                            bci.is_left = false;
+                            bci.x = x + 1;
+
+                            result = perform_bitmap_scanline_check(&fill_queue, px, trace_px, orig_color, bci, &min_x, &max_x);
+
+                            switch (result) {
+                                case SCANLINE_CHECK_ABORTED:
+                                    aborted = true;
+                                    break;
+                                case SCANLINE_CHECK_BOUNDARY:
+                                    reached_screen_boundary = true;
+                                    break;
+                                default:
+                                    break;
+                            }
                         }
                     }
                 }
-            }
 
-            bci.current_step++;
+                bci.current_step++;
 
-            if (bci.current_step > bci.max_queue_size) {
-                aborted = true;
+                if (bci.current_step > bci.max_queue_size) {
+                    aborted = true;
+                }
             }
         }
     }
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * What the spray tool keeps for the duration of one stroke.
+ *
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "ui/tools/spray-stroke.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "color.h"
+#include "document.h"
+#include "display/cairo-utils.h"
+#include "display/drawing-context.h"
+#include "object/sp-item.h"
+
+namespace Inkscape {
+namespace UI {
+namespace Tools {
+
+guint32 composePickerData(double R, double G, double B, double A)
+{
+    //this can fix the bug #1511998 if confirmed
+    if ( A < 1e-6) {
+        R = 1.0;
+        G = 1.0;
+        B = 1.0;
+    }
+
+    return SP_RGBA32_F_COMPOSE(R, G, B, A);
+}
+
+guint32 SprayPickerTile::pick(Geom::IntRect const &area, Geom::Affine const &d2w, Render const &render, bool current)
+{
+    if (!_surface || !_rect.contains(area) || _d2w != d2w) {
+        _d2w = d2w;
+        _rect = area;
+        _rect.expandBy(MARGIN);
+        _surface = Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, _rect.width(), _rect.height());
+        auto dc = DrawingContext(_surface->cobj(), _rect.min());
+        render(dc, _rect);
+        _surface->flush();
+        if (current) {
+            _dirty.clear();
+        }
+    } else if (!_dirty.empty()) {
+        for (auto const &rect : _dirty) {
+            auto const part = rect & _rect;
+            if (!part) {
+                continue;
+            }
+            auto dc = DrawingContext(_surface->cobj(), _rect.min());
+            dc.rectangle(*part);
+            dc.clip();
+            dc.setOperator(CAIRO_OPERATOR_CLEAR);
+            dc.paint();
+            dc.setOperator(CAIRO_OPERATOR_OVER);
+            render(dc, *part);
+        }
+        _surface->flush();
+        if (current) {
+            _dirty.clear();
+        }
+    }
+
+    auto const offset = area.min() - _rect.min();
+    auto const stride = _surface->get_stride();
+    auto view = Cairo::ImageSurface::create(_surface->get_data() + offset.y() * stride + offset.x() * 4,
+                                            Cairo::FORMAT_ARGB32, area.width(), area.height(), stride);
+    double R, G, B, A;
+    ink_cairo_surface_average_color_premul(view->cobj(), R, G, B, A);
+
+    return composePickerData(R, G, B, A);
+}
+
+std::vector<SPItem *> SprayItemIndex::itemsPartiallyInBox(SPDocument *doc, unsigned dkey, Geom::Rect const &box)
+{
+    if (!_built) {
+        build(doc, dkey, box);
+    }
+
+    std::vector<std::size_t> found = _large;
+    auto const range = cell_range(box);
+    if (!range || cell_count(*range) > static_cast<std::int64_t>(_cells.size())) {
+        // Cheaper to look at every cell there is.
+        for (auto const &[key, entries] : _cells) {
+            found.insert(found.end(), entries.begin(), entries.end());
+        }
+    } else {
+        for_cells(*range, [&] (uint64_t key) {
+            if (auto it = _cells.find(key); it != _cells.end()) {
+                found.insert(found.end(), it->second.begin(), it->second.end());
+            }
+        });
+    }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    std::vector<SPItem *> result;
+    for (auto i : found) {
+        auto const &entry = _entries[i];
+        if (entry.item && entry.bounds.intersects(box)) {
+            result.push_back(entry.item);
+        }
+    }
+    return result;
+}
+
+void SprayItemIndex::add(SPItem *item)
+{
+    if (!_built) {
+        return;
+    }
+    if (auto bounds = item->documentVisualBounds()) {
+        insert(item, *bounds);
+    }
+}
+
+void SprayItemIndex::remove(SPItem *item)
+{
+    for (auto &entry : _entries) {
+        if (entry.item == item) {
+            entry.item = nullptr;
+        }
+    }
+}
+
+void SprayItemIndex::build(SPDocument *doc, unsigned dkey, Geom::Rect const &first_box)
+{
+    _built = true;
+    // Queries are about as large as the sprayed objects.
+    _cell_size = std::max(1.0, 2 * std::max(first_box.width(), first_box.height()));
+
+    auto const everywhere = Geom::Rect(-Geom::infinity(), -Geom::infinity(), Geom::infinity(), Geom::infinity());
+    for (auto item : doc->getItemsPartiallyInBox(dkey, everywhere)) {
+        if (auto bounds = item->documentVisualBounds()) {
+            insert(item, *bounds);
+        }
+    }
+}
+
+std::optional<Geom::IntRect> SprayItemIndex::cell_range(Geom::Rect const &rect) const
+{
+    // Leave a margin so that the far corner of a range still fits.
+    constexpr double limit = 1 << 30;
+    double const x0 = std::floor(rect.left()   / _cell_size);
+    double const y0 = std::floor(rect.top()    / _cell_size);
+    double const x1 = std::floor(rect.right()  / _cell_size);
+    double const y1 = std::floor(rect.bottom() / _cell_size);
+    // Also false for NaN.
+    if (!(x0 >= -limit && y0 >= -limit && x1 <= limit && y1 <= limit)) {
+        return {};
+    }
+    return Geom::IntRect(static_cast<int>(x0), static_cast<int>(y0), static_cast<int>(x1), static_cast<int>(y1));
+}
+
+std::int64_t SprayItemIndex::cell_count(Geom::IntRect const &range)
+{
+    return (static_cast<std::int64_t>(range.width()) + 1) * (static_cast<std::int64_t>(range.height()) + 1);
+}
+
+void SprayItemIndex::insert(SPItem *item, Geom::Rect const &bounds)
+{
+    auto const i = _entries.size();
+    _entries.push_back({ item, bounds });
+    auto const range = cell_range(bounds);
+    if (!range || cell_count(*range) > MAX_CELLS) {
+        _large.push_back(i);
+    } else {
+        for_cells(*range, [this, i] (uint64_t key) { _cells[key].push_back(i); });
+    }
+}
+
+} // namespace Tools
+} // namespace UI
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#ifndef INKSCAPE_UI_TOOLS_SPRAY_STROKE_H
+#define INKSCAPE_UI_TOOLS_SPRAY_STROKE_H
+
+/*
+ * What the spray tool keeps for the duration of one stroke.
+ *
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <glib.h>
+#include <cairomm/surface.h>
+#include <2geom/affine.h>
+#include <2geom/int-rect.h>
+#include <2geom/rect.h>
+
+class SPDocument;
+class SPItem;
+
+namespace Inkscape {
+
+class DrawingContext;
+
+namespace UI {
+namespace Tools {
+
+/// The picked colour for an average \a R, \a G, \a B, \a A.
+guint32 composePickerData(double R, double G, double B, double A);
+
+/**
+ * A rendering of the canvas around the last picked area. Candidates that are rejected leave the
+ * drawing as it was, so the next ones can pick from the same pixels instead of rendering again.
+ * Where copies are placed or erased, only their area is rendered again.
+ */
+class SprayPickerTile
+{
+public:
+    /// Renders \a area of the drawing, in world coordinates, into \a dc.
+    using Render = std::function<void (DrawingContext &dc, Geom::IntRect const &area)>;
+
+    /**
+     * The colour picked from \a area, in world coordinates, for the view \a d2w. \a current tells
+     * whether \a render shows the changes reported by invalidate() yet; the areas reported are
+     * rendered again on every pick until it does.
+     */
+    guint32 pick(Geom::IntRect const &area, Geom::Affine const &d2w, Render const &render, bool current);
+
+    /// Call when \a rect of the drawing, in world coordinates, has changed.
+    void invalidate(Geom::IntRect const &rect) { _dirty.push_back(rect); }
+
+    /// Call when the whole drawing has changed.
+    void invalidate() { _surface.clear(); }
+
+private:
+    static constexpr int MARGIN = 128; // In screen pixels.
+
+    Cairo::RefPtr<Cairo::ImageSurface> _surface;
+    Geom::IntRect _rect;
+    Geom::Affine _d2w; ///< The view the tile was rendered for.
+    std::vector<Geom::IntRect> _dirty; ///< Changed areas the tile may not show yet.
+};
+
+/**
+ * The items of the document by their visual bounds, bucketed on a grid. Built once per stroke
+ * and kept up to date with the copies sprayed and erased, so that each candidate does not have
+ * to walk the whole document.
+ */
+class SprayItemIndex
+{
+public:
+    /// Items partially in \a box, as SPDocument::getItemsPartiallyInBox() would find them.
+    std::vector<SPItem *> itemsPartiallyInBox(SPDocument *doc, unsigned dkey, Geom::Rect const &box);
+
+    /// Add an item placed during the stroke. Its document must be up to date.
+    void add(SPItem *item);
+
+    void remove(SPItem *item);
+
+private:
+    static constexpr int MAX_CELLS = 16; // Items covering more cells than this are kept in a list of their own.
+
+    struct Entry
+    {
+        SPItem *item;
+        Geom::Rect bounds;
+    };
+
+    bool _built = false;
+    double _cell_size = 1.0;
+    std::vector<Entry> _entries;
+    std::unordered_map<uint64_t, std::vector<std::size_t>> _cells;
+    std::vector<std::size_t> _large;
+
+    void build(SPDocument *doc, unsigned dkey, Geom::Rect const &first_box);
+    /// The cells touched by \a rect, or nothing if they cannot be numbered, as for infinite bounds.
+    std::optional<Geom::IntRect> cell_range(Geom::Rect const &rect) const;
+    static std::int64_t cell_count(Geom::IntRect const &range);
+    void insert(SPItem *item, Geom::Rect const &bounds);
+
+    /// Call \a f with the key of every cell in \a range.
+    template <typename F>
+    static void for_cells(Geom::IntRect const &range, F &&f)
+    {
+        for (int y = range.top(); y <= range.bottom(); y++) {
+            for (int x = range.left(); x <= range.right(); x++) {
+                auto const key = static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+                f(key);
+            }
+        }
+    }
+};
+
+/**
+ * What is kept for the duration of one stroke of the spray tool.
+ */
+struct SprayStroke
+{
+    SprayItemIndex index;
+    SprayPickerTile picker;
+};
+
+} // namespace Tools
+} // namespace UI
+} // namespace Inkscape
+
+#endif // INKSCAPE_UI_TOOLS_SPRAY_STROKE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -60,6 +60,7 @@
 
 #include "ui/icon-names.h"
 #include "ui/toolbar/spray-toolbar.h"
+#include "ui/tools/spray-stroke.h"
 #include "ui/tools/spray-tool.h"
 #include "ui/widget/canvas.h"
 
@@ -217,6 +218,19 @@ SprayTool::~SprayTool() {
     this->style_set_connection.disconnect();
 }
 
+SprayStroke &SprayTool::stroke()
+{
+    if (!_stroke) {
+        _stroke = std::make_unique<SprayStroke>();
+    }
+    return *_stroke;
+}
+
+void SprayTool::endStroke()
+{
+    _stroke.reset();
+}
+
 void SprayTool::update_cursor(bool /*with_shift*/) {
     guint num = 0;
     gchar *sel_message = nullptr;
@@ -429,14 +443,16 @@ static guint32 getPickerData(Geom::IntRect area, SPDesktop *desktop)
     double R, G, B, A;
     drawing->averageColor(area, R, G, B, A);
 
-    //this can fix the bug #1511998 if confirmed
-    if ( A < 1e-6) {
-        R = 1.0;
-        G = 1.0;
-        B = 1.0;
-    }
+    return composePickerData(R, G, B, A);
+}
 
-    return SP_RGBA32_F_COMPOSE(R, G, B, A);
+/// Tell the picker of \a stroke that \a item, which is up to date, is about to change on screen.
+static void invalidate_picked(SprayStroke &stroke, SPDesktop *desktop, SPItem *item)
+{
+    if (auto bounds = item->documentVisualBounds()) {
+        auto const rect = *bounds * desktop->doc2dt() * desktop->d2w();
+        stroke.picker.invalidate(rect.roundOutwards());
+    }
 }
 
 static void showHidden(std::vector<SPItem *> items_down){
@@ -447,6 +463,7 @@ static void showHidden(std::vector<SPItem *> items_down){
 }
 //todo: maybe move same parameter to preferences
 static bool fit_item(SPDesktop *desktop,
+                     SprayStroke &stroke,
                      SPItem *item,
                      Geom::OptRect bbox,
                      Geom::Point &move,
@@ -512,11 +529,16 @@ static bool fit_item(SPDesktop *desktop,
     double height_transformed = bbox_procesed->height();
     Geom::Point mid_point = desktop->d2w(bbox_procesed->midpoint());
     Geom::IntRect area = Geom::IntRect::from_xywh(floor(mid_point[Geom::X]), floor(mid_point[Geom::Y]), 1, 1);
-    guint32 rgba = getPickerData(area, desktop);
+    auto const render = [desktop] (DrawingContext &dc, Geom::IntRect const &area) {
+        desktop->getCanvasDrawing()->get_drawing()->render(dc, area);
+    };
+    // The copies placed so far are only in the drawing once the canvas has caught up with them.
+    bool const current = desktop->getCanvas()->update_now();
+    guint32 rgba = stroke.picker.pick(area, desktop->d2w(), render, current);
     guint32 rgba2 = 0xffffff00;
     Geom::Rect rect_sprayed(desktop->d2w(Geom::Point(bbox_left_main,bbox_top_main)), desktop->d2w(Geom::Point(bbox_right_main,bbox_bottom_main)));
     if (!rect_sprayed.hasZeroArea()) {
-        rgba2 = getPickerData(rect_sprayed.roundOutwards(), desktop);
+        rgba2 = stroke.picker.pick(rect_sprayed.roundOutwards(), desktop->d2w(), render, current);
     }
     if(pick_no_overlap) {
         if(rgba != rgba2) {
@@ -545,7 +567,7 @@ static bool fit_item(SPDesktop *desktop,
         offset_width = 0;
         offset_height = 0;
     }
-    std::vector<SPItem*> items_down = desktop->getDocument()->getItemsPartiallyInBox(desktop->dkey, *bbox_procesed);
+    std::vector<SPItem*> items_down = stroke.index.itemsPartiallyInBox(doc, desktop->dkey, *bbox_procesed);
     Inkscape::Selection *selection = desktop->getSelection();
     if (selection->isEmpty()) {
         return false;
@@ -572,6 +594,8 @@ static bool fit_item(SPDesktop *desktop,
             {
                 if(mode == SPRAY_MODE_ERASER) {
                     if(strcmp(item_down_sharp, spray_origin) != 0 && !selection->includes(item_down) ){
+                        stroke.index.remove(item_down);
+                        invalidate_picked(stroke, desktop, item_down);
                         item_down->deleteObject();
                         items_down_erased.pop_back();
                         break;
@@ -717,6 +741,7 @@ static bool fit_item(SPDesktop *desktop,
                         return false;
                     }
                     if(!fit_item(desktop
+                                 , stroke
                                  , item
                                  , bbox
                                  , move
@@ -820,6 +845,7 @@ static bool fit_item(SPDesktop *desktop,
 }
 
 static bool sp_spray_recursive(SPDesktop *desktop,
+                               SprayStroke &stroke,
                                Inkscape::ObjectSet *set,
                                SPItem *item,
                                SPItem *&single_path_output,
@@ -902,6 +928,7 @@ static bool sp_spray_recursive(SPDesktop *desktop,
                    pick_no_overlap || no_overlap || picker ||
                    !over_transparent || !over_no_transparent) {
                     if(!fit_item(desktop
+                                 , stroke
                                  , item
                                  , a
                                  , move
@@ -955,6 +982,10 @@ static bool sp_spray_recursive(SPDesktop *desktop,
                 if(picker){
                     sp_desktop_apply_css_recursive(item_copied, css, true);
                 }
+                // Bring the copy's bounds, and its display, up to date before using them.
+                doc->ensureUpToDate();
+                stroke.index.add(item_copied);
+                invalidate_picked(stroke, desktop, item_copied);
                 did = true;
             }
         }
@@ -1033,6 +1064,7 @@ static bool sp_spray_recursive(SPDesktop *desktop,
                    pick_no_overlap || no_overlap || picker ||
                    !over_transparent || !over_no_transparent) {
                     if(!fit_item(desktop
+                                 , stroke
                                  , item
                                  , a
                                  , move
@@ -1094,6 +1126,10 @@ static bool sp_spray_recursive(SPDesktop *desktop,
                     sp_desktop_apply_css_recursive(item_copied, css, true);
                 }
                 Inkscape::GC::release(clone);
+                // Bring the copy's bounds, and its display, up to date before using them.
+                doc->ensureUpToDate();
+                stroke.index.add(item_copied);
+                invalidate_picked(stroke, desktop, item_copied);
                 did = true;
             }
         }
@@ -1138,6 +1174,7 @@ static bool sp_spray_dilate(SprayTool *tc, Geom::Point /*event_p*/, Geom::Point
         for(auto item : items){
             g_assert(item != nullptr);
             if (sp_spray_recursive(desktop
+                                , tc->stroke()
                                 , set
                                 , item
                                 , tc->single_path_output
@@ -1246,6 +1283,7 @@ bool SprayTool::root_handler(GdkEvent* event) {
                 this->has_dilated = false;
 
                 object_set = *_desktop->getSelection();
+                endStroke();
                 if (mode == SPRAY_MODE_SINGLE_PATH) {
                     this->single_path_output = nullptr;
                 }
@@ -1320,6 +1358,7 @@ bool SprayTool::root_handler(GdkEvent* event) {
                             sp_spray_dilate(this, scroll_w, _desktop->dt2doc(scroll_dt), Geom::Point(0, 0), false);
                         }
                         this->has_dilated = true;
+                        endStroke();
 
                         this->population = temp;
                         _desktop->setToolboxAdjustmentValue("population", this->population * 100);
@@ -1365,6 +1404,7 @@ bool SprayTool::root_handler(GdkEvent* event) {
             }
             _desktop->getSelection()->clear();
             object_set.clear();
+            endStroke();
             break;
         }
 
@@ -21,6 +21,7 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <memory>
 #include <2geom/point.h>
 #include "ui/tools/tool-base.h"
 #include "object/object-set.h"
@@ -49,6 +50,8 @@ namespace Inkscape {
 namespace UI {
 namespace Tools {
 
+struct SprayStroke;
+
 enum {
     SPRAY_MODE_COPY,
     SPRAY_MODE_CLONE,
@@ -125,8 +128,13 @@ public:
     }
     SPItem* single_path_output = nullptr;
 
+    /// State kept from one spray to the next while the button is held down.
+    SprayStroke &stroke();
+    void endStroke();
+
 private:
     ObjectSet object_set;
+    std::unique_ptr<SprayStroke> _stroke;
 };
 
 }
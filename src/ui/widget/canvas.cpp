@@ -153,6 +153,7 @@ struct RedrawData
     uint64_t page, desk;
     bool debug_framecheck;
     bool debug_show_redraw;
+    std::shared_ptr<Inkscape::CMSTransform const> cms_transform;
 
     // State
     std::mutex mutex;
@@ -661,6 +662,11 @@ void CanvasPrivate::launch_redraw()
     rd.debug_framecheck = prefs.debug_framecheck;
     rd.debug_show_redraw = prefs.debug_show_redraw;
 
+    // The CMS system is only queried from the main thread; the transform itself is safe to share.
+    rd.cms_transform = !q->_cms_active ? nullptr
+                     : prefs.from_display ? Inkscape::CMSSystem::getDisplayPer(q->_cms_key)
+                     : Inkscape::CMSSystem::getDisplayTransform();
+
     rd.snapshot_drawn = stores.snapshot().drawn ? stores.snapshot().drawn->copy() : Cairo::RefPtr<Cairo::Region>();
     rd.grabbed = q->_grabbed_canvas_item && prefs.block_updates ? (roundedOutwards(q->_grabbed_canvas_item->get_bounds()) & rd.visible & rd.store.rect).regularized() : Geom::OptIntRect();
 
@@ -746,23 +752,6 @@ void CanvasPrivate::commit_tiles()
     }
 
     for (auto &tile : tiles) {
-        // Todo: Make CMS system thread-safe, then move this to render thread too.
-        if (q->_cms_active) {
-            auto transf = prefs.from_display
-                        ? Inkscape::CMSSystem::getDisplayPer(q->_cms_key)
-                        : Inkscape::CMSSystem::getDisplayTransform();
-            if (transf) {
-                tile.surface->flush();
-                auto px = tile.surface->get_data();
-                int stride = tile.surface->get_stride();
-                for (int i = 0; i < tile.surface->get_height(); i++) {
-                    auto row = px + i * stride;
-                    Inkscape::CMSSystem::doTransform(transf, row, row, tile.surface->get_width());
-                }
-                tile.surface->mark_dirty();
-            }
-        }
-
         // Paste tile content onto stores.
         graphics->draw_tile(tile.fragment, std::move(tile.surface), std::move(tile.outline_surface));
 
@@ -1639,6 +1628,20 @@ void Canvas::request_update()
     d->schedule_redraw();
 }
 
+bool Canvas::update_now()
+{
+    if (!_need_update) {
+        return true;
+    }
+    // Not while a redraw in the background is using the items.
+    if (_drawing->snapshotted() || d->canvasitem_ctx->snapshotted()) {
+        return false;
+    }
+    _need_update = false;
+    d->canvasitem_ctx->root()->update(false);
+    return true;
+}
+
 /**
  * Scroll window so drawing point 'pos' is at upper left corner of canvas.
  */
@@ -2400,6 +2403,18 @@ void CanvasPrivate::paint_rect(Geom::IntRect const &rect)
         tile.outline_surface = paint(false, true);
     }
 
+    // Apply colour management.
+    if (rd.cms_transform) {
+        tile.surface->flush();
+        auto px = tile.surface->get_data();
+        int stride = tile.surface->get_stride();
+        for (int i = 0; i < tile.surface->get_height(); i++) {
+            auto row = px + i * stride;
+            rd.cms_transform->apply(row, row, tile.surface->get_width());
+        }
+        tile.surface->mark_dirty();
+    }
+
     // Introduce an artificial delay for each rectangle.
     if (rd.redraw_delay) g_usleep(*rd.redraw_delay);
 
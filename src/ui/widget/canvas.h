@@ -112,6 +112,7 @@ public:
     void redraw_area(int x0, int y0, int x1, int y1);
     void redraw_area(Geom::Coord x0, Geom::Coord y0, Geom::Coord x1, Geom::Coord y1);
     void request_update();              // Mark geometry as needing recalculation.
+    bool update_now();                  // Recalculate geometry now if needed and possible. Returns whether it is up to date.
 
     // Callback run on destructor of any canvas item
     void canvas_item_destructed(Inkscape::CanvasItem *item);
@@ -571,19 +571,6 @@ ComboBoxEntryToolItem::combo_box_changed_cb( GtkComboBox* widget, gpointer data
   }
 }
 
-static gboolean add_more_font_families_idle(gpointer user_data)
-{
-    FontLister* fl = FontLister::get_instance();
-    static int q = 1;
-    static unsigned recurse_times = fl->get_font_families_size() / FONT_FAMILIES_GROUP_SIZE;
-
-    fl->init_font_families(q, FONT_FAMILIES_GROUP_SIZE);
-    if (q < recurse_times)
-        gdk_threads_add_idle (add_more_font_families_idle, NULL);
-    q++;
-    return false;
-}
-
 gboolean ComboBoxEntryToolItem::combo_box_popup_cb(ComboBoxEntryToolItem *widget, gpointer data)
 {
     auto action = reinterpret_cast<ComboBoxEntryToolItem *>( data );
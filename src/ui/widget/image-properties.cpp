@@ -42,7 +42,7 @@ namespace UI {
 namespace Widget {
 
 Cairo::RefPtr<Cairo::Surface> draw_preview(SPImage* image, double width, double height, int device_scale, uint32_t frame_color, uint32_t background) {
-    if (!image || !image->pixbuf) return Cairo::RefPtr<Cairo::Surface>();
+    if (!image || !image->getPixbuf()) return Cairo::RefPtr<Cairo::Surface>();
 
     object_renderer r;
     object_renderer::options opt;
@@ -147,7 +147,9 @@ ImageProperties::ImageProperties() :
     _embed.signal_clicked().connect([=](){
         if (_update.pending() || !_image) return;
         // embed image in the current document
-        Inkscape::Pixbuf copy(*_image->pixbuf);
+        auto pixbuf = _image->getPixbuf();
+        if (!pixbuf) return;
+        Inkscape::Pixbuf copy(*pixbuf);
         sp_embed_image(_image->getRepr(), &copy);
         DocumentUndo::done(_image->document, _("Embed image"), INKSCAPE_ICON("selection-make-bitmap-copy"));
     });
@@ -198,12 +200,13 @@ void ImageProperties::update(SPImage* image) {
             linked = true;
         }
 
-        if (image->pixbuf) {
+        auto const size = image->pixelSize();
+        if (size.x() > 0) {
             std::ostringstream ost;
             if (!image->missing) {
                 auto times = "\u00d7"; // multiplication sign
                 // dimensions
-                ost << image->pixbuf->width() << times << image->pixbuf->height() << " px\n";
+                ost << size.x() << times << size.y() << " px\n";
 
                 if (embedded) {
                     ost << _("Embedded");
@@ -229,7 +232,7 @@ void ImageProperties::update(SPImage* image) {
 
         url.set_text(linked ? href : "");
         url.set_sensitive(linked);
-        _embed.set_sensitive(linked && image->pixbuf);
+        _embed.set_sensitive(linked && size.x() > 0);
 
         // aspect ratio
         bool aspect_none = false;
@@ -249,9 +252,9 @@ void ImageProperties::update(SPImage* image) {
 
     int width = _preview_max_width;
     int height = _preview_max_height;
-    if (image && image->pixbuf) {
-        double sw = image->pixbuf->width();
-        double sh = image->pixbuf->height();
+    if (image && image->pixelSize().x() > 0) {
+        double sw = image->pixelSize().x();
+        double sh = image->pixelSize().y();
         double sx = sw / width;
         double sy = sh / height;
         auto scale = 1.0 / std::max(sx, sy);
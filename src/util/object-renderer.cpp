@@ -15,6 +15,7 @@
 #include <gdkmm/rgba.h>
 #include <glibmm/ustring.h>
 #include <optional>
+#include <sstream>
 #include "color.h"
 #include "display/cairo-utils.h"
 #include "document.h"
@@ -587,6 +588,21 @@ Cairo::RefPtr<Cairo::Surface> draw_frame(Cairo::RefPtr<Cairo::Surface> image, do
 }
 
 
+std::string object_renderer::options::cache_key() const {
+    std::ostringstream key;
+    key << _foreground.to_string() << ';' << _symbol_style_from_use << ';' << _image_opacity;
+    if (_add_background) {
+        key << ";bg:" << _background << ',' << _margin << ',' << _radius;
+    }
+    if (_draw_frame) {
+        key << ";frame:" << _frame_rgba << ',' << _stroke;
+    }
+    if (_checkerboard) {
+        key << ";checkerboard:" << *_checkerboard;
+    }
+    return key.str();
+}
+
 object_renderer:: object_renderer() {
 }
 
@@ -630,7 +646,8 @@ Cairo::RefPtr<Cairo::Surface> object_renderer::render(SPObject& object, double w
         surface = PatternManager::get().get_image(pattern, width, height, device_scale);
     }
     else if (auto image = cast<SPImage>(&object)) {
-        surface = render_image(image->pixbuf.get(), width, height, device_scale);
+        auto pixbuf = image->getPixbuf();
+        surface = render_image(pixbuf.get(), width, height, device_scale);
     }
     else {
         g_warning("object_renderer: don't know how to render this object type");
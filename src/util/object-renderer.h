@@ -8,6 +8,7 @@
 #include <glibmm/ustring.h>
 #include <memory>
 #include <optional>
+#include <string>
 #include "display/drawing.h"
 #include "object/sp-object.h"
 #include "document.h"
@@ -56,6 +57,9 @@ public:
             return *this;
         }
 
+        // a string that differs between options rendering differently, for caching previews
+        std::string cache_key() const;
+
     private:
         friend class object_renderer;
         Gdk::RGBA _foreground;
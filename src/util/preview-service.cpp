@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Shared queue and cache for previews of document resources.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+
+#include "util/preview-service.h"
+
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+#include <glibmm/checksum.h>
+#include <glibmm/main.h>
+
+#include "attributes.h"
+#include "document.h"
+#include "extract-uri.h"
+#include "object/sp-object.h"
+#include "object/sp-symbol.h"
+#include "util/statics.h"
+#include "xml/node.h"
+
+namespace Inkscape {
+
+namespace {
+
+// Enough for a few thousand typical previews.
+constexpr std::size_t DEFAULT_BUDGET = 64 << 20;
+
+// How long one idle callback may spend rendering, in microseconds.
+constexpr gint64 TIME_SLICE = 10000;
+
+std::size_t surface_bytes(Cairo::RefPtr<Cairo::Surface> const &surface)
+{
+    auto image = Cairo::RefPtr<Cairo::ImageSurface>::cast_dynamic(surface);
+    return image ? image->get_stride() * image->get_height() : 0;
+}
+
+class ContentHasher
+{
+public:
+    void add(SPObject const &object)
+    {
+        if (!_visited.insert(&object).second) {
+            return;
+        }
+        if (auto repr = object.getRepr()) {
+            _add(*repr, object.document);
+        }
+        // Symbol previews take their style from the <use> elements showing them.
+        if (is<SPSymbol>(&object)) {
+            for (auto use : object.hrefList) {
+                _update(use->getAttribute("style"));
+            }
+        }
+    }
+
+    /// Add what \a object inherits from its ancestors: their style, classes and presentation attributes.
+    void add_ancestors(SPObject const &object)
+    {
+        for (auto parent = object.parent; parent; parent = parent->parent) {
+            if (auto repr = parent->getRepr()) {
+                for (auto const &attribute : repr->attributeList()) {
+                    auto const name = g_quark_to_string(attribute.key);
+                    if (std::strcmp(name, "style") == 0 || std::strcmp(name, "class") == 0 ||
+                        SP_ATTRIBUTE_IS_CSS(sp_attribute_lookup(name))) {
+                        _update(name);
+                        _update(attribute.value);
+                    }
+                }
+            }
+            _update(nullptr); // Ends the attributes of one ancestor.
+        }
+    }
+
+    void add_text(char const *text) { _update(text); }
+
+    std::string get() { return _sum.get_string(); }
+
+private:
+    Glib::Checksum _sum{Glib::Checksum::CHECKSUM_SHA1};
+    std::unordered_set<SPObject const *> _visited;
+
+    void _update(char const *text)
+    {
+        if (text) {
+            _sum.update(reinterpret_cast<guchar const *>(text), std::strlen(text));
+        }
+        _sum.update(reinterpret_cast<guchar const *>(""), 1);
+    }
+
+    void _add(XML::Node const &node, SPDocument *document)
+    {
+        _update(node.name());
+        _update(node.content());
+        for (auto const &attribute : node.attributeList()) {
+            _update(g_quark_to_string(attribute.key));
+            _update(attribute.value);
+            _follow(attribute.value, document);
+        }
+        for (auto child = node.firstChild(); child; child = child->next()) {
+            _add(*child, document);
+        }
+        _update(nullptr); // Ends the list of children.
+    }
+
+    /// Add the objects referred to by "#id" or "url(#id)" in an attribute value.
+    void _follow(char const *value, SPDocument *document)
+    {
+        if (!value || !document) {
+            return;
+        }
+        if (value[0] == '#') {
+            _follow_id(value + 1, document);
+            return;
+        }
+        for (auto url = std::strstr(value, "url("); url; url = std::strstr(url + 1, "url(")) {
+            auto const uri = extract_uri(url);
+            if (uri.size() > 1 && uri[0] == '#') {
+                _follow_id(uri.c_str() + 1, document);
+            }
+        }
+    }
+
+    void _follow_id(char const *id, SPDocument *document)
+    {
+        if (auto object = document->getObjectById(id)) {
+            add(*object);
+        }
+    }
+};
+
+} // namespace
+
+PreviewService::PreviewService(std::size_t budget)
+    : _budget(budget)
+{}
+
+PreviewService &PreviewService::get()
+{
+    struct ConstructiblePreviewService : PreviewService
+    {
+        ConstructiblePreviewService() : PreviewService(DEFAULT_BUDGET) {}
+    };
+    static auto factory = Util::Static<ConstructiblePreviewService>();
+    return factory.get();
+}
+
+sigc::connection PreviewService::request(std::string const &key, std::function<Surface ()> render,
+                                         sigc::slot<void (Surface const &)> done)
+{
+    if (auto surface = lookup(key)) {
+        done(surface);
+        return {};
+    }
+
+    auto [it, inserted] = _jobs.try_emplace(key);
+    auto &job = it->second;
+    if (inserted) {
+        _queue.push_back(key);
+    } else {
+        job.prune();
+    }
+    // The render function may refer to things only its requester keeps alive.
+    auto connection = job.done.connect(std::move(done));
+    job.renders.emplace_back(connection, std::move(render));
+
+    if (!_idle) {
+        _idle = Glib::signal_idle().connect([this] {
+            return _run(g_get_monotonic_time() + TIME_SLICE);
+        });
+    }
+    return connection;
+}
+
+PreviewService::Surface PreviewService::lookup(std::string const &key)
+{
+    auto it = _cached.find(key);
+    if (it == _cached.end()) {
+        return {};
+    }
+    _lru.splice(_lru.begin(), _lru, it->second);
+    return it->second->second;
+}
+
+void PreviewService::flush()
+{
+    _run(std::numeric_limits<gint64>::max());
+    _idle.disconnect();
+}
+
+/// Render queued previews until \a deadline has passed. Returns whether any are left.
+bool PreviewService::_run(gint64 deadline)
+{
+    while (!_queue.empty()) {
+        if (g_get_monotonic_time() > deadline) {
+            return true;
+        }
+
+        auto const key = std::move(_queue.front());
+        _queue.pop_front();
+        auto it = _jobs.find(key);
+        if (it == _jobs.end()) {
+            continue;
+        }
+        auto job = std::move(it->second);
+        _jobs.erase(it);
+
+        if (!job.prune()) {
+            continue; // Everybody lost interest.
+        }
+        auto const surface = job.renders.front().second();
+        _store(key, surface);
+        job.done.emit(surface);
+    }
+    return false;
+}
+
+bool PreviewService::Job::prune()
+{
+    renders.remove_if([] (auto const &render) { return !render.first.connected(); });
+    return !renders.empty();
+}
+
+void PreviewService::_store(std::string const &key, Surface const &surface)
+{
+    if (!surface) {
+        return;
+    }
+
+    if (auto it = _cached.find(key); it != _cached.end()) {
+        _bytes -= surface_bytes(it->second->second);
+        _lru.erase(it->second);
+    }
+    _lru.emplace_front(key, surface);
+    _cached[key] = _lru.begin();
+    _bytes += surface_bytes(surface);
+    _trim();
+}
+
+void PreviewService::_trim()
+{
+    // Keep the newest one even if it is over budget on its own.
+    while (_bytes > _budget && _lru.size() > 1) {
+        auto const &[key, surface] = _lru.back();
+        _bytes -= surface_bytes(surface);
+        _cached.erase(key);
+        _lru.pop_back();
+    }
+}
+
+void PreviewService::set_budget(std::size_t budget)
+{
+    _budget = budget;
+    _trim();
+}
+
+void PreviewService::clear()
+{
+    _cached.clear();
+    _lru.clear();
+    _bytes = 0;
+}
+
+std::string PreviewService::context_key(SPDocument const &document)
+{
+    ContentHasher hasher;
+    hasher.add_text(document.getDocumentBase());
+    for (auto style : document.getObjectsByElement("style")) {
+        hasher.add(*style);
+    }
+    return hasher.get();
+}
+
+std::string PreviewService::content_key(SPObject const &object, std::string const &context)
+{
+    ContentHasher hasher;
+    hasher.add_text(context.c_str());
+    hasher.add(object);
+    hasher.add_ancestors(object);
+    return hasher.get();
+}
+
+} // namespace Inkscape
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Shared queue and cache for previews of document resources.
+ *
+ * Dialogs listing symbols, markers, patterns or gradients render a small image of each one. With
+ * thousands of resources, rendering them all up front stalls the main loop. Previews requested
+ * here are rendered a few at a time from an idle handler instead. Requests for the same content
+ * are rendered once, and the results are kept in a cache with a byte budget. A request can be
+ * cancelled, e.g. when its widget has been scrolled out of view, and is skipped when nobody waits
+ * for it any more.
+ *
+ * Rendering needs the SPObjects, which are not thread-safe, so it happens on the main thread.
+ * So far the Document Resources dialog uses it.
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ * Released under GNU GPL v2+, read the file 'COPYING' for more information.
+ */
+#ifndef INKSCAPE_UTIL_PREVIEW_SERVICE_H
+#define INKSCAPE_UTIL_PREVIEW_SERVICE_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <glib.h>
+#include <cairomm/refptr.h>
+#include <cairomm/surface.h>
+#include <sigc++/connection.h>
+#include <sigc++/signal.h>
+
+#include "helper/auto-connection.h"
+
+class SPDocument;
+class SPObject;
+
+namespace Inkscape {
+
+class PreviewService
+{
+public:
+    using Surface = Cairo::RefPtr<Cairo::Surface>;
+
+    /// A service caching up to \a budget bytes of previews.
+    explicit PreviewService(std::size_t budget);
+    PreviewService(PreviewService const &) = delete;
+    PreviewService &operator=(PreviewService const &) = delete;
+
+    /// The service shared by the dialogs.
+    static PreviewService &get();
+
+    /**
+     * Ask for the preview identified by \a key. If it is cached, \a done is called right away and
+     * the returned connection is empty. Otherwise the request is queued, and \a done is called
+     * from the main loop once the preview has been rendered by the \a render of one of the
+     * requests for \a key. Disconnecting the returned connection cancels the request; its
+     * \a render is never called afterwards, and is dropped no later than the next time the
+     * service looks at the requests for \a key.
+     */
+    sigc::connection request(std::string const &key, std::function<Surface ()> render,
+                             sigc::slot<void (Surface const &)> done);
+
+    /// The cached preview for \a key, or null.
+    Surface lookup(std::string const &key);
+
+    /// Render everything still queued right now.
+    void flush();
+
+    void set_budget(std::size_t budget);
+    std::size_t cached_bytes() const { return _bytes; }
+    void clear();
+
+    /**
+     * A key for what the objects of \a document take from it rather than from their own content:
+     * the location relative links resolve against, and the style sheets.
+     */
+    static std::string context_key(SPDocument const &document);
+
+    /**
+     * A key for previews of \a object which changes whenever its content does, including the
+     * content of the objects it links to and the style it inherits from its ancestors. \a context
+     * is the context_key() of its document, which is worth computing once for many objects.
+     */
+    static std::string content_key(SPObject const &object, std::string const &context);
+
+private:
+    struct Job
+    {
+        sigc::signal<void (Surface const &)> done;
+        /// The render function of each request, usable while the connection of that request is.
+        std::list<std::pair<sigc::connection, std::function<Surface ()>>> renders;
+
+        /// Drop the render functions of cancelled requests. Returns whether any are left.
+        bool prune();
+    };
+
+    bool _run(gint64 deadline);
+    void _store(std::string const &key, Surface const &surface);
+    void _trim();
+
+    std::unordered_map<std::string, Job> _jobs;
+    std::deque<std::string> _queue; ///< Keys of _jobs, oldest request first.
+    auto_connection _idle;
+
+    using Entry = std::pair<std::string, Surface>;
+    std::list<Entry> _lru; ///< Most recently used first.
+    std::unordered_map<std::string, std::list<Entry>::iterator> _cached;
+    std::size_t _bytes = 0;
+    std::size_t _budget;
+};
+
+} // namespace Inkscape
+
+#endif // INKSCAPE_UTIL_PREVIEW_SERVICE_H
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
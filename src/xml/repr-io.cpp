@@ -11,9 +11,11 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <stdexcept>
+#include <thread>
 
 #include <libxml/parser.h>
 #include <libxml/xinclude.h>
@@ -50,6 +52,8 @@ using Inkscape::XML::rebase_href_attrs;
 Document *sp_repr_do_read (xmlDocPtr doc, const gchar *default_ns);
 static Node *sp_repr_svg_read_node (Document *xml_doc, xmlNodePtr node, const gchar *default_ns, std::map<std::string, std::string> &prefix_map);
 static gint sp_repr_qualified_name (gchar *p, gint len, xmlNsPtr ns, const xmlChar *name, const gchar *default_ns, std::map<std::string, std::string> &prefix_map);
+static Glib::QueryQuark sp_repr_prepare_root_element(Node *repr, gchar const *default_ns,
+                                                     AttributeVector &attributes);
 static void sp_repr_write_stream_root_element(Node *repr, Writer &out,
                                               bool add_whitespace, gchar const *default_ns,
                                               int inlineattrs, int indent,
@@ -133,17 +137,7 @@ int XmlSource::setFile(char const *filename)
                 gzin = new Inkscape::IO::GzipInputStream(*instr);
 
                 memset( firstFew, 0, sizeof(firstFew) );
-                some = 0;
-                int single = 0;
-                while ( some < 4 && single >= 0 )
-                {
-                    single = gzin->get();
-                    if ( single >= 0 ) {
-                        firstFew[some++] = 0x0ff & single;
-                    } else {
-                        break;
-                    }
-                }
+                some = gzin->read(reinterpret_cast<char *>(firstFew), 4);
             }
 
             int encSkip = 0;
@@ -215,16 +209,7 @@ int XmlSource::read( char *buffer, int len )
         firstFewLen -= some;
         got = some;
     } else if ( gzin ) {
-        int single = 0;
-        while ( (static_cast<int>(got) < len) && (single >= 0) )
-        {
-            single = gzin->get();
-            if ( single >= 0 ) {
-                buffer[got++] = 0x0ff & single;
-            } else {
-                break;
-            }
-        }
+        got = gzin->read(buffer, len);
     } else {
         got = fread( buffer, 1, len, fp );
     }
@@ -368,7 +353,8 @@ namespace {
 typedef std::map<Glib::QueryQuark, Glib::QueryQuark, Inkscape::compare_quark_ids> PrefixMap;
 
 Glib::QueryQuark qname_prefix(Glib::QueryQuark qname) {
-    static PrefixMap prefix_map;
+    // Per thread, as snapshots may be written from a worker thread
+    static thread_local PrefixMap prefix_map;
     PrefixMap::iterator iter = prefix_map.find(qname);
     if ( iter != prefix_map.end() ) {
         return (*iter).second;
@@ -642,12 +628,18 @@ Glib::ustring sp_repr_save_buf(Document *doc)
 }
 
 
+/// How many threads may compress a document being saved as SVGZ.
+static int sp_repr_compress_threads()
+{
+    return Inkscape::Preferences::get()->getIntLimited("/options/threading/numthreads", std::thread::hardware_concurrency(), 1, 256);
+}
+
 void sp_repr_save_stream(Document *doc, FILE *fp, gchar const *default_ns, bool compress,
                     gchar const *const old_href_abs_base,
                     gchar const *const new_href_abs_base)
 {
     Inkscape::IO::FileOutputStream bout(fp);
-    Inkscape::IO::GzipOutputStream *gout = compress ? new Inkscape::IO::GzipOutputStream(bout) : nullptr;
+    Inkscape::IO::GzipOutputStream *gout = compress ? new Inkscape::IO::GzipOutputStream(bout, sp_repr_compress_threads()) : nullptr;
     Inkscape::IO::OutputStreamWriter *out  = compress ? new Inkscape::IO::OutputStreamWriter( *gout ) : new Inkscape::IO::OutputStreamWriter( bout );
 
     sp_repr_save_writer(doc, out, default_ns, old_href_abs_base, new_href_abs_base);
@@ -658,6 +650,75 @@ void sp_repr_save_stream(Document *doc, FILE *fp, gchar const *default_ns, bool
 
 
 
+namespace Inkscape {
+namespace XML {
+
+SaveSnapshot::SaveSnapshot(Document *doc, gchar const *default_ns)
+    : _doc(new SimpleDocument())
+{
+    Inkscape::Preferences *prefs = Inkscape::Preferences::get();
+    _inlineattrs = prefs->getBool("/options/svgoutput/inlineattrs");
+    _indent = prefs->getInt("/options/svgoutput/indent", 2);
+    _threads = sp_repr_compress_threads();
+
+    if (auto doctype = static_cast<Node *>(doc)->attribute("doctype")) {
+        _doc->setAttribute("doctype", doctype);
+    }
+
+    for (Node *child = doc->firstChild(); child; child = child->next()) {
+        Node *copy = child->duplicate(_doc);
+        _doc->appendChild(copy);
+        Inkscape::GC::release(copy);
+
+        if (copy->type() == NodeType::ELEMENT_NODE) {
+            // Namespace declarations are stored on the copy itself, so that save() doesn't
+            // have to allocate anything for the root element.
+            AttributeVector attributes;
+            _elide_prefix = sp_repr_prepare_root_element(copy, default_ns, attributes);
+            for (auto const &attr : attributes) {
+                if (!copy->attribute(g_quark_to_string(attr.key))) {
+                    copy->setAttribute(g_quark_to_string(attr.key), attr.value.pointer());
+                }
+            }
+        }
+    }
+}
+
+SaveSnapshot::~SaveSnapshot()
+{
+    Inkscape::GC::release(_doc);
+}
+
+/**
+ * Write the snapshot to a file. Only reads the copied tree, so this may be called from
+ * any thread while the original document keeps changing.
+ */
+void SaveSnapshot::save(FILE *fp, bool compress) const
+{
+    Inkscape::IO::FileOutputStream bout(fp);
+    Inkscape::IO::GzipOutputStream *gout = compress ? new Inkscape::IO::GzipOutputStream(bout, _threads) : nullptr;
+    Inkscape::IO::OutputStreamWriter *out  = compress ? new Inkscape::IO::OutputStreamWriter( *gout ) : new Inkscape::IO::OutputStreamWriter( bout );
+
+    out->writeString( "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n" );
+
+    if (auto doctype = static_cast<Node *>(_doc)->attribute("doctype")) {
+        out->writeString( doctype );
+    }
+
+    for (Node *repr = _doc->firstChild(); repr; repr = repr->next()) {
+        sp_repr_write_stream(repr, *out, 0, TRUE, _elide_prefix, _inlineattrs, _indent);
+        if ( repr->type() == Inkscape::XML::NodeType::COMMENT_NODE ) {
+            out->writeChar('\n');
+        }
+    }
+
+    delete out;
+    delete gout;
+}
+
+} // namespace XML
+} // namespace Inkscape
+
 /**
  * Returns true if file successfully saved.
  *
@@ -732,29 +793,44 @@ static void repr_quote_write (Writer &out, const gchar * val, bool attr)
 {
     if (val) {
         for (; *val != '\0'; val++) {
+            // Copy the run up to the next character needing an escape in one go.
+            auto const plain = std::strcspn(val, "\"&<>\n");
+            if (plain) {
+                out.write(val, plain);
+                val += plain;
+                if (*val == '\0') {
+                    break;
+                }
+            }
             switch (*val) {
                 case '"': out.writeString( "&quot;" ); break;
                 case '&': out.writeString( "&amp;" ); break;
                 case '<': out.writeString( "&lt;" ); break;
                 case '>': out.writeString( "&gt;" ); break;
                 case '\n': out.writeString( attr ? "&#10;" : "\n" ); break;
-                default: out.writeChar( *val ); break;
             }
         }
     }
 }
 
+/// Write \a levels times \a indent spaces.
+static void repr_write_indent(Writer &out, gint levels, int indent)
+{
+    static char const spaces[] = "                                                                ";
+    for (auto n = static_cast<std::size_t>(std::max(levels * indent, 0)); n > 0;) {
+        auto const chunk = std::min(n, sizeof(spaces) - 1);
+        out.write(spaces, chunk);
+        n -= chunk;
+    }
+}
+
 static void repr_write_comment( Writer &out, const gchar * val, bool addWhitespace, gint indentLevel, int indent )
 {
     if ( indentLevel > 16 ) {
         indentLevel = 16;
     }
     if (addWhitespace && indent) {
-        for (gint i = 0; i < indentLevel; i++) {
-            for (gint j = 0; j < indent; j++) {
-                out.writeChar(' ');
-            }
-        }
+        repr_write_indent(out, indentLevel, indent);
     }
 
     out.printf("<!--%s-->", val);
@@ -770,7 +846,7 @@ typedef std::map<Glib::QueryQuark, gchar const *, Inkscape::compare_quark_ids> L
 typedef std::map<Glib::QueryQuark, Inkscape::Util::ptr_shared, Inkscape::compare_quark_ids> NSMap;
 
 gchar const *qname_local_name(Glib::QueryQuark qname) {
-    static LocalNameMap local_name_map;
+    static thread_local LocalNameMap local_name_map;
     LocalNameMap::iterator iter = local_name_map.find(qname);
     if ( iter != local_name_map.end() ) {
         return (*iter).second;
@@ -826,11 +902,15 @@ void populate_ns_map(NSMap &ns_map, Node &repr) {
 
 }
 
-static void sp_repr_write_stream_root_element(Node *repr, Writer &out,
-                                  bool add_whitespace, gchar const *default_ns,
-                                  int inlineattrs, int indent,
-                                  gchar const *const old_href_base,
-                                  gchar const *const new_href_base)
+/**
+ * Prepare the root element for writing: clean and sort attributes as set in the preferences,
+ * and compute the namespace declarations.
+ *
+ * @param attributes Receives the attributes of the root element including xmlns declarations.
+ * @return The namespace prefix which can be elided from element names.
+ */
+static Glib::QueryQuark sp_repr_prepare_root_element(Node *repr, gchar const *default_ns,
+                                                     AttributeVector &attributes)
 {
     using Inkscape::Util::ptr_shared;
 
@@ -855,7 +935,7 @@ static void sp_repr_write_stream_root_element(Node *repr, Writer &out,
         elide_prefix = g_quark_from_string(sp_xml_ns_uri_prefix(default_ns, nullptr));
     }
 
-    auto attributes = repr->attributeList(); // copy
+    attributes = repr->attributeList(); // copy
 
     using Inkscape::Util::share_string;
     for (auto iter : ns_map) 
@@ -883,6 +963,18 @@ static void sp_repr_write_stream_root_element(Node *repr, Writer &out,
         }
     }
 
+    return elide_prefix;
+}
+
+static void sp_repr_write_stream_root_element(Node *repr, Writer &out,
+                                  bool add_whitespace, gchar const *default_ns,
+                                  int inlineattrs, int indent,
+                                  gchar const *const old_href_base,
+                                  gchar const *const new_href_base)
+{
+    AttributeVector attributes;
+    auto elide_prefix = sp_repr_prepare_root_element(repr, default_ns, attributes);
+
     return sp_repr_write_stream_element(repr, out, 0, add_whitespace, elide_prefix, attributes,
                                         inlineattrs, indent, old_href_base, new_href_base);
 }
@@ -951,11 +1043,7 @@ void sp_repr_write_stream_element( Node * repr, Writer & out,
     }
 
     if (add_whitespace && indent) {
-        for (gint i = 0; i < indent_level; i++) {
-            for (gint j = 0; j < indent; j++) {
-                out.writeChar(' ');
-            }
-        }
+        repr_write_indent(out, indent_level, indent);
     }
 
     GQuark code = repr->code();
@@ -982,16 +1070,17 @@ void sp_repr_write_stream_element( Node * repr, Writer & out,
         }
     }
 
-    const auto rbd = rebase_href_attrs(old_href_base, new_href_base, attributes);
+    // Only copy the attributes when hrefs actually need rebasing
+    AttributeVector rebased;
+    if (old_href_base != new_href_base) {
+        rebased = rebase_href_attrs(old_href_base, new_href_base, attributes);
+    }
+    auto const &rbd = old_href_base != new_href_base ? rebased : attributes;
     for (const auto &iter : rbd) {
         if (!inlineattrs) {
             out.writeChar('\n');
             if (indent) {
-                for ( gint i = 0 ; i < indent_level + 1 ; i++ ) {
-                    for ( gint j = 0 ; j < indent ; j++ ) {
-                        out.writeChar(' ');
-                    }
-                }
+                repr_write_indent(out, indent_level + 1, indent);
             }
         }
         out.printf(" %s=\"", g_quark_to_string(iter.key));
@@ -1019,11 +1108,7 @@ void sp_repr_write_stream_element( Node * repr, Writer & out,
         }
 
         if (loose && add_whitespace && indent) {
-            for (gint i = 0; i < indent_level; i++) {
-                for ( gint j = 0 ; j < indent ; j++ ) {
-                    out.writeChar(' ');
-                }
-            }
+            repr_write_indent(out, indent_level, indent);
         }
         out.printf( "</%s>", element_name );
     } else {
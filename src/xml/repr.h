@@ -73,6 +73,39 @@ bool sp_repr_save_rebased_file(Inkscape::XML::Document *doc, char const *filenam
                                char const *default_ns,
                                char const *old_base, char const *new_base_filename);
 
+namespace Inkscape {
+namespace XML {
+
+/**
+ * A detached copy of a document which can be written out from a worker thread.
+ *
+ * Taking a snapshot copies every node, so it takes time and memory in proportion to
+ * the size of the document, though attribute values and text are shared with the
+ * original tree rather than copied. Serializing and compressing, which take longer,
+ * are what is left for save(). Everything that needs the preferences or modifies
+ * nodes happens in the constructor. Create and destroy snapshots on the main thread.
+ */
+class SaveSnapshot
+{
+public:
+    SaveSnapshot(Document *doc, char const *default_ns);
+    ~SaveSnapshot();
+    SaveSnapshot(SaveSnapshot const &) = delete;
+    SaveSnapshot &operator=(SaveSnapshot const &) = delete;
+
+    void save(FILE *to_file, bool compress = false) const;
+
+private:
+    Document *_doc;
+    GQuark _elide_prefix = 0;
+    bool _inlineattrs = false;
+    int _indent = 2;
+    int _threads = 1;
+};
+
+} // namespace XML
+} // namespace Inkscape
+
 
 /* CSS stuff */
 
@@ -2,9 +2,12 @@
 #include <functional>
 #include <optional>
 #include <cmath>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include "async/progress.h"
 #include "async/progress-splitter.h"
+#include "async/parallel-progress.h"
 using namespace Inkscape::Async;
 
 TEST(ProgressTest, subprogress)
@@ -129,3 +132,47 @@ TEST(ProgressTest, splitter)
     x->report(0.5); EXPECT_NEAR(a.saved, 0.25, 1e-5);
     z->report(0.5); EXPECT_NEAR(a.saved, 0.75, 1e-5);
 }
+
+TEST(ProgressTest, parallel)
+{
+    class ProgressMock final
+       : public Progress<double>
+    {
+    public:
+        double saved = -1.0;
+        bool ret = true;
+
+    protected:
+        bool _keepgoing() const override { return ret; }
+        bool _report(double const &progress) override { saved = progress; return ret; }
+    };
+
+    auto a = ProgressMock();
+    auto p = ParallelProgress(a, 4);
+    ASSERT_EQ(p.size(), 4);
+
+    p[0].report(1.0); EXPECT_NEAR(a.saved, 0.25, 1e-5);
+    p[2].report(0.5); EXPECT_NEAR(a.saved, 0.375, 1e-5);
+    p[0].report(0.0); EXPECT_NEAR(a.saved, 0.125, 1e-5);
+
+    for (int i = 0; i < 4; i++) {
+        p[i].report(0.0);
+    }
+
+    int constexpr N = 1000;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&, i] {
+            for (int j = 1; j <= N; j++) {
+                p[i].report((double)j / N);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_NEAR(a.saved, 1.0, 1e-5);
+
+    a.ret = false;
+    EXPECT_THROW(p[1].throw_if_cancelled(), CancelledException);
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for exporting documents through the Cairo renderer
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+#include <glib/gstdio.h>
+
+#include <src/display/drawing.h>
+#include <src/document.h>
+#include <src/extension/internal/cairo-render-context.h>
+#include <src/extension/internal/cairo-renderer.h>
+#include <src/inkscape.h>
+#include <src/object/sp-root.h>
+
+using namespace Inkscape;
+using namespace Inkscape::Extension::Internal;
+
+class CairoRendererTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // setup hidden dependency
+        Application::create(false);
+    }
+
+    /// Export \a svg to PDF, rasterizing filters, and return the file's contents.
+    static std::string export_pdf(char const *svg)
+    {
+        auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDocFromMem(svg, std::strlen(svg), false));
+        EXPECT_TRUE(doc);
+        if (!doc) {
+            return {};
+        }
+        doc->ensureUpToDate();
+
+        auto root = doc->getRoot();
+        Drawing drawing;
+        auto const dkey = SPItem::display_key_new(1);
+        drawing.setRoot(root->invoke_show(drawing, dkey, SP_ITEM_SHOW_DISPLAY));
+        drawing.setExact();
+
+        auto const filename = std::string(g_get_tmp_dir()) + "/CairoRendererTest.pdf";
+        CairoRenderer renderer;
+        auto ctx = renderer.createContext();
+        ctx->setPDFLevel(0); // No object streams, so the objects can be counted.
+        ctx->setFilterToBitmap(true);
+        ctx->setBitmapResolution(96);
+        EXPECT_TRUE(ctx->setPdfTarget(filename.c_str()));
+        EXPECT_TRUE(renderer.setupDocument(ctx, doc.get(), root));
+        EXPECT_TRUE(renderer.renderPages(ctx, doc.get(), false));
+        ctx->finish();
+        renderer.destroyContext(ctx);
+        root->invoke_hide(dkey);
+
+        gchar *contents = nullptr;
+        gsize length = 0;
+        EXPECT_TRUE(g_file_get_contents(filename.c_str(), &contents, &length, nullptr));
+        auto result = std::string(contents ? contents : "", length);
+        g_free(contents);
+        g_remove(filename.c_str());
+        return result;
+    }
+
+    static int count(std::string const &haystack, std::string const &needle)
+    {
+        int result = 0;
+        for (auto pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+            result++;
+        }
+        return result;
+    }
+};
+
+TEST_F(CairoRendererTest, filteredItemsInAnchorsAndSwitches)
+{
+    auto const defs = R"(
+  <sodipodi:namedview><inkscape:page x="0" y="0" width="200" height="100"/></sodipodi:namedview>
+  <defs><filter id="blur"><feGaussianBlur stdDeviation="2"/></filter></defs>)";
+
+    auto const linked = std::string(R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink"
+     xmlns:sodipodi="http://sodipodi.sourceforge.net/DTD/sodipodi-0.dtd"
+     xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape" width="200" height="100">)") + defs + R"(
+  <a xlink:href="https://inkscape.org/">
+    <rect x="10" y="10" width="50" height="50" fill="#ff0000" filter="url(#blur)"/>
+  </a>
+  <switch>
+    <rect x="110" y="10" width="50" height="50" fill="#00ff00" filter="url(#blur)"/>
+    <rect x="110" y="10" width="50" height="50" fill="#0000ff" filter="url(#blur)"/>
+  </switch>
+</svg>)";
+
+    auto const plain = std::string(R"(<svg xmlns="http://www.w3.org/2000/svg"
+     xmlns:sodipodi="http://sodipodi.sourceforge.net/DTD/sodipodi-0.dtd"
+     xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape" width="200" height="100">)") + defs + R"(
+  <rect x="10" y="10" width="50" height="50" fill="#ff0000" filter="url(#blur)"/>
+  <rect x="110" y="10" width="50" height="50" fill="#00ff00" filter="url(#blur)"/>
+</svg>)";
+
+    auto const linked_pdf = export_pdf(linked.c_str());
+    auto const plain_pdf = export_pdf(plain.c_str());
+
+    // Each filtered item that is drawn ends up as a bitmap once; the switch draws only one child.
+    auto const images = count(plain_pdf, "/Subtype /Image");
+    EXPECT_GT(images, 0);
+    EXPECT_EQ(count(linked_pdf, "/Subtype /Image"), images);
+    EXPECT_EQ(count(linked_pdf, "/URI (https://inkscape.org/)"), 1);
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
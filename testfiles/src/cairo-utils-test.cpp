@@ -48,4 +48,54 @@ TEST_F(PixbufTest, creatingFromSvgUriWithoutViewboxOrWidthAndHeightReturnsNull)
     double default_dpi = 96.0;
 
     ASSERT_EQ(Inkscape::Pixbuf::create_from_data_uri(uri_data.c_str(), default_dpi), nullptr);
-}
\ No newline at end of file
+}
+
+TEST_F(PixbufTest, probingDataUriReadsSizeWithoutDecoding)
+{
+    // A 3x2 RGB PNG.
+    std::string uri_data = "image/png;base64,iVBORw0KGgoAAAANSUhEUgAAAAMAAAACCAIAAAASFvFNAAAAEElEQVR4nGP4z8AAQQxwFgBB0gX7h/C5SAAAAABJRU5ErkJggg==";
+
+    auto size = Inkscape::Pixbuf::probe_data_uri(uri_data.c_str());
+    ASSERT_TRUE(size);
+    EXPECT_EQ(*size, Geom::IntPoint(3, 2));
+
+    auto pixbuf = std::unique_ptr<Inkscape::Pixbuf>(Inkscape::Pixbuf::create_from_data_uri(uri_data.c_str()));
+    ASSERT_TRUE(pixbuf);
+    EXPECT_EQ(Geom::IntPoint(pixbuf->width(), pixbuf->height()), *size);
+}
+
+TEST_F(PixbufTest, probingPngNeedsOnlyItsHeader)
+{
+    // The signature and IHDR chunk of a 60000x40000 PNG, with no image data after them.
+    std::string uri_data = "image/png;base64,iVBORw0KGgoAAAANSUhEUgAA6mAAAJxACAIAAACHpAIy";
+
+    auto size = Inkscape::Pixbuf::probe_data_uri(uri_data.c_str());
+    ASSERT_TRUE(size);
+    EXPECT_EQ(*size, Geom::IntPoint(60000, 40000));
+}
+
+TEST_F(PixbufTest, probingAppliesEmbeddedOrientation)
+{
+    // A 3x2 greyscale JPEG whose EXIF orientation (6) turns it by 90 degrees.
+    std::string uri_data = "image/jpeg;base64,/9j/4QAiRXhpZgAATU0AKgAAAAgAAQESAAMAAAABAAYAAAAAAAD/2wBDABALDA4MChAODQ4SERATGCgaGBYWGDEjJR0oOjM9PDkzODdASFxOQERXRTc4UG1RV19iZ2hnPk1xeXBkeFxlZ2P/wAALCAACAAMBAREA/8QAFAABAAAAAAAAAAAAAAAAAAAAAP/EABQQAQAAAAAAAAAAAAAAAAAAAAD/2gAIAQEAAD8AP//Z";
+
+    auto size = Inkscape::Pixbuf::probe_data_uri(uri_data.c_str());
+    ASSERT_TRUE(size);
+    EXPECT_EQ(*size, Geom::IntPoint(2, 3));
+
+    auto pixbuf = std::unique_ptr<Inkscape::Pixbuf>(Inkscape::Pixbuf::create_from_data_uri(uri_data.c_str()));
+    ASSERT_TRUE(pixbuf);
+    EXPECT_EQ(Geom::IntPoint(pixbuf->width(), pixbuf->height()), *size);
+}
+
+TEST_F(PixbufTest, probingLeavesOutSvgAndGarbage)
+{
+    std::string svg_data = "image/svg+xml;base64," + base64of("<svg width=\"10\" height=\"10\"/>");
+    EXPECT_FALSE(Inkscape::Pixbuf::probe_data_uri(svg_data.c_str()));
+
+    std::string garbage = "image/png;base64," + base64of("not an image");
+    EXPECT_FALSE(Inkscape::Pixbuf::probe_data_uri(garbage.c_str()));
+
+    EXPECT_FALSE(Inkscape::Pixbuf::probe_file("does-not-exist.png"));
+    EXPECT_FALSE(Inkscape::Pixbuf::probe_file("drawing.svg"));
+}
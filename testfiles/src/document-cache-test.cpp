@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the cache of opened documents
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <fstream>
+#include <memory>
+#include <gtest/gtest.h>
+#include <giomm/file.h>
+#include <giomm/fileinfo.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <src/document.h>
+#include <src/inkscape.h>
+#include <src/io/document-cache.h>
+#include <src/object/sp-object.h>
+
+using namespace Inkscape;
+
+class DocumentCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // setup hidden dependency
+        Application::create(false);
+        write(path, "rect1");
+        write(other, "rect2");
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+        std::remove(other.c_str());
+    }
+
+    static void write(std::string const &filename, std::string const &id)
+    {
+        std::ofstream out(filename);
+        out << R"(<svg xmlns="http://www.w3.org/2000/svg" width="100" height="100"><rect id=")" << id
+            << R"(" width="10" height="10"/></svg>)";
+    }
+
+    std::string path = Glib::build_filename(Glib::get_tmp_dir(), "document-cache-test.svg");
+    std::string other = Glib::build_filename(Glib::get_tmp_dir(), "document-cache-test-other.svg");
+};
+
+TEST_F(DocumentCacheTest, reopeningUsesCache)
+{
+    auto cache = IO::DocumentCache(4);
+    auto file = Gio::File::create_for_path(path);
+
+    bool hit = true;
+    auto first = cache.open(file, nullptr, &hit);
+    ASSERT_TRUE(first);
+    EXPECT_FALSE(hit);
+
+    auto second = cache.open(file, nullptr, &hit);
+    ASSERT_TRUE(second);
+    EXPECT_TRUE(hit);
+    EXPECT_STREQ(second->getDocumentFilename(), first->getDocumentFilename());
+
+    // Documents handed out do not share their content.
+    first->getObjectById("rect1")->deleteObject();
+    EXPECT_FALSE(first->getObjectById("rect1"));
+    EXPECT_TRUE(second->getObjectById("rect1"));
+    EXPECT_TRUE(cache.open(file)->getObjectById("rect1"));
+}
+
+TEST_F(DocumentCacheTest, changedFileIsReread)
+{
+    auto cache = IO::DocumentCache(4);
+    auto file = Gio::File::create_for_path(path);
+    ASSERT_TRUE(cache.open(file));
+
+    write(path, "rect-changed");
+
+    bool hit = true;
+    auto doc = cache.open(file, nullptr, &hit);
+    ASSERT_TRUE(doc);
+    EXPECT_FALSE(hit);
+    EXPECT_TRUE(doc->getObjectById("rect-changed"));
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST_F(DocumentCacheTest, changeOfSameSizeWithinASecondIsReread)
+{
+    auto cache = IO::DocumentCache(4);
+    auto file = Gio::File::create_for_path(path);
+    ASSERT_TRUE(cache.open(file));
+
+    auto const attributes = G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC;
+    auto const before = file->query_info(attributes);
+    write(path, "rect9");
+
+    // Only the microseconds of the modification time tell.
+    auto const after = Gio::FileInfo::create();
+    after->set_attribute_uint64(G_FILE_ATTRIBUTE_TIME_MODIFIED, before->get_attribute_uint64(G_FILE_ATTRIBUTE_TIME_MODIFIED));
+    after->set_attribute_uint32(G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                                (before->get_attribute_uint32(G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC) + 1) % 1000000);
+    file->set_attributes_from_info(after);
+
+    bool hit = true;
+    auto doc = cache.open(file, nullptr, &hit);
+    ASSERT_TRUE(doc);
+    EXPECT_FALSE(hit);
+    EXPECT_TRUE(doc->getObjectById("rect9"));
+}
+
+TEST_F(DocumentCacheTest, leastRecentlyUsedIsDropped)
+{
+    auto cache = IO::DocumentCache(1);
+    auto file = Gio::File::create_for_path(path);
+    auto other_file = Gio::File::create_for_path(other);
+
+    ASSERT_TRUE(cache.open(file));
+    ASSERT_TRUE(cache.open(other_file));
+    EXPECT_EQ(cache.size(), 1u);
+
+    bool hit = true;
+    ASSERT_TRUE(cache.open(file, nullptr, &hit));
+    EXPECT_FALSE(hit);
+
+    EXPECT_FALSE(cache.open(Gio::File::create_for_path(path + ".missing")));
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
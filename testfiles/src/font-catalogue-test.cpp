@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the catalogue of font family styles
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <gtest/gtest.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <src/libnrtype/font-catalogue.h>
+
+class FontCatalogueTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    void write(std::string const &stamp)
+    {
+        auto catalogue = FontCatalogue(path, stamp);
+        catalogue.set_styles("DejaVu Sans", {{"Normal", "Book"}, {"Bold", "Bold"}});
+        catalogue.set_styles("Empty", {});
+        catalogue.save();
+    }
+
+    std::string path = Glib::build_filename(Glib::get_tmp_dir(), "font-catalogue-test.cache");
+};
+
+TEST_F(FontCatalogueTest, stylesAreKept)
+{
+    write("fonts 1");
+
+    auto catalogue = FontCatalogue(path, "fonts 1");
+    auto styles = catalogue.get_styles("DejaVu Sans");
+    ASSERT_TRUE(styles);
+    ASSERT_EQ(styles->size(), 2u);
+    EXPECT_EQ((*styles)[0].CssName, "Normal");
+    EXPECT_EQ((*styles)[0].DisplayName, "Book");
+    EXPECT_EQ((*styles)[1].CssName, "Bold");
+
+    ASSERT_TRUE(catalogue.get_styles("Empty"));
+    EXPECT_TRUE(catalogue.get_styles("Empty")->empty());
+    EXPECT_FALSE(catalogue.get_styles("Missing"));
+}
+
+TEST_F(FontCatalogueTest, otherFontsDropCatalogue)
+{
+    write("fonts 1");
+
+    auto catalogue = FontCatalogue(path, "fonts 2");
+    EXPECT_FALSE(catalogue.get_styles("DejaVu Sans"));
+}
+
+TEST_F(FontCatalogueTest, damagedCatalogueIsIgnored)
+{
+    write("fonts 1");
+    auto data = Glib::file_get_contents(path);
+    Glib::file_set_contents(path, data.substr(0, data.size() - 3));
+
+    auto catalogue = FontCatalogue(path, "fonts 1");
+    EXPECT_FALSE(catalogue.get_styles("DejaVu Sans"));
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
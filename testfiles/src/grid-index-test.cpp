@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the grid index of canvas item groups
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <limits>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <src/display/control/grid-index.h>
+
+using namespace Inkscape;
+
+namespace {
+
+struct Item {};
+
+std::vector<Item *> items_of(std::vector<GridIndex<Item>::Entry> const &entries)
+{
+    std::vector<Item *> result;
+    for (auto const &entry : entries) {
+        result.push_back(entry.item);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(GridIndexTest, insertMoveEraseQuery)
+{
+    Item a, b;
+    GridIndex<Item> index;
+    index.place(&a, 0, Geom::Rect(0, 0, 10, 10));
+    index.place(&b, 1, Geom::Rect(1000, 1000, 1010, 1010));
+
+    EXPECT_EQ(items_of(index.query(Geom::Rect(5, 5, 6, 6))), std::vector<Item *>{&a});
+    EXPECT_EQ(items_of(index.query(Geom::Rect(0, 0, 2000, 2000))), (std::vector<Item *>{&a, &b}));
+
+    auto const before = index.move(&a, Geom::Rect(2000, 2000, 2010, 2010));
+    EXPECT_EQ(before, Geom::OptRect(Geom::Rect(0, 0, 10, 10)));
+    EXPECT_TRUE(index.query(Geom::Rect(5, 5, 6, 6)).empty());
+    EXPECT_EQ(items_of(index.query(Geom::Rect(2005, 2005, 2006, 2006))), std::vector<Item *>{&a});
+
+    // Moving to empty bounds takes it out of the grid, but keeps it in the index.
+    index.move(&a, {});
+    EXPECT_TRUE(index.query(Geom::Rect(2005, 2005, 2006, 2006)).empty());
+    EXPECT_TRUE(index.contains(&a));
+
+    index.erase(&b);
+    EXPECT_FALSE(index.contains(&b));
+    EXPECT_TRUE(index.query(Geom::Rect(0, 0, 2000, 2000)).empty());
+}
+
+TEST(GridIndexTest, addKeepsOrderBetweenNeighbours)
+{
+    Item a, b, c, d;
+    auto const everywhere = Geom::Rect(0, 0, 10, 10);
+    GridIndex<Item> index;
+    index.place(&a, 0, everywhere);
+    index.place(&b, 1, everywhere);
+
+    EXPECT_TRUE(index.add(&c, everywhere, &a, &b));  // a c b
+    EXPECT_TRUE(index.add(&d, everywhere, nullptr, &a)); // d a c b
+    EXPECT_EQ(items_of(index.query(everywhere)), (std::vector<Item *>{&d, &a, &c, &b}));
+
+    // Keep adding in the same gap until it runs out of room.
+    std::vector<Item> more(100);
+    auto prev = &a;
+    int added = 0;
+    for (auto &item : more) {
+        if (!index.add(&item, everywhere, prev, &c)) {
+            break;
+        }
+        added++;
+        prev = &item;
+    }
+    EXPECT_LT(added, 100);
+    auto const order = items_of(index.query(everywhere));
+    ASSERT_EQ(order.size(), 4u + added);
+    EXPECT_EQ(order[1], &a);
+    EXPECT_EQ(order[2 + added], &c);
+    for (int i = 0; i < added; i++) {
+        EXPECT_EQ(order[2 + i], &more[i]);
+    }
+}
+
+TEST(GridIndexTest, infiniteAndHugeBounds)
+{
+    auto const inf = std::numeric_limits<double>::infinity();
+    Item guide, grid, huge, small;
+    GridIndex<Item> index;
+    index.place(&guide, 0, Geom::Rect(-inf, 5, inf, 5));
+    index.place(&grid, 1, Geom::Rect(-inf, -inf, inf, inf));
+    index.place(&huge, 2, Geom::Rect(-1e12, -1e12, 1e12, 1e12)); // More cells than an int counts.
+    index.place(&small, 3, Geom::Rect(0, 0, 1, 1));
+
+    EXPECT_EQ(items_of(index.query(Geom::Rect(0, 0, 2, 2))), (std::vector<Item *>{&guide, &grid, &huge, &small}));
+    EXPECT_EQ(items_of(index.query(Geom::Rect(5000, 5000, 5001, 5001))), (std::vector<Item *>{&guide, &grid, &huge}));
+
+    // Queries of any size work too.
+    EXPECT_EQ(index.query(Geom::Rect(-inf, -inf, inf, inf)).size(), 4u);
+    EXPECT_EQ(index.query(Geom::Rect(-1e12, -1e12, 1e12, 1e12)).size(), 4u);
+
+    index.erase(&guide);
+    index.move(&grid, Geom::Rect(100, 100, 110, 110));
+    EXPECT_EQ(items_of(index.query(Geom::Rect(0, 0, 2, 2))), (std::vector<Item *>{&huge, &small}));
+    EXPECT_EQ(items_of(index.query(Geom::Rect(105, 105, 106, 106))), (std::vector<Item *>{&grid, &huge}));
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -83,4 +83,57 @@ TEST_F(PathBoolopTest, DifferenceOutside){
     comparePaths(pvRectangleDifference, pvBothPaths);
 }
 
+/// Count the unit cells of [0, width] x [0, height] whose centres \a pathv fills under \a rule.
+static int filled_cells(Geom::PathVector const &pathv, int width, int height, FillRule rule)
+{
+    int count = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int const winding = pathv.winding(Geom::Point(x + 0.5, y + 0.5));
+            if (rule == fill_oddEven ? winding % 2 != 0 : winding != 0) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+TEST_F(PathBoolopTest, EraseNearMissesPath){
+    // an eraser stroke that does not come near the path leaves it alone
+    auto const pathv = sp_svg_read_pathv("M 0,0 H 10 V 10 H 0 Z");
+    auto const eraser = sp_svg_read_pathv("M 20,0 H 30 V 10 H 20 Z");
+    EXPECT_FALSE(sp_pathvector_erase_near(pathv, eraser, fill_nonZero));
+}
+
+TEST_F(PathBoolopTest, EraseNearKeepsFarSubpaths){
+    // only the subpath under the eraser is cut; the one far away is kept exactly as it was
+    auto const pathv = sp_svg_read_pathv("M 0,0 H 10 V 10 H 0 Z M 100,0 H 110 V 10 H 100 Z");
+    auto const eraser = sp_svg_read_pathv("M 4,-5 H 6 V 15 H 4 Z");
+    auto const result = sp_pathvector_erase_near(pathv, eraser, fill_nonZero);
+    ASSERT_TRUE(result);
+    ASSERT_FALSE(result->empty());
+    EXPECT_EQ(result->back(), pathv[1]);
+    EXPECT_EQ(filled_cells(*result, 120, 10, fill_nonZero), 80 + 100);
+}
+
+TEST_F(PathBoolopTest, EraseNearNonZero){
+    // under the nonzero rule the inner square is filled, and stays so after erasing the edge
+    auto const pathv = sp_svg_read_pathv("M 0,0 H 20 V 20 H 0 Z M 5,5 H 15 V 15 H 5 Z");
+    auto const eraser = sp_svg_read_pathv("M 18,-5 H 22 V 25 H 18 Z");
+    auto const result = sp_pathvector_erase_near(pathv, eraser, fill_nonZero);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(filled_cells(*result, 20, 20, fill_nonZero), 400 - 40);
+    EXPECT_NE(result->winding(Geom::Point(10, 10)), 0);
+}
+
+TEST_F(PathBoolopTest, EraseNearEvenOdd){
+    // under the even-odd rule the inner square is a hole, and stays so after erasing the edge
+    auto const pathv = sp_svg_read_pathv("M 0,0 H 20 V 20 H 0 Z M 5,5 H 15 V 15 H 5 Z");
+    auto const eraser = sp_svg_read_pathv("M 18,-5 H 22 V 25 H 18 Z");
+    auto const result = sp_pathvector_erase_near(pathv, eraser, fill_oddEven);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(filled_cells(*result, 20, 20, fill_oddEven), 400 - 100 - 40);
+    EXPECT_EQ(result->winding(Geom::Point(10, 10)) % 2, 0);
+}
+
 //
\ No newline at end of file
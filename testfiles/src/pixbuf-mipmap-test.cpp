@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the mipmap pyramid of bitmap images
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <cstdint>
+#include <memory>
+#include <gtest/gtest.h>
+
+#include <src/display/cairo-utils.h>
+#include <src/display/pixbuf-mipmap.h>
+
+using namespace Inkscape;
+
+namespace {
+
+/// A pixbuf whose pixel at (x, y) has the value f(x, y).
+template <typename F>
+std::shared_ptr<Pixbuf const> make_pixbuf(int width, int height, F &&f)
+{
+    auto s = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    auto data = cairo_image_surface_get_data(s);
+    int stride = cairo_image_surface_get_stride(s);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            reinterpret_cast<uint32_t *>(data + y * stride)[x] = f(x, y);
+        }
+    }
+    cairo_surface_mark_dirty(s);
+    return std::make_shared<Pixbuf>(s);
+}
+
+uint32_t pixel(Cairo::RefPtr<Cairo::ImageSurface> const &s, int x, int y)
+{
+    return reinterpret_cast<uint32_t const *>(s->get_data() + y * s->get_stride())[x];
+}
+
+} // namespace
+
+TEST(PixbufMipmapTest, levels)
+{
+    auto cache = std::make_shared<MipmapTileCache>();
+    auto mipmap = PixbufMipmap(make_pixbuf(1000, 40, [] (int, int) { return 0xff000000; }), cache);
+
+    // 1000 / 2^6 is the last width of at least 16 pixels.
+    EXPECT_EQ(mipmap.levels(), 7);
+    EXPECT_EQ(mipmap.levelRect(3), Geom::IntRect(0, 0, 125, 5));
+    EXPECT_EQ(mipmap.levelFor(1.0), 0);
+    EXPECT_EQ(mipmap.levelFor(0.6), 0);
+    EXPECT_EQ(mipmap.levelFor(0.5), 0);
+    EXPECT_EQ(mipmap.levelFor(0.3), 1);
+    EXPECT_EQ(mipmap.levelFor(0.25), 2);
+    EXPECT_EQ(mipmap.levelFor(0.001), 6);
+}
+
+TEST(PixbufMipmapTest, regionAveragesAcrossTiles)
+{
+    auto cache = std::make_shared<MipmapTileCache>();
+    cache->setBudget(1 << 20);
+
+    // Columns alternate between two grey levels, so each 2x2 block averages to the same value,
+    // except for the clamped last column of an odd width.
+    auto f = [] (int x, int) -> uint32_t { return x % 2 ? 0xff404040 : 0xff808080; };
+    auto mipmap = PixbufMipmap(make_pixbuf(1201, 700, f), cache);
+
+    auto const rect = mipmap.levelRect(2);
+    EXPECT_EQ(rect, Geom::IntRect(0, 0, 301, 175));
+
+    auto area = Geom::IntRect(250, 100, 301, 175); // crosses a tile boundary at x = 256
+    auto surface = mipmap.region(2, area);
+    ASSERT_EQ(surface->get_width(), area.width());
+    ASSERT_EQ(surface->get_height(), area.height());
+    for (int y = 0; y < area.height(); y++) {
+        for (int x = 0; x < area.width() - 1; x++) {
+            ASSERT_EQ(pixel(surface, x, y), 0xff606060) << x << ", " << y;
+        }
+        EXPECT_EQ(pixel(surface, area.width() - 1, y), 0xff808080);
+    }
+}
+
+TEST(PixbufMipmapTest, worksWithoutBudget)
+{
+    // Tiles that do not fit the cache are still returned.
+    auto cache = std::make_shared<MipmapTileCache>();
+    auto mipmap = PixbufMipmap(make_pixbuf(64, 64, [] (int, int) { return 0x80800000; }), cache);
+
+    auto surface = mipmap.region(1, mipmap.levelRect(1));
+    EXPECT_EQ(pixel(surface, 5, 7), 0x80800000);
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the shared queue and cache of resource previews
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <cstring>
+#include <memory>
+#include <gtest/gtest.h>
+
+#include <src/document.h>
+#include <src/inkscape.h>
+#include <src/object/sp-object.h>
+#include <src/util/preview-service.h>
+#include <src/xml/node.h>
+
+using namespace Inkscape;
+
+class PreviewServiceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // setup hidden dependency
+        Application::create(false);
+    }
+
+    /// A job that counts how often it runs and renders a \a size x \a size image.
+    std::function<PreviewService::Surface ()> render(int size = 10)
+    {
+        return [=] {
+            renders++;
+            return Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, size, size);
+        };
+    }
+
+    int renders = 0;
+};
+
+TEST_F(PreviewServiceTest, sameKeyIsRenderedOnce)
+{
+    auto service = PreviewService(1 << 20);
+    int done = 0;
+    auto count = [&](PreviewService::Surface const &surface) { done += !!surface; };
+
+    service.request("a", render(), count);
+    service.request("a", render(), count);
+    EXPECT_EQ(renders, 0);
+
+    service.flush();
+    EXPECT_EQ(renders, 1);
+    EXPECT_EQ(done, 2);
+
+    // Now from the cache, right away.
+    auto connection = service.request("a", render(), count);
+    EXPECT_FALSE(connection.connected());
+    EXPECT_EQ(renders, 1);
+    EXPECT_EQ(done, 3);
+}
+
+TEST_F(PreviewServiceTest, cancelledRequestIsSkipped)
+{
+    auto service = PreviewService(1 << 20);
+    bool called = false;
+
+    auto connection = service.request("a", render(), [&](PreviewService::Surface const &) { called = true; });
+    service.request("b", render(), [](PreviewService::Surface const &) {});
+    connection.disconnect();
+    service.flush();
+
+    EXPECT_FALSE(called);
+    EXPECT_EQ(renders, 1);
+    EXPECT_FALSE(service.lookup("a"));
+    EXPECT_TRUE(service.lookup("b"));
+}
+
+TEST_F(PreviewServiceTest, cancelledRequestDoesNotRender)
+{
+    auto service = PreviewService(1 << 20);
+    bool cancelled_rendered = false;
+    int done = 0;
+
+    // The render function of the first request owns something that goes away with its requester.
+    auto owned = std::make_shared<int>(0);
+    auto watch = std::weak_ptr<int>(owned);
+    auto cancelled = service.request("a", [&cancelled_rendered, owned = std::move(owned)] {
+        cancelled_rendered = true;
+        return Cairo::ImageSurface::create(Cairo::FORMAT_ARGB32, 10, 10);
+    }, [](PreviewService::Surface const &) {});
+    service.request("a", render(), [&](PreviewService::Surface const &surface) { done += !!surface; });
+    cancelled.disconnect();
+    service.flush();
+
+    EXPECT_FALSE(cancelled_rendered);
+    EXPECT_EQ(renders, 1);
+    EXPECT_EQ(done, 1);
+    EXPECT_TRUE(watch.expired());
+}
+
+TEST_F(PreviewServiceTest, leastRecentlyUsedAreDropped)
+{
+    // 10 x 10 ARGB is 400 bytes; room for two.
+    auto service = PreviewService(1000);
+    auto ignore = [](PreviewService::Surface const &) {};
+
+    service.request("a", render(), ignore);
+    service.request("b", render(), ignore);
+    service.flush();
+    EXPECT_TRUE(service.lookup("a")); // Now more recent than "b".
+
+    service.request("c", render(), ignore);
+    service.flush();
+    EXPECT_TRUE(service.lookup("a"));
+    EXPECT_FALSE(service.lookup("b"));
+    EXPECT_TRUE(service.lookup("c"));
+    EXPECT_LE(service.cached_bytes(), 1000u);
+
+    service.set_budget(0);
+    EXPECT_EQ(service.cached_bytes(), 400u); // The newest one stays.
+}
+
+TEST_F(PreviewServiceTest, contentKeyFollowsReferences)
+{
+    auto const svg = R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink">
+  <defs>
+    <linearGradient id="stops"><stop id="stop" offset="0" style="stop-color:#ff0000"/></linearGradient>
+    <linearGradient id="a" xlink:href="#stops" x2="1"/>
+    <linearGradient id="b" xlink:href="#stops" x2="1"/>
+  </defs>
+</svg>)";
+    auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDocFromMem(svg, std::strlen(svg), false));
+    ASSERT_TRUE(doc);
+    auto a = doc->getObjectById("a");
+    auto b = doc->getObjectById("b");
+    ASSERT_TRUE(a && b);
+
+    auto const context = PreviewService::context_key(*doc);
+    auto const before = PreviewService::content_key(*a, context);
+    EXPECT_EQ(PreviewService::content_key(*a, context), before);
+    EXPECT_NE(PreviewService::content_key(*b, context), before); // The id differs.
+
+    doc->getObjectById("stop")->setAttribute("style", "stop-color:#0000ff");
+    EXPECT_NE(PreviewService::content_key(*a, context), before);
+}
+
+TEST_F(PreviewServiceTest, contentKeyTakesInContext)
+{
+    auto const svg = R"(<svg xmlns="http://www.w3.org/2000/svg">
+  <style id="sheet">.red { fill: red; }</style>
+  <g id="group" style="fill:green">
+    <rect id="rect" class="red" width="10" height="10"/>
+  </g>
+</svg>)";
+    auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDocFromMem(svg, std::strlen(svg), false));
+    ASSERT_TRUE(doc);
+    auto rect = doc->getObjectById("rect");
+    ASSERT_TRUE(rect);
+
+    auto context = PreviewService::context_key(*doc);
+    auto key = PreviewService::content_key(*rect, context);
+
+    // Style inherited from an ancestor.
+    doc->getObjectById("group")->setAttribute("style", "fill:blue");
+    auto const inherited = PreviewService::content_key(*rect, context);
+    EXPECT_NE(inherited, key);
+    key = inherited;
+    doc->getObjectById("group")->setAttribute("inkscape:label", "Group");
+    EXPECT_EQ(PreviewService::content_key(*rect, context), key); // Not style.
+
+    // Style sheets.
+    doc->getObjectById("sheet")->getRepr()->firstChild()->setContent(".red { fill: orange; }");
+    EXPECT_NE(PreviewService::context_key(*doc), context);
+    context = PreviewService::context_key(*doc);
+    EXPECT_NE(PreviewService::content_key(*rect, context), key);
+
+    // Where relative links point to.
+    doc->setDocumentBase("/somewhere/else");
+    EXPECT_NE(PreviewService::context_key(*doc), context);
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
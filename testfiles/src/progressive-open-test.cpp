@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for opening documents in stages
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <fstream>
+#include <memory>
+#include <gtest/gtest.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <src/async/progress.h>
+#include <src/document.h>
+#include <src/inkscape.h>
+#include <src/io/progressive-open.h>
+#include <src/preferences.h>
+#include <src/xml/repr.h>
+
+using namespace Inkscape;
+
+class ProgressiveOpenTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // setup hidden dependency
+        Application::create(false);
+        Preferences::get()->setInt("/options/progressiveopen/batchsize", 3);
+
+        std::ofstream out(path);
+        out << R"(<svg xmlns="http://www.w3.org/2000/svg" width="100" height="100">
+  <defs id="defs"><linearGradient id="grad"/></defs>
+  <g id="layer1">
+    <rect id="rect1" width="10" height="10"/>
+    <g id="group1">
+      <rect id="rect2" width="10" height="10"/>
+      <rect id="rect3" width="10" height="10"/>
+      <use id="use1" href="#rect5"/>
+    </g>
+    <rect id="rect4" width="10" height="10"/>
+  </g>
+  <!-- comment -->
+  <g id="layer2">
+    <rect id="rect5" width="10" height="10" fill="url(#grad)"/>
+  </g>
+  <circle id="circle1" r="5"/>
+</svg>)";
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path = Glib::build_filename(Glib::get_tmp_dir(), "progressive-open-test.svg");
+};
+
+TEST_F(ProgressiveOpenTest, stepsRestoreDocument)
+{
+    auto expected = std::unique_ptr<SPDocument>(SPDocument::createNewDoc(path.c_str(), false));
+    ASSERT_TRUE(expected);
+
+    auto open = IO::ProgressiveOpen::create(path);
+    ASSERT_TRUE(open);
+    auto doc = std::unique_ptr<SPDocument>(open->document());
+
+    EXPECT_TRUE(doc->isLoading());
+    EXPECT_TRUE(doc->getObjectById("defs"));
+    EXPECT_FALSE(doc->getObjectById("rect5"));
+
+    auto progress = Async::ProgressAlways<double>();
+    int steps = 0;
+    while (open->step(progress)) {
+        steps++;
+    }
+    EXPECT_GT(steps, 1);
+
+    EXPECT_FALSE(doc->isLoading());
+    EXPECT_FALSE(open->pending());
+    EXPECT_TRUE(doc->getObjectById("use1"));
+    EXPECT_TRUE(doc->getObjectById("rect5"));
+    EXPECT_EQ(sp_repr_save_buf(doc->getReprDoc()), sp_repr_save_buf(expected->getReprDoc()));
+
+    open.reset();
+}
+
+TEST_F(ProgressiveOpenTest, finishLoadingAddsEverything)
+{
+    auto expected = std::unique_ptr<SPDocument>(SPDocument::createNewDoc(path.c_str(), false));
+    ASSERT_TRUE(expected);
+
+    auto open = IO::ProgressiveOpen::create(path);
+    ASSERT_TRUE(open);
+    auto doc = std::unique_ptr<SPDocument>(open->document());
+
+    doc->finishLoading();
+
+    EXPECT_FALSE(doc->isLoading());
+    EXPECT_FALSE(open->pending());
+    EXPECT_EQ(sp_repr_save_buf(doc->getReprDoc()), sp_repr_save_buf(expected->getReprDoc()));
+
+    open.reset();
+}
+
+TEST_F(ProgressiveOpenTest, editsWhileLoadingAreKept)
+{
+    auto open = IO::ProgressiveOpen::create(path);
+    ASSERT_TRUE(open);
+    auto doc = std::unique_ptr<SPDocument>(open->document());
+
+    // The first batch adds layer1, rect1 and group1.
+    auto progress = Async::ProgressAlways<double>();
+    ASSERT_TRUE(open->step(progress));
+    auto group = doc->getObjectById("group1");
+    ASSERT_TRUE(group);
+
+    // The children of group1 and the sibling after it are still waiting.
+    auto repr = group->getRepr();
+    repr->parent()->removeChild(repr);
+
+    while (open->step(progress)) {
+    }
+
+    EXPECT_FALSE(doc->getObjectById("group1"));
+    EXPECT_FALSE(doc->getObjectById("rect2"));
+    auto layer = doc->getObjectById("layer1")->getRepr();
+    ASSERT_EQ(layer->childCount(), 2u);
+    EXPECT_STREQ(layer->firstChild()->attribute("id"), "rect1");
+    EXPECT_STREQ(layer->lastChild()->attribute("id"), "rect4");
+
+    open.reset();
+}
+
+TEST_F(ProgressiveOpenTest, cancelledStepKeepsRemainingContent)
+{
+    class ProgressCancelled final : public Async::Progress<double>
+    {
+        bool _keepgoing() const override { return false; }
+        bool _report(double const &) override { return false; }
+    };
+
+    auto open = IO::ProgressiveOpen::create(path);
+    ASSERT_TRUE(open);
+    auto doc = std::unique_ptr<SPDocument>(open->document());
+
+    auto cancelled = ProgressCancelled();
+    EXPECT_THROW(open->step(cancelled), Async::CancelledException);
+    EXPECT_TRUE(open->pending());
+    EXPECT_TRUE(doc->isLoading());
+
+    // Dropping the remaining content must leave a consistent document.
+    open.reset();
+    EXPECT_FALSE(doc->isLoading());
+    EXPECT_FALSE(doc->getObjectById("rect5"));
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the cache of parsed extension descriptions
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include <src/extension/extension.h>
+#include <src/extension/registry-cache.h>
+#include <src/xml/document.h>
+#include <src/xml/repr.h>
+
+using namespace Inkscape;
+
+class RegistryCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        write("org.inkscape.test.cache", "16");
+    }
+
+    void TearDown() override
+    {
+        std::remove(inx.c_str());
+        std::remove(cache.c_str());
+    }
+
+    void write(std::string const &id, std::string const &size)
+    {
+        std::ofstream out(inx);
+        out << R"(<?xml version="1.0" encoding="UTF-8"?>
+<!-- a comment -->
+<inkscape-extension xmlns="http://www.inkscape.org/namespace/inkscape/extension">
+  <name>Cache test</name>
+  <id>)" << id << R"(</id>
+  <param name="size" type="int" min="1" max="100" gui-text="Size:">)" << size << R"(</param>
+  <param name="text" type="string" gui-text="Text:"><![CDATA[a < b]]></param>
+  <effect><object-type>all</object-type></effect>
+  <script><command location="inx" interpreter="python">cache_test.py</command></script>
+</inkscape-extension>)";
+    }
+
+    static std::string save(XML::Document *doc)
+    {
+        auto result = sp_repr_save_buf(doc);
+        GC::release(doc);
+        return result;
+    }
+
+    std::string inx = Glib::build_filename(Glib::get_tmp_dir(), "registry-cache-test.inx");
+    std::string cache = Glib::build_filename(Glib::get_tmp_dir(), "registry-cache-test.cache");
+};
+
+TEST_F(RegistryCacheTest, cachedDocumentMatchesParsed)
+{
+    auto const expected = save(sp_repr_read_file(inx.c_str(), INKSCAPE_EXTENSION_URI));
+
+    {
+        auto registry = Extension::RegistryCache(cache);
+        EXPECT_EQ(save(registry.read(inx)), expected);
+        registry.save();
+    }
+    ASSERT_TRUE(Glib::file_test(cache, Glib::FILE_TEST_EXISTS));
+
+    // Now from the cache file.
+    auto registry = Extension::RegistryCache(cache);
+    EXPECT_EQ(save(registry.read(inx)), expected);
+}
+
+TEST_F(RegistryCacheTest, changedFileIsReparsed)
+{
+    {
+        auto registry = Extension::RegistryCache(cache);
+        ASSERT_TRUE(registry.read(inx));
+        registry.save();
+    }
+
+    write("org.inkscape.test.changed", "32");
+    auto const expected = save(sp_repr_read_file(inx.c_str(), INKSCAPE_EXTENSION_URI));
+
+    auto registry = Extension::RegistryCache(cache);
+    auto const actual = save(registry.read(inx));
+    EXPECT_EQ(actual, expected);
+    EXPECT_NE(actual.find("org.inkscape.test.changed"), std::string::npos);
+}
+
+TEST_F(RegistryCacheTest, damagedCacheIsIgnored)
+{
+    Glib::file_set_contents(cache, "inkscape-extension-registry, but not really");
+
+    auto registry = Extension::RegistryCache(cache);
+    auto const expected = save(sp_repr_read_file(inx.c_str(), INKSCAPE_EXTENSION_URI));
+    EXPECT_EQ(save(registry.read(inx)), expected);
+    EXPECT_FALSE(registry.read(inx + ".missing"));
+}
+
+TEST_F(RegistryCacheTest, visibleWidgetsAreCountedBeforeBuilding)
+{
+    auto const inx = R"(<inkscape-extension xmlns="http://www.inkscape.org/namespace/inkscape/extension">
+  <name>Count test</name>
+  <id>org.inkscape.test.count</id>
+  <param name="size" type="int" gui-text="Size:">1</param>
+  <label>Some text</label>
+  <param name="hidden" type="int" gui-hidden="true">1</param>
+  <param name="unknown" type="no-such-type" gui-text="Unknown:">1</param>
+  <param name=" " type="int" gui-text="Nameless:">1</param>
+  <param name="textless" type="int">1</param>
+</inkscape-extension>)";
+    auto doc = sp_repr_read_mem(inx, std::strlen(inx), INKSCAPE_EXTENSION_URI);
+    ASSERT_TRUE(doc);
+
+    auto extension = Extension::Extension(doc->root(), nullptr, nullptr);
+    EXPECT_EQ(extension.widget_visible_count(), 2u);
+
+    // The same once the widgets are built.
+    EXPECT_EQ(extension.get_param_int("size"), 1);
+    EXPECT_EQ(extension.widget_visible_count(), 2u);
+    GC::release(doc);
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -9,11 +9,13 @@
  * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
  */
 
+#include <memory>
 #include <gtest/gtest.h>
 #include <src/document.h>
 #include <src/inkscape.h>
 #include <src/live_effects/effect.h>
 #include <src/object/sp-lpe-item.h>
+#include <src/object/sp-rect.h>
 
 using namespace Inkscape;
 using namespace Inkscape::LivePathEffect;
@@ -44,3 +46,34 @@ TEST_F(SPGroupTest, applyingPowerClipEffectToGroupWithoutClipIsIgnored)
 
     ASSERT_FALSE(group->hasPathEffect());
 }
+
+TEST_F(SPGroupTest, onlyChangedChildrenAreUpdated)
+{
+    std::string svg("\
+<svg width='100' height='100'>\
+    <g id='group1'>\
+        <rect id='rect1' width='100' height='50' />\
+        <rect id='rect2' y='50' width='100' height='50' />\
+        <rect id='rect3' y='50' width='10' height='50' />\
+    </g>\
+</svg>");
+
+    auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDocFromMem(svg.c_str(), svg.size(), true));
+    doc->ensureUpToDate();
+
+    auto group = cast<SPGroup>(doc->getObjectById("group1"));
+    auto rect2 = cast<SPRect>(doc->getObjectById("rect2"));
+    EXPECT_TRUE(group->updateDirtyChildList().empty());
+
+    rect2->setAttribute("width", "20");
+
+    auto dirty = group->updateDirtyChildList();
+    ASSERT_EQ(dirty.size(), 1);
+    EXPECT_EQ(dirty[0], rect2);
+    sp_object_unref(dirty[0]);
+
+    doc->ensureUpToDate();
+    EXPECT_TRUE(group->updateDirtyChildList().empty());
+    EXPECT_TRUE(group->modifiedDirtyChildList().empty());
+    EXPECT_EQ(rect2->width.computed, 20);
+}
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/** @file
+ * Tests for the item index and colour picker kept during a spray stroke
+ *//*
+ * Authors: see git history
+ *
+ * Copyright (C) 2024 Authors
+ *
+ * Released under GNU GPL version 2 or later, read the file 'COPYING' for more information
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <src/color.h>
+#include <src/display/drawing-context.h>
+#include <src/document.h>
+#include <src/inkscape.h>
+#include <src/object/sp-item.h>
+#include <src/ui/tools/spray-stroke.h>
+#include <src/xml/node.h>
+#include <src/xml/repr.h>
+
+using namespace Inkscape;
+using namespace Inkscape::UI::Tools;
+
+class SprayStrokeTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // setup hidden dependency
+        Application::create(false);
+    }
+};
+
+namespace {
+
+std::vector<SPItem *> sorted(std::vector<SPItem *> items)
+{
+    std::sort(items.begin(), items.end());
+    return items;
+}
+
+/// A drawing of one coloured rectangle on transparent, counting the areas rendered.
+struct Scene
+{
+    Geom::IntRect rect;
+    guint32 rgba;
+    std::vector<Geom::IntRect> rendered;
+
+    SprayPickerTile::Render render()
+    {
+        return [this] (DrawingContext &dc, Geom::IntRect const &area) {
+            rendered.push_back(area);
+            dc.rectangle(rect);
+            dc.setSource(rgba);
+            dc.fill();
+        };
+    }
+};
+
+} // namespace
+
+TEST_F(SprayStrokeTest, indexFindsWhatTheDocumentFinds)
+{
+    auto const svg = R"(<svg xmlns="http://www.w3.org/2000/svg" width="1000" height="1000">
+  <rect id="a" x="0" y="0" width="10" height="10"/>
+  <rect id="b" x="100" y="100" width="10" height="10"/>
+  <rect id="wide" x="0" y="500" width="1000" height="10"/>
+  <rect id="huge" x="-1e11" y="-1e11" width="2e11" height="2e11" fill="none" stroke="black"/>
+</svg>)";
+    auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDocFromMem(svg, std::strlen(svg), false));
+    ASSERT_TRUE(doc);
+    doc->ensureUpToDate();
+
+    SprayItemIndex index;
+    for (auto const &box : { Geom::Rect(0, 0, 20, 20), Geom::Rect(95, 95, 105, 105), Geom::Rect(400, 495, 420, 505),
+                             Geom::Rect(200, 200, 220, 220), Geom::Rect(-1000, -1000, 2000, 2000),
+                             Geom::Rect(-Geom::infinity(), -Geom::infinity(), Geom::infinity(), Geom::infinity()) }) {
+        EXPECT_EQ(sorted(index.itemsPartiallyInBox(doc.get(), 0, box)), sorted(doc->getItemsPartiallyInBox(0, box)));
+    }
+
+    // A copy placed during the stroke is found once the document is up to date.
+    auto copy = doc->getReprDoc()->createElement("svg:rect");
+    copy->setAttribute("id", "copy");
+    copy->setAttribute("x", "200");
+    copy->setAttribute("y", "200");
+    copy->setAttribute("width", "10");
+    copy->setAttribute("height", "10");
+    doc->getReprRoot()->appendChild(copy);
+    GC::release(copy);
+    doc->ensureUpToDate();
+    auto copied = cast<SPItem>(doc->getObjectById("copy"));
+    ASSERT_TRUE(copied);
+    index.add(copied);
+    auto const huge = cast<SPItem>(doc->getObjectById("huge"));
+    EXPECT_EQ(sorted(index.itemsPartiallyInBox(doc.get(), 0, Geom::Rect(200, 200, 220, 220))),
+              sorted({ copied, huge }));
+
+    index.remove(copied);
+    EXPECT_EQ(index.itemsPartiallyInBox(doc.get(), 0, Geom::Rect(200, 200, 220, 220)), std::vector<SPItem *>{huge});
+}
+
+TEST_F(SprayStrokeTest, pickerRendersOnlyWhatChanged)
+{
+    Scene scene{ Geom::IntRect(0, 0, 10, 10), 0xff0000ff };
+    SprayPickerTile picker;
+    auto const view = Geom::Affine();
+    auto const inside = Geom::IntRect(2, 2, 4, 4);
+    auto const outside = Geom::IntRect(20, 20, 22, 22);
+
+    EXPECT_EQ(picker.pick(inside, view, scene.render(), true), 0xff0000ffu);
+    ASSERT_EQ(scene.rendered.size(), 1u);
+    EXPECT_TRUE(scene.rendered[0].contains(outside)); // The tile has a margin.
+
+    // Picking again from the tile does not render.
+    EXPECT_EQ(SP_RGBA32_A_U(picker.pick(outside, view, scene.render(), true)), 0u);
+    EXPECT_EQ(scene.rendered.size(), 1u);
+
+    // A copy placed over the second area: only its rectangle is rendered again.
+    scene.rect = Geom::IntRect(18, 18, 24, 24);
+    scene.rgba = 0x0000ffff;
+    picker.invalidate(scene.rect);
+    EXPECT_EQ(picker.pick(outside, view, scene.render(), true), 0x0000ffffu);
+    ASSERT_EQ(scene.rendered.size(), 2u);
+    EXPECT_EQ(scene.rendered[1], scene.rect);
+
+    // The first area, outside the changed one, was kept rather than cleared.
+    scene.rendered.clear();
+    EXPECT_EQ(picker.pick(inside, view, scene.render(), true), 0xff0000ffu);
+    EXPECT_TRUE(scene.rendered.empty());
+}
+
+TEST_F(SprayStrokeTest, pickerRetriesUntilDrawingIsCurrent)
+{
+    Scene scene{ Geom::IntRect(0, 0, 10, 10), 0xff0000ff };
+    SprayPickerTile picker;
+    auto const view = Geom::Affine();
+    auto const area = Geom::IntRect(2, 2, 4, 4);
+
+    picker.pick(area, view, scene.render(), true);
+    picker.invalidate(Geom::IntRect(0, 0, 10, 10));
+
+    // Until the drawing shows the change, the changed area is rendered on every pick.
+    scene.rendered.clear();
+    picker.pick(area, view, scene.render(), false);
+    picker.pick(area, view, scene.render(), false);
+    EXPECT_EQ(scene.rendered.size(), 2u);
+
+    scene.rgba = 0x00ff00ff;
+    EXPECT_EQ(picker.pick(area, view, scene.render(), true), 0x00ff00ffu);
+    EXPECT_EQ(scene.rendered.size(), 3u);
+    picker.pick(area, view, scene.render(), true);
+    EXPECT_EQ(scene.rendered.size(), 3u);
+
+    // A new view renders the whole tile.
+    picker.pick(area, Geom::Scale(2), scene.render(), true);
+    EXPECT_EQ(scene.rendered.size(), 4u);
+    EXPECT_TRUE(scene.rendered.back().contains(area));
+}
+
+/*
+  Local Variables:
+  mode:c++
+  c-file-style:"stroustrup"
+  c-file-offsets:((innamespace . 0)(inline-open . 0)(case-label . +))
+  indent-tabs-mode:nil
+  fill-column:99
+  End:
+*/
+// vim: filetype=cpp:expandtab:shiftwidth=4:tabstop=8:softtabstop=4:fileencoding=utf-8:textwidth=99 :
@@ -8,10 +8,15 @@
  * Released under GNU GPL v2+, read the file 'COPYING' for more information.
  */
 
+#include <chrono>
 #include <cstdio>
 #include <gtest/gtest.h>
+#include <iostream>
+#include <random>
 #include <string>
+#include <thread>
 
+#include "io/stream/bufferstream.h"
 #include "io/stream/gzipstream.h"
 #include "io/stream/inkscapestream.h"
 #include "io/stream/stringstream.h"
@@ -159,3 +164,178 @@ TEST(StreamTest, GzipFExtraFComment)
     pipeStream(inStreamGzip, outStreamString);
     ASSERT_EQ(outStreamString.getString(), "the content");
 }
+
+// Byte-exact in-memory streams; the string streams above go through Glib::ustring.
+class BytesInputStream : public Inkscape::IO::InputStream
+{
+public:
+    explicit BytesInputStream(std::string data)
+        : _data(std::move(data))
+    {}
+
+    int available() override { return _data.size() - _pos; }
+    void close() override {}
+    int get() override { return _pos < _data.size() ? static_cast<unsigned char>(_data[_pos++]) : -1; }
+
+private:
+    std::string _data;
+    std::size_t _pos = 0;
+};
+
+class BytesOutputStream : public Inkscape::IO::OutputStream
+{
+public:
+    void close() override {}
+    void flush() override {}
+    int put(char ch) override
+    {
+        data.push_back(ch);
+        return 1;
+    }
+
+    std::string data;
+};
+
+/// Some megabytes of SVG-like text.
+static std::string make_svg_data(int paths)
+{
+    std::string data;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 1000);
+    for (int i = 0; i < paths; i++) {
+        data += "<path d=\"M " + std::to_string(dist(gen)) + "," + std::to_string(dist(gen)) + " L " +
+                std::to_string(dist(gen)) + "," + std::to_string(dist(gen)) + "\" style=\"fill:#" +
+                std::to_string(dist(gen)) + "\"/>\n";
+    }
+    return data;
+}
+
+static std::string gzip(std::string const &data, int threads, bool bulk)
+{
+    BytesOutputStream outs;
+    {
+        auto gzipOuts = Inkscape::IO::GzipOutputStream(outs, threads);
+        if (bulk) {
+            gzipOuts.write(data.data(), data.size());
+        } else {
+            for (auto ch : data) {
+                gzipOuts.put(ch);
+            }
+        }
+    }
+    return std::move(outs.data);
+}
+
+static std::string gunzip(std::string const &data, bool bulk)
+{
+    auto ins = BytesInputStream(data);
+    auto gzipIns = Inkscape::IO::GzipInputStream(ins);
+    std::string result;
+    if (bulk) {
+        char buffer[65536];
+        while (auto n = gzipIns.read(buffer, sizeof(buffer))) {
+            result.append(buffer, n);
+        }
+    } else {
+        for (int ch; (ch = gzipIns.get()) >= 0;) {
+            result.push_back(ch);
+        }
+    }
+    return result;
+}
+
+TEST(StreamTest, GzipBlocks)
+{
+    auto const data = make_svg_data(50000);
+
+    auto const single = gzip(data, 1, false);
+    auto const parallel = gzip(data, 4, true);
+    // Blocks are split the same way however many threads compress them.
+    EXPECT_EQ(single, parallel);
+    EXPECT_LT(parallel.size(), data.size() / 3);
+
+    EXPECT_EQ(gunzip(single, false), data);
+    EXPECT_EQ(gunzip(parallel, true), data);
+
+    // Flushing in between still makes a single valid stream.
+    BytesOutputStream outs;
+    {
+        auto gzipOuts = Inkscape::IO::GzipOutputStream(outs, 2);
+        gzipOuts.write(data.data(), 1000);
+        gzipOuts.flush();
+        gzipOuts.write(data.data() + 1000, data.size() - 1000);
+    }
+    EXPECT_EQ(gunzip(outs.data, true), data);
+}
+
+TEST(StreamTest, GzipConcatenated)
+{
+    auto const data = gzip("Hello, ", 1, true) + gzip("world!", 1, true);
+    EXPECT_EQ(gunzip(data, false), "Hello, world!");
+}
+
+TEST(StreamTest, GzipDamaged)
+{
+    auto const data = make_svg_data(1000);
+    auto const compressed = gzip(data, 1, true);
+    EXPECT_LT(gunzip(compressed.substr(0, compressed.size() / 2), true).size(), data.size());
+    EXPECT_EQ(gunzip("not gzip data at all", true), "");
+    EXPECT_EQ(gunzip("", true), "");
+}
+
+TEST(StreamTest, BulkReadWrite)
+{
+    auto const data = make_svg_data(1000);
+
+    // The fallbacks of the base classes and the overrides agree.
+    BytesOutputStream bytes;
+    bytes.write(data.data(), data.size());
+    EXPECT_EQ(bytes.data, data);
+
+    Inkscape::IO::BufferOutputStream bufferOuts;
+    bufferOuts.write(data.data(), 10);
+    bufferOuts.put(data[10]);
+    bufferOuts.write(data.data() + 11, data.size() - 11);
+    auto const &buffer = bufferOuts.getBuffer();
+    ASSERT_EQ(std::string(buffer.begin(), buffer.end()), data);
+
+    auto bufferIns = Inkscape::IO::BufferInputStream(buffer);
+    std::string result(data.size() + 10, '\0');
+    EXPECT_EQ(bufferIns.get(), static_cast<unsigned char>(data[0]));
+    EXPECT_EQ(bufferIns.read(result.data() + 1, result.size() - 1), data.size() - 1);
+    EXPECT_EQ(bufferIns.read(result.data(), 1), 0u);
+    result[0] = data[0];
+    result.resize(data.size());
+    EXPECT_EQ(result, data);
+
+    auto bytesIns = BytesInputStream(data);
+    result.assign(data.size(), '\0');
+    EXPECT_EQ(bytesIns.read(result.data(), result.size()), data.size());
+    EXPECT_EQ(result, data);
+
+    // Writers hand whole strings down.
+    BytesOutputStream outs;
+    auto writer = Inkscape::IO::OutputStreamWriter(outs);
+    writer.writeString("<svg>").writeStdString(data).writeChar('\n');
+    EXPECT_EQ(outs.data, "<svg>" + data + "\n");
+}
+
+TEST(StreamTest, GzipThroughput)
+{
+    auto const data = make_svg_data(200000);
+    auto const threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto measure = [&](char const *name, auto &&f) {
+        auto const start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << data.size() / elapsed.count() / 1e6 << " MB/s" << std::endl;
+    };
+
+    std::string compressed;
+    measure("gzip, put(), 1 thread", [&] { compressed = gzip(data, 1, false); });
+    measure("gzip, write(), 1 thread", [&] { compressed = gzip(data, 1, true); });
+    measure("gzip, write(), all threads", [&] { compressed = gzip(data, threads, true); });
+    measure("gunzip, get()", [&] { EXPECT_EQ(gunzip(compressed, false).size(), data.size()); });
+    measure("gunzip, read()", [&] { EXPECT_EQ(gunzip(compressed, true).size(), data.size()); });
+}
@@ -11,7 +11,10 @@
 #include <2geom/curves.h>
 #include <2geom/pathvector.h>
 #include <glib.h>
+#include <chrono>
 #include <gtest/gtest.h>
+#include <iostream>
+#include <random>
 #include <vector>
 
 #include "preferences.h"
@@ -477,6 +480,40 @@ TEST_F(SvgPathGeomTest, testRoundTrip)
     ASSERT_TRUE(bpathEqual(pv, new_pv, 1e-17)) << org_path_str.c_str();
 }
 
+TEST_F(SvgPathGeomTest, testThroughput)
+{
+    // Large path with a mix of segment types and non-trivial coordinates
+    Geom::PathVector pv;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-5000.0, 5000.0);
+    auto random_point = [&] { return Geom::Point(dist(gen), dist(gen)); };
+    for (int i = 0; i < 1000; ++i) {
+        Geom::Path path(random_point());
+        for (int j = 0; j < 100; ++j) {
+            if (j % 2) {
+                path.appendNew<Geom::LineSegment>(random_point());
+            } else {
+                path.appendNew<Geom::CubicBezier>(random_point(), random_point(), random_point());
+            }
+        }
+        pv.push_back(path);
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    auto const path_str = sp_svg_write_path(pv);
+    auto const written = std::chrono::steady_clock::now();
+    auto const new_pv = sp_svg_read_pathv(path_str.c_str());
+    auto const read = std::chrono::steady_clock::now();
+
+    ASSERT_EQ(new_pv.size(), pv.size());
+    ASSERT_EQ(new_pv.curveCount(), pv.curveCount());
+
+    std::chrono::duration<double> const write_time = written - start;
+    std::chrono::duration<double> const read_time = read - written;
+    std::cout << "Path data: " << path_str.size() / 1e6 << " MB, write " << path_str.size() / write_time.count() / 1e6
+              << " MB/s, read " << path_str.size() / read_time.count() / 1e6 << " MB/s" << std::endl;
+}
+
 TEST(PathVectorToBeziersTest, random)
 {
     // Evil test will crash if not protected
@@ -15,9 +15,14 @@
 #include "2geom/point.h"
 #include "svg/css-ostringstream.h"
 #include "svg/stringstream.h"
+#include "svg/strip-trailing-zeros.h"
 
 #include "gtest/gtest.h"
+#include <chrono>
+#include <cmath>
 #include <glibmm/ustring.h>
+#include <iostream>
+#include <random>
 
 template <typename S, typename T>
 static void assert_tostring_eq(T value, const char *expected)
@@ -125,6 +130,54 @@ TEST(SVGOStringStreamTest, tostring)
     assert_tostring_eq<S, double>(-3.5e9, "-3.5e+09");
 }
 
+TEST(SVGOStringStreamTest, matchesStreamFormatting)
+{
+    // The fast formatter must produce exactly what the stream based one used to
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-12, 6);
+
+    for (int precision = 1; precision <= 16; ++precision) {
+        for (int i = 0; i < 1000; ++i) {
+            double const value = mantissa(gen) * std::pow(10.0, exponent(gen));
+
+            std::ostringstream expected;
+            expected.imbue(std::locale::classic());
+            expected.setf(std::ios::showpoint);
+            expected.precision(precision);
+            expected << value;
+
+            Inkscape::SVGOStringStream os;
+            os.precision(precision);
+            os << value;
+            ASSERT_EQ(os.str(), value == int(value) ? std::to_string(int(value)) : strip_trailing_zeros(expected.str()));
+        }
+    }
+}
+
+TEST(SVGOStringStreamTest, throughput)
+{
+    constexpr int count = 1000000;
+    std::vector<double> values(count);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    for (auto &value : values) {
+        value = dist(gen);
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    Inkscape::SVGOStringStream os;
+    os.precision(8);
+    for (auto value : values) {
+        os << value << ' ';
+    }
+    auto const size = os.str().size();
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "SVGOStringStream: " << count / elapsed.count() / 1e6 << " M numbers/s, "
+              << size / elapsed.count() / 1e6 << " MB/s" << std::endl;
+}
+
 template <typename S>
 void test_concat()
 {
@@ -13,6 +13,7 @@
 #include <gtest/gtest.h>
 
 #include <2geom/rect.h>
+#include <2geom/transforms.h>
 #include <iostream>
 #include <iomanip>
 #include "inkscape.h"
@@ -120,6 +121,36 @@ TEST_F(VisualBoundsTest, ShapeBounds)
     }
 }
 
+TEST(VisualBoundsCacheTest, CachedBoundsFollowChanges)
+{
+    InkscapeInit init;
+    std::string const svg = R"(<svg xmlns="http://www.w3.org/2000/svg" width="100" height="100">
+  <g id="group">
+    <rect id="rect" width="10" height="20" style="stroke:black;stroke-width:2"/>
+  </g>
+</svg>)";
+    auto doc = std::unique_ptr<SPDocument>(SPDocument::createNewDocFromMem(svg.c_str(), svg.size(), false));
+    doc->ensureUpToDate();
+
+    auto group = cast<SPItem>(doc->getObjectById("group"));
+    auto rect = cast<SPItem>(doc->getObjectById("rect"));
+    ASSERT_TRUE(group && rect);
+
+    auto const expected = Geom::Rect(-1, -1, 11, 21);
+    EXPECT_EQ(group->visualBounds(), expected);
+
+    auto const before = SPItem::boundsCacheStats();
+    EXPECT_EQ(group->visualBounds(), expected);
+    EXPECT_EQ(group->visualBounds(Geom::Translate(5, 5)), expected * Geom::Translate(5, 5));
+    EXPECT_EQ(group->geometricBounds(Geom::Scale(2)), Geom::Rect(0, 0, 20, 40));
+    EXPECT_GE(SPItem::boundsCacheStats().hits - before.hits, 2);
+
+    // The cache must not outlive a change below the group.
+    rect->setAttribute("width", "30");
+    doc->ensureUpToDate();
+    EXPECT_EQ(group->visualBounds(), Geom::Rect(-1, -1, 31, 21));
+}
+
 /*
   Local Variables:
   mode:c++